@@ -7,35 +7,45 @@
 #include <map>
 #include <string>
 
+#include "devtool/base_devtool/native/compression_engine.h"
 #include "third_party/jsoncpp/include/json/json.h"
-#include "third_party/modp_b64/modp_b64.h"
-#include "third_party/zlib/zlib.h"
 
 namespace lynx {
 namespace devtool {
 
+namespace {
+
+// capacity the thread's base64 buffer keeps between calls, enough for the
+// usual DOM and CSS payloads; the rare larger ones allocate their own.
+constexpr size_t kMaxRetainedBase64Capacity = 1024 * 1024;
+
+}  // namespace
+
 int CDPDomainAgentBase::CompressData(const std::string& tag,
                                      const std::string& data,
                                      Json::Value& value,
                                      const std::string& key) {
-  // 1.1 means the compress rate. 12 means the compressed result header
-  uLong compressed_size = data.size() * 1.1 + 12;
-  std::unique_ptr<Byte[]> compressed_data =
-      std::make_unique<Byte[]>(compressed_size);
-  int z_result =
-      compress(compressed_data.get(), &compressed_size,
-               reinterpret_cast<const Cr_z_Bytef*>(data.c_str()), data.size());
-  if (z_result == Z_OK) {
-    unsigned long base64_size = modp_b64_encode_len(compressed_size);
-    std::unique_ptr<char[]> base64_data = std::make_unique<char[]>(base64_size);
-    modp_b64_encode(base64_data.get(),
-                    reinterpret_cast<const char*>(compressed_data.get()),
-                    compressed_size);
+  // reused by every call on this thread, only the value's copy is allocated.
+  static thread_local std::string base64;
+  base64.clear();
+  CompressionEngine::Result result =
+      CompressionEngine::ForCurrentThread().CompressToBase64(
+          data.data(), data.size(), compression_level_, base64);
+  if (result.z_result == Z_OK) {
     value["compress"] = true;
-    value[key] = std::string(base64_data.get());
+    value[key] = Json::Value(base64.data(), base64.data() + base64.size());
+    if (tune_compression_threshold_) {
+      compression_threshold_ = TuneCompressionThreshold(
+          result, compression_send_ns_per_byte_, compression_ratio_,
+          compression_ns_per_byte_);
+    }
+  }
+  // a large payload would keep its capacity for the thread's lifetime.
+  if (base64.capacity() > kMaxRetainedBase64Capacity) {
+    std::string().swap(base64);
   }
 
-  return z_result;
+  return result.z_result;
 }
 
 int CDPDomainAgentBase::GetCompressionThreshold() const {
@@ -46,6 +56,20 @@ bool CDPDomainAgentBase::UseCompression() const { return use_compression_; }
 
 void CDPDomainAgentBase::SetCompressionThreshold(uint32_t threshold) {
   compression_threshold_ = threshold;
+  tune_compression_threshold_ = false;
+}
+
+void CDPDomainAgentBase::EnableCompressionThresholdTuning(
+    uint32_t link_bytes_per_second) {
+  if (link_bytes_per_second == 0) {
+    return;
+  }
+  compression_send_ns_per_byte_ = 1e9 / link_bytes_per_second;
+  tune_compression_threshold_ = true;
+}
+
+void CDPDomainAgentBase::SetCompressionLevel(int level) {
+  compression_level_ = level;
 }
 
 }  // namespace devtool
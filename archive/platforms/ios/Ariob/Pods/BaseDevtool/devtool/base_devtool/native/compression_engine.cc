@@ -0,0 +1,396 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "devtool/base_devtool/native/compression_engine.h"
+
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "debug_router/native/base/base64.h"
+
+namespace lynx {
+namespace devtool {
+
+namespace {
+
+using debugrouter::base::Base64EncodedSize;
+using debugrouter::base::Base64StreamEncoder;
+
+// deflate output is encoded from a buffer of this size, small enough to stay
+// in cache between the two.
+constexpr size_t kChunkSize = 16 * 1024;
+
+// per message cost of compressing on top of the per byte one, mostly the
+// inflate setup on the frontend.
+constexpr double kFixedCostNs = 50000;
+constexpr double kWeight = 0.2;
+
+// deflate's window, what a block may refer to in the one before it.
+constexpr size_t kWindowSize = 32 * 1024;
+constexpr unsigned kMaxWorkers = 4;
+
+double Average(double average, double sample) {
+  return average <= 0 ? sample : average + kWeight * (sample - average);
+}
+
+// Threads deflating the blocks of large payloads, started on first use and
+// never stopped.
+class CompressionWorkerPool {
+ public:
+  static CompressionWorkerPool& GetInstance() {
+    // leaked, workers may still run while static objects are destroyed.
+    static CompressionWorkerPool* instance = new CompressionWorkerPool();
+    return *instance;
+  }
+
+  // Parallel compression is pointless with a single core.
+  bool Available() const { return workers_ > 1; }
+
+  void Post(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+  }
+
+ private:
+  CompressionWorkerPool()
+      : workers_(std::min(kMaxWorkers, std::thread::hardware_concurrency())) {
+    for (unsigned i = 0; i < workers_; ++i) {
+      std::thread([this]() { Run(); }).detach();
+    }
+  }
+
+  void Run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return !tasks_.empty(); });
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  const unsigned workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> tasks_;
+};
+
+// Raw deflate state of a worker thread, for one block at a time.
+class BlockDeflater {
+ public:
+  static BlockDeflater& ForCurrentThread() {
+    static thread_local BlockDeflater deflater;
+    return deflater;
+  }
+
+  ~BlockDeflater() {
+    if (initialized_) {
+      deflateEnd(&stream_);
+    }
+  }
+
+  // Deflates |size| bytes at |data| into |out|, primed with the |dictionary|
+  // bytes before it. The last block finishes the deflate stream, the others
+  // end with a sync flush, on a byte boundary.
+  int Deflate(const Bytef* data, size_t size, size_t dictionary, int level,
+              bool last, std::string& out) {
+    int z_result = Prepare(level);
+    if (z_result == Z_OK && dictionary > 0) {
+      z_result = deflateSetDictionary(&stream_, data - dictionary,
+                                      static_cast<uInt>(dictionary));
+    }
+    if (z_result != Z_OK) {
+      return z_result;
+    }
+    // the sync flush marker and its alignment come on top of the bound.
+    out.resize(deflateBound(&stream_, size) + 16);
+    stream_.next_in = const_cast<Bytef*>(data);
+    stream_.avail_in = static_cast<uInt>(size);
+    stream_.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream_.avail_out = static_cast<uInt>(out.size());
+    z_result = deflate(&stream_, last ? Z_FINISH : Z_SYNC_FLUSH);
+    if (z_result == (last ? Z_STREAM_END : Z_OK) && stream_.avail_in == 0 &&
+        stream_.avail_out > 0) {
+      z_result = Z_OK;
+    } else if (z_result == Z_OK || z_result == Z_STREAM_END) {
+      z_result = Z_BUF_ERROR;
+    }
+    out.resize(out.size() - stream_.avail_out);
+    return z_result;
+  }
+
+ private:
+  BlockDeflater() { std::memset(&stream_, 0, sizeof(stream_)); }
+
+  int Prepare(int level) {
+    if (initialized_ && level == level_) {
+      return deflateReset(&stream_);
+    }
+    if (initialized_) {
+      deflateEnd(&stream_);
+      initialized_ = false;
+    }
+    // negative window bits: no zlib header nor trailer, the caller writes
+    // them around all the blocks.
+    int z_result = deflateInit2(&stream_, level, Z_DEFLATED, -MAX_WBITS, 8,
+                                Z_DEFAULT_STRATEGY);
+    if (z_result == Z_OK) {
+      initialized_ = true;
+      level_ = level;
+    }
+    return z_result;
+  }
+
+  z_stream stream_;
+  bool initialized_ = false;
+  int level_ = Z_DEFAULT_COMPRESSION;
+};
+
+struct ParallelBlock {
+  std::string data;
+  uLong adler = 0;
+  int z_result = Z_OK;
+  bool done = false;
+};
+
+struct ParallelJob {
+  explicit ParallelJob(size_t count) : blocks(count) {}
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<ParallelBlock> blocks;
+};
+
+// The 2 bytes zlib writes in front of a deflate stream.
+void WriteZlibHeader(int level, Bytef header[2]) {
+  if (level == Z_DEFAULT_COMPRESSION) {
+    level = 6;
+  }
+  unsigned level_flags = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+  unsigned value = (0x78 << 8) | (level_flags << 6);
+  value += 31 - value % 31;
+  header[0] = static_cast<Bytef>(value >> 8);
+  header[1] = static_cast<Bytef>(value);
+}
+
+}  // namespace
+
+CompressionEngine& CompressionEngine::ForCurrentThread() {
+  static thread_local CompressionEngine engine;
+  return engine;
+}
+
+CompressionEngine::CompressionEngine() {
+  std::memset(&stream_, 0, sizeof(stream_));
+}
+
+CompressionEngine::~CompressionEngine() {
+  if (initialized_) {
+    deflateEnd(&stream_);
+  }
+}
+
+bool CompressionEngine::Prepare(int level) {
+  if (initialized_ && level == level_) {
+    return deflateReset(&stream_) == Z_OK;
+  }
+  // a new level is rare, starting over is simpler than deflateParams(),
+  // whose behaviour on a reset stream differs between zlib versions.
+  if (initialized_) {
+    deflateEnd(&stream_);
+    initialized_ = false;
+  }
+  // the defaults of compress2().
+  if (deflateInit2(&stream_, level, Z_DEFLATED, MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  initialized_ = true;
+  level_ = level;
+  return true;
+}
+
+CompressionEngine::Result CompressionEngine::CompressToBase64(
+    const char* data, size_t size, int level, std::string& out) {
+  if (size >= kParallelCompressionMinSize &&
+      CompressionWorkerPool::GetInstance().Available()) {
+    return CompressParallel(data, size, level, out);
+  }
+  auto begin = std::chrono::steady_clock::now();
+  Result result;
+  result.input_size = size;
+  if (!Prepare(level)) {
+    result.z_result = Z_STREAM_ERROR;
+    return result;
+  }
+  const size_t out_begin = out.size();
+  // sized for a ratio of one half, DOM and CSS payloads compress better.
+  out.reserve(out_begin + Base64EncodedSize(size / 2 + 64));
+
+  Base64StreamEncoder writer(out);
+  Bytef chunk[kChunkSize];
+  const Bytef* next = reinterpret_cast<const Bytef*>(data);
+  size_t remaining = size;
+  int z_result = Z_OK;
+  while (z_result == Z_OK) {
+    if (stream_.avail_in == 0) {
+      uInt avail = static_cast<uInt>(std::min<size_t>(remaining, UINT_MAX));
+      stream_.next_in = const_cast<Bytef*>(next);
+      stream_.avail_in = avail;
+      next += avail;
+      remaining -= avail;
+    }
+    stream_.next_out = chunk;
+    stream_.avail_out = kChunkSize;
+    z_result = deflate(&stream_, remaining == 0 ? Z_FINISH : Z_NO_FLUSH);
+    if (z_result == Z_BUF_ERROR) {
+      // no progress possible with an empty input and a full chunk.
+      z_result = Z_OK;
+    }
+    if (z_result != Z_OK && z_result != Z_STREAM_END) {
+      break;
+    }
+    size_t produced = kChunkSize - stream_.avail_out;
+    writer.Append(chunk, produced);
+    result.compressed_size += produced;
+  }
+  stream_.next_in = Z_NULL;
+  stream_.avail_in = 0;
+  if (z_result != Z_STREAM_END) {
+    out.resize(out_begin);
+    result.z_result = z_result;
+    return result;
+  }
+  writer.Finish();
+  result.cost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - begin);
+  return result;
+}
+
+CompressionEngine::Result CompressionEngine::CompressParallel(
+    const char* data, size_t size, int level, std::string& out) {
+  auto begin = std::chrono::steady_clock::now();
+  Result result;
+  result.input_size = size;
+  result.parallel = true;
+  const Bytef* input = reinterpret_cast<const Bytef*>(data);
+  const size_t block_size = kParallelCompressionBlockSize;
+  const size_t count = (size + block_size - 1) / block_size;
+  auto job = std::make_shared<ParallelJob>(count);
+  for (size_t i = 0; i < count; ++i) {
+    CompressionWorkerPool::GetInstance().Post([job, input, size, level, i]() {
+      size_t offset = i * kParallelCompressionBlockSize;
+      size_t length = std::min(kParallelCompressionBlockSize, size - offset);
+      bool last = offset + length == size;
+      std::string deflated;
+      int z_result = BlockDeflater::ForCurrentThread().Deflate(
+          input + offset, length, std::min(offset, kWindowSize), level, last,
+          deflated);
+      uLong adler = adler32(adler32(0L, Z_NULL, 0), input + offset,
+                            static_cast<uInt>(length));
+      std::lock_guard<std::mutex> lock(job->mutex);
+      ParallelBlock& block = job->blocks[i];
+      block.data.swap(deflated);
+      block.adler = adler;
+      block.z_result = z_result;
+      block.done = true;
+      job->condition.notify_all();
+    });
+  }
+
+  const size_t out_begin = out.size();
+  out.reserve(out_begin + Base64EncodedSize(size / 2 + 64));
+  Base64StreamEncoder writer(out);
+  Bytef header[2];
+  WriteZlibHeader(level, header);
+  writer.Append(header, sizeof(header));
+  result.compressed_size = sizeof(header);
+  uLong adler = adler32(0L, Z_NULL, 0);
+  int z_result = Z_OK;
+  // blocks are written in order as they complete. Every block is waited for
+  // even after a failure, they read from |data|.
+  for (size_t i = 0; i < count; ++i) {
+    std::string deflated;
+    uLong block_adler;
+    int block_result;
+    {
+      std::unique_lock<std::mutex> lock(job->mutex);
+      ParallelBlock& block = job->blocks[i];
+      job->condition.wait(lock, [&block]() { return block.done; });
+      deflated.swap(block.data);
+      block_adler = block.adler;
+      block_result = block.z_result;
+    }
+    if (z_result != Z_OK) {
+      continue;
+    }
+    if (block_result != Z_OK) {
+      z_result = block_result;
+      continue;
+    }
+    writer.Append(reinterpret_cast<const Bytef*>(deflated.data()),
+                  deflated.size());
+    result.compressed_size += deflated.size();
+    size_t length = std::min(block_size, size - i * block_size);
+    adler = adler32_combine(adler, block_adler, static_cast<z_off_t>(length));
+  }
+  if (z_result != Z_OK) {
+    out.resize(out_begin);
+    result.z_result = z_result;
+    return result;
+  }
+  Bytef trailer[4] = {
+      static_cast<Bytef>(adler >> 24), static_cast<Bytef>(adler >> 16),
+      static_cast<Bytef>(adler >> 8), static_cast<Bytef>(adler)};
+  writer.Append(trailer, sizeof(trailer));
+  writer.Finish();
+  result.compressed_size += sizeof(trailer);
+  result.cost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - begin);
+  return result;
+}
+
+uint32_t TuneCompressionThreshold(const CompressionEngine::Result& result,
+                                  double send_ns_per_byte, double& ratio,
+                                  double& ns_per_byte) {
+  if (result.z_result != Z_OK || result.input_size == 0) {
+    return kMaxCompressionThreshold;
+  }
+  double size = static_cast<double>(result.input_size);
+  ratio = Average(ratio, result.compressed_size / size);
+  // the wall-clock cost of a parallel result is a fraction of the cpu time
+  // spent, and payloads that large are far above any threshold anyway.
+  if (!result.parallel) {
+    ns_per_byte = Average(ns_per_byte, result.cost.count() / size);
+  }
+  if (ns_per_byte <= 0) {
+    return kMaxCompressionThreshold;
+  }
+  // base64 makes the compressed payload a third larger.
+  double gain = (1 - ratio * 4 / 3) * send_ns_per_byte - ns_per_byte;
+  if (gain <= 0) {
+    return kMaxCompressionThreshold;
+  }
+  double threshold = kFixedCostNs / gain;
+  return static_cast<uint32_t>(
+      std::min<double>(kMaxCompressionThreshold,
+                       std::max<double>(kMinCompressionThreshold, threshold)));
+}
+
+}  // namespace devtool
+}  // namespace lynx
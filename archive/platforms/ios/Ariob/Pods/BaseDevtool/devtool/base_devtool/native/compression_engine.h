@@ -0,0 +1,86 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEVTOOL_BASE_DEVTOOL_NATIVE_COMPRESSION_ENGINE_H_
+#define DEVTOOL_BASE_DEVTOOL_NATIVE_COMPRESSION_ENGINE_H_
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "third_party/zlib/zlib.h"
+
+namespace lynx {
+namespace devtool {
+
+constexpr size_t kParallelCompressionMinSize = 1024 * 1024;
+constexpr size_t kParallelCompressionBlockSize = 128 * 1024;
+
+/**
+ * Deflates CDP payloads into base64 text, the format of the "compress"
+ * messages: zlib stream (as compress() writes it), then base64.
+ *
+ * The engine owns a z_stream kept across calls and reset between them, which
+ * saves allocating and initializing the deflate state, about 270KB, on every
+ * message. Output is produced in small chunks which are base64 encoded right
+ * away into the caller's buffer, the compressed data is never held whole.
+ *
+ * Inputs of kParallelCompressionMinSize bytes or more, full DOM trees or heap
+ * snapshots, are split into blocks deflated in parallel on a small worker
+ * pool, the way pigz does: every block is primed with the 32KB before it and
+ * ends on a byte boundary, so the blocks concatenate into one regular zlib
+ * stream, barely larger than the serial one.
+ */
+class CompressionEngine {
+ public:
+  struct Result {
+    int z_result = Z_OK;
+    size_t input_size = 0;
+    size_t compressed_size = 0;
+    // wall-clock time of the call. For parallel results it leaves out the
+    // time the workers spent side by side.
+    std::chrono::nanoseconds cost{0};
+    bool parallel = false;
+  };
+
+  // The engine of the calling thread, created on first use.
+  static CompressionEngine& ForCurrentThread();
+
+  CompressionEngine();
+  ~CompressionEngine();
+  CompressionEngine(const CompressionEngine&) = delete;
+  CompressionEngine& operator=(const CompressionEngine&) = delete;
+
+  // Appends the base64 of |data| deflated at |level| (Z_DEFAULT_COMPRESSION
+  // or 0-9) to |out|. On failure |out| is left as it was.
+  Result CompressToBase64(const char* data, size_t size, int level,
+                          std::string& out);
+
+ private:
+  bool Prepare(int level);
+  Result CompressParallel(const char* data, size_t size, int level,
+                          std::string& out);
+
+  z_stream stream_;
+  bool initialized_ = false;
+  int level_ = Z_DEFAULT_COMPRESSION;
+};
+
+constexpr uint32_t kMinCompressionThreshold = 1024;
+// capped so that payloads which turn compressible again keep being measured.
+constexpr uint32_t kMaxCompressionThreshold = 256 * 1024;
+
+// Adds |result| to the moving averages |ratio| and |ns_per_byte|. Parallel
+// results only update the ratio, as their cost is not the cpu time spent.
+// Returns the payload size from which compressing pays off when sending a
+// byte to the frontend costs |send_ns_per_byte|. Smaller payloads are
+// cheaper to send as they are.
+uint32_t TuneCompressionThreshold(const CompressionEngine::Result& result,
+                                  double send_ns_per_byte, double& ratio,
+                                  double& ns_per_byte);
+
+}  // namespace devtool
+}  // namespace lynx
+
+#endif  // DEVTOOL_BASE_DEVTOOL_NATIVE_COMPRESSION_ENGINE_H_
@@ -0,0 +1,65 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "debug_router/native/base/base64.h"
+#include "devtool/base_devtool/native/compression_engine.h"
+
+namespace lynx {
+namespace devtool {
+namespace {
+
+using debugrouter::base::Base64Encode;
+
+// Looks like the DOM.getDocument results the payloads mostly are.
+std::string MakePayload(size_t size) {
+  std::string payload = "{\"root\":{\"children\":[";
+  for (int id = 0; payload.size() < size; ++id) {
+    payload += "{\"nodeId\":" + std::to_string(id) +
+               ",\"nodeName\":\"view\",\"attributes\":[\"class\",\"item-" +
+               std::to_string(id % 17) + "\",\"style\",\"width:" +
+               std::to_string(id % 300) + "px\"],\"childNodeCount\":0},";
+  }
+  payload.resize(size);
+  return payload;
+}
+
+// What CompressData() did before the engine: compress() into a buffer sized
+// for the worst case, then base64 of the whole buffer.
+void BM_Compress2ThenBase64(benchmark::State& state) {
+  std::string payload = MakePayload(state.range(0));
+  for (auto _ : state) {
+    uLong compressed_size = compressBound(payload.size());
+    std::unique_ptr<Bytef[]> compressed =
+        std::make_unique<Bytef[]>(compressed_size);
+    compress2(compressed.get(), &compressed_size,
+              reinterpret_cast<const Bytef*>(payload.data()), payload.size(),
+              Z_DEFAULT_COMPRESSION);
+    std::string base64;
+    Base64Encode(compressed.get(), compressed_size, base64);
+    benchmark::DoNotOptimize(base64.data());
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_Compress2ThenBase64)->Arg(4 << 10)->Arg(64 << 10)->Arg(512 << 10);
+
+void BM_CompressionEngine(benchmark::State& state) {
+  std::string payload = MakePayload(state.range(0));
+  std::string base64;
+  for (auto _ : state) {
+    base64.clear();
+    CompressionEngine::ForCurrentThread().CompressToBase64(
+        payload.data(), payload.size(), Z_DEFAULT_COMPRESSION, base64);
+    benchmark::DoNotOptimize(base64.data());
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_CompressionEngine)->Arg(4 << 10)->Arg(64 << 10)->Arg(512 << 10);
+
+}  // namespace
+}  // namespace devtool
+}  // namespace lynx
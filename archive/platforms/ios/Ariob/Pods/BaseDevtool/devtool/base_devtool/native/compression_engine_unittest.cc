@@ -0,0 +1,115 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "devtool/base_devtool/native/compression_engine.h"
+
+#include <chrono>
+#include <string>
+
+#include "debug_router/native/base/base64.h"
+#include "gtest/gtest.h"
+
+namespace lynx {
+namespace devtool {
+namespace {
+
+using debugrouter::base::Base64Decode;
+
+std::string MakePayload(size_t size) {
+  std::string payload;
+  for (int id = 0; payload.size() < size; ++id) {
+    payload += "{\"nodeId\":" + std::to_string(id) + ",\"width\":" +
+               std::to_string(id * 7919 % 1000) + "},";
+  }
+  payload.resize(size);
+  return payload;
+}
+
+std::string Inflate(const std::string& base64, size_t size) {
+  std::string compressed;
+  EXPECT_TRUE(Base64Decode(base64.data(), base64.size(), compressed));
+  std::string data(size, '\0');
+  uLongf data_size = size;
+  EXPECT_EQ(uncompress(reinterpret_cast<Bytef*>(&data[0]), &data_size,
+                       reinterpret_cast<const Bytef*>(compressed.data()),
+                       compressed.size()),
+            Z_OK);
+  data.resize(data_size);
+  return data;
+}
+
+CompressionEngine::Result MakeResult(size_t size, size_t compressed_size,
+                                     int64_t cost_ns, bool parallel) {
+  CompressionEngine::Result result;
+  result.input_size = size;
+  result.compressed_size = compressed_size;
+  result.cost = std::chrono::nanoseconds(cost_ns);
+  result.parallel = parallel;
+  return result;
+}
+
+}  // namespace
+
+// Below and above kParallelCompressionMinSize, the parallel path is taken on
+// multi-core devices for the latter.
+TEST(CompressionEngineTest, OutputInflatesToInput) {
+  for (size_t size : {size_t(0), size_t(1000), kParallelCompressionMinSize,
+                      kParallelCompressionMinSize * 3 + 17}) {
+    std::string payload = MakePayload(size);
+    std::string base64 = "prefix";
+    CompressionEngine::Result result =
+        CompressionEngine::ForCurrentThread().CompressToBase64(
+            payload.data(), payload.size(), Z_DEFAULT_COMPRESSION, base64);
+    ASSERT_EQ(result.z_result, Z_OK);
+    EXPECT_EQ(result.input_size, size);
+    if (size < kParallelCompressionMinSize) {
+      EXPECT_FALSE(result.parallel);
+    }
+    ASSERT_EQ(base64.compare(0, 6, "prefix"), 0);
+    EXPECT_EQ(Inflate(base64.substr(6), size), payload);
+  }
+}
+
+// The wall-clock cost of a parallel result would make compressing look
+// cheaper than it is, only its ratio is taken.
+TEST(CompressionEngineTest, ParallelCostDoesNotFeedTheTuner) {
+  double ratio = 0;
+  double ns_per_byte = 0;
+  EXPECT_EQ(TuneCompressionThreshold(MakeResult(4 << 20, 1 << 20, 1000, true),
+                                     100, ratio, ns_per_byte),
+            kMaxCompressionThreshold);
+  EXPECT_DOUBLE_EQ(ratio, 0.25);
+  EXPECT_EQ(ns_per_byte, 0);
+
+  uint32_t threshold = TuneCompressionThreshold(
+      MakeResult(64 << 10, 16 << 10, 20 * (64 << 10), false), 100, ratio,
+      ns_per_byte);
+  EXPECT_DOUBLE_EQ(ns_per_byte, 20);
+  TuneCompressionThreshold(MakeResult(4 << 20, 1 << 20, 1000, true), 100,
+                           ratio, ns_per_byte);
+  EXPECT_DOUBLE_EQ(ns_per_byte, 20);
+  EXPECT_EQ(TuneCompressionThreshold(
+                MakeResult(64 << 10, 16 << 10, 20 * (64 << 10), false), 100,
+                ratio, ns_per_byte),
+            threshold);
+}
+
+TEST(CompressionEngineTest, ThresholdFollowsTheLink) {
+  double ratio = 0;
+  double ns_per_byte = 0;
+  CompressionEngine::Result result =
+      MakeResult(64 << 10, 16 << 10, 20 * (64 << 10), false);
+  // 10MB/s: (1 - 1/3) * 100 - 20 = 46ns saved per byte.
+  EXPECT_EQ(TuneCompressionThreshold(result, 100, ratio, ns_per_byte),
+            static_cast<uint32_t>(50000 / (200.0 / 3 - 20)));
+  // a link as fast as the compression never pays off.
+  EXPECT_EQ(TuneCompressionThreshold(result, 30, ratio, ns_per_byte),
+            kMaxCompressionThreshold);
+  // a slow link pays off from the smallest payloads.
+  EXPECT_EQ(TuneCompressionThreshold(result, 10000, ratio, ns_per_byte),
+            kMinCompressionThreshold);
+}
+
+}  // namespace devtool
+}  // namespace lynx
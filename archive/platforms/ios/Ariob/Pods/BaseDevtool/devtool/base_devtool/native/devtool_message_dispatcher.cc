@@ -5,6 +5,7 @@
 #include "devtool/base_devtool/native/public/devtool_message_dispatcher.h"
 
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "base/include/log/logging.h"
@@ -15,6 +16,17 @@
 namespace lynx {
 namespace devtool {
 
+DevToolMessageDispatcher::DevToolMessageDispatcher() {
+  // Members parsed from every CDP message then keep pointing at these
+  // literals instead of owning a copy of the name.
+  static std::once_flag interned;
+  std::call_once(interned, []() {
+    for (const char* key : {"id", "method", "params", "sessionId"}) {
+      Json::Value::internKey(Json::StaticString(key));
+    }
+  });
+}
+
 void DevToolMessageDispatcher::DispatchMessage(
     const std::shared_ptr<MessageSender>& sender, const std::string& type,
     const std::string& msg) {
@@ -23,7 +35,13 @@ void DevToolMessageDispatcher::DispatchMessage(
   if (!reader.parse(msg, root, false)) {
     return;
   }
-  DispatchJsonMessage(sender, type, root);
+  DispatchMessage(sender, type, root);
+}
+
+void DevToolMessageDispatcher::DispatchMessage(
+    const std::shared_ptr<MessageSender>& sender, const std::string& type,
+    const Json::Value& msg) {
+  DispatchJsonMessage(sender, type, msg);
 }
 
 void DevToolMessageDispatcher::DispatchCDPMessage(
@@ -35,11 +53,10 @@ void DevToolMessageDispatcher::DispatchCDPMessage(
   std::shared_lock<std::shared_mutex> lock(agent_mutex_);
   auto iter = agent_map_.find(domain);
   if (iter == agent_map_.end()) {
-    Json::Value error;
-    error["code"] = kInspectorErrorCode;
-    error["message"] = "Not implemented: " + method;
-    content["error"] = error;
-    content["id"] = msg["id"].asInt64();
+    Json::Value& error = content[Json::StaticString("error")];
+    error[Json::StaticString("code")] = kInspectorErrorCode;
+    error[Json::StaticString("message")] = "Not implemented: " + method;
+    content[Json::StaticString("id")] = msg["id"].asInt64();
     sender->SendMessage("CDP", content);
   } else {
     iter->second->CallMethod(sender, msg);
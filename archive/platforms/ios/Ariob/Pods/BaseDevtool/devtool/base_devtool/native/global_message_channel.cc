@@ -27,7 +27,7 @@ void GlobalMessageChannel::Initialize() {
 
 void GlobalMessageChannel::SendMessage(const std::string& type,
                                        const Json::Value& msg) {
-  slot_->SendMessage(type, msg.toStyledString());
+  slot_->SendMessage(type, Json::toCompactString(msg));
 }
 
 void GlobalMessageChannel::SendMessage(const std::string& type,
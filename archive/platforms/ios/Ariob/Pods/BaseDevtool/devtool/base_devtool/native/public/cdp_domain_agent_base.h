@@ -27,13 +27,27 @@ class BASE_DEVTOOL_EXPORT CDPDomainAgentBase {
                    Json::Value& value, const std::string& key);
 
   int GetCompressionThreshold() const;
+  // Also turns off the tuning below.
   void SetCompressionThreshold(uint32_t threshold);
+  // Lets CompressData() tune the threshold to the ratio and cost it measures,
+  // for a link to the frontend of |link_bytes_per_second|, about 10MB/s over
+  // usb. Off by default, the threshold stays where it was set.
+  void EnableCompressionThresholdTuning(uint32_t link_bytes_per_second);
+  // zlib level, Z_DEFAULT_COMPRESSION (-1) or 0-9.
+  void SetCompressionLevel(int level);
 
   bool UseCompression() const;
 
  protected:
   bool use_compression_ = false;
   uint32_t compression_threshold_ = 10240;
+  bool tune_compression_threshold_ = false;
+  int compression_level_ = -1;
+  double compression_send_ns_per_byte_ = 0;
+  // moving averages of the ratio and cost of CompressData(), per agent as
+  // payloads differ between domains.
+  double compression_ratio_ = 0;
+  double compression_ns_per_byte_ = 0;
 };
 }  // namespace devtool
 }  // namespace lynx
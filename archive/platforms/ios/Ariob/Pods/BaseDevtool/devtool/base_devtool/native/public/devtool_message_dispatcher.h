@@ -32,13 +32,17 @@ static const char kDomainDot = '.';
 class BASE_DEVTOOL_EXPORT DevToolMessageDispatcher
     : public std::enable_shared_from_this<DevToolMessageDispatcher> {
  public:
-  DevToolMessageDispatcher() = default;
+  DevToolMessageDispatcher();
   virtual ~DevToolMessageDispatcher() = default;
 
   // When a message arrives, this method can parse the message and dispatch it
   // to the corresponding agent or handler.
   virtual void DispatchMessage(const std::shared_ptr<MessageSender>& sender,
                                const std::string& type, const std::string& msg);
+  // Same as above for a message that has already been parsed, so that it is
+  // not parsed again on the way to the agent or handler.
+  virtual void DispatchMessage(const std::shared_ptr<MessageSender>& sender,
+                               const std::string& type, const Json::Value& msg);
   // for CDP domain agent
   void RegisterAgent(const std::string& agent_name,
                      std::unique_ptr<CDPDomainAgentBase>&& agent);
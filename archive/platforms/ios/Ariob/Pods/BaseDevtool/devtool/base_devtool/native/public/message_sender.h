@@ -24,16 +24,18 @@ class MessageSender {
  public:
   void SendOKResponse(int64_t id) {
     Json::Value res;
-    res["result"] = Json::Value(Json::ValueType::objectValue);
-    res["id"] = id;
+    res[Json::StaticString("result")] =
+        Json::Value(Json::ValueType::objectValue);
+    res[Json::StaticString("id")] = id;
     SendMessage("CDP", res);
   }
 
   void SendErrorResponse(int64_t id, const std::string& error) {
     Json::Value res;
-    res["error"]["code"] = kInspectorErrorCode;
-    res["error"]["message"] = error;
-    res["id"] = id;
+    Json::Value& error_value = res[Json::StaticString("error")];
+    error_value[Json::StaticString("code")] = kInspectorErrorCode;
+    error_value[Json::StaticString("message")] = error;
+    res[Json::StaticString("id")] = id;
     SendMessage("CDP", res);
   }
 
@@ -37,7 +37,7 @@ void ViewMessageChannel::OnMessageReceivedFromDebugRouter(
 
 void ViewMessageChannel::SendMessage(const std::string& type,
                                      const Json::Value& msg) {
-  slot_->SendMessage(type, msg.toStyledString());
+  slot_->SendMessage(type, Json::toCompactString(msg));
 }
 
 void ViewMessageChannel::SendMessage(const std::string& type,
@@ -27,14 +27,23 @@ void ViewMessageDispatcher::Initialize() {
 void ViewMessageDispatcher::DispatchMessage(
     const std::shared_ptr<MessageSender>& sender, const std::string& type,
     const std::string& msg) {
+  // parse once, both the agents and the subscribers share the same tree.
+  Json::Value root;
+  Json::Reader reader;
+  if (!reader.parse(msg, root, false)) {
+    return;
+  }
+  DispatchMessage(sender, type, root);
+}
+
+void ViewMessageDispatcher::DispatchMessage(
+    const std::shared_ptr<MessageSender>& sender, const std::string& type,
+    const Json::Value& msg) {
   DevToolMessageDispatcher::DispatchMessage(sender, type, msg);
   std::shared_lock<std::shared_mutex> lock(subscribe_mutex_);
   auto it = subscribe_handler_map_.find(type);
   if (it != subscribe_handler_map_.end()) {
-    Json::Reader reader;
-    Json::Value message;
-    reader.parse(msg, message);
-    it->second->handle(sender, type, message);
+    it->second->handle(sender, type, msg);
     return;
   }
 }
@@ -26,6 +26,9 @@ class ViewMessageDispatcher : public DevToolMessageDispatcher {
   void DispatchMessage(const std::shared_ptr<MessageSender>& sender,
                        const std::string& type,
                        const std::string& msg) override;
+  void DispatchMessage(const std::shared_ptr<MessageSender>& sender,
+                       const std::string& type,
+                       const Json::Value& msg) override;
   // for handling all kinds of messages
   void SubscribeMessage(const std::string& type,
                         std::unique_ptr<DevToolMessageHandler>&& handler);
@@ -362,6 +362,132 @@ public:
   static void strictMode(Json::Value* settings);
 };
 
+/** \brief Receives the events of a StreamReader.
+ *
+ * Every callback returns true to continue and false to stop the parse, the
+ * default implementations ignore the event. Strings and member names are
+ * passed unescaped as a [begin, end) range which is only valid during the
+ * call.
+ */
+class JSON_API StreamHandler {
+public:
+  virtual ~StreamHandler();
+
+  virtual bool onNull();
+  virtual bool onBool(bool value);
+  virtual bool onInt(LargestInt value);
+  /// Only called for integers above the LargestInt range.
+  virtual bool onUInt(LargestUInt value);
+  virtual bool onDouble(double value);
+  virtual bool onString(char const* begin, char const* end);
+  virtual bool onStartObject();
+  virtual bool onKey(char const* begin, char const* end);
+  virtual bool onEndObject();
+  virtual bool onStartArray();
+  virtual bool onEndArray();
+};
+
+/** \brief Event driven reader that consumes its input incrementally.
+ *
+ * Unlike Reader, no Value is built: the document is reported to a
+ * StreamHandler while it is fed, possibly one chunk at a time as it arrives.
+ * Only the nesting stack and the string or number being read when a chunk
+ * ends are kept, so memory does not grow with the document.
+ *
+ * The input must be strict JSON with a single root value, comments are not
+ * accepted.
+ * \code
+ * Json::StreamReader reader(handler);
+ * while (reader.feed(data, size) == Json::StreamReader::needMoreInput)
+ *   ... wait for the next chunk ...
+ * reader.finish();
+ * \endcode
+ */
+class JSON_API StreamReader {
+public:
+  enum Status {
+    needMoreInput, ///< The root value is not complete yet.
+    complete,      ///< The root value has been read.
+    stopped,       ///< A handler returned false.
+    failed         ///< Syntax error, see errorMessage().
+  };
+
+  explicit StreamReader(StreamHandler& handler);
+
+  /// Maximum nesting of objects and arrays, 1000 by default.
+  void setStackLimit(unsigned limit);
+
+  /** \brief Parses the next chunk of the document.
+   *
+   * Once the status is stopped or failed, further input is ignored. After
+   * the root value, only blanks are accepted.
+   */
+  Status feed(char const* data, size_t length);
+  Status feed(JSONCPP_STRING const& data) {
+    return feed(data.data(), data.size());
+  }
+  /// Marks the end of the input, a root number is only complete then.
+  Status finish();
+  /// Forgets the current document, the reader can then parse another one.
+  void reset();
+
+  Status status() const { return status_; }
+  /// Number of bytes consumed since the last reset().
+  size_t offset() const { return consumed_; }
+  /// Describes the syntax error and its offset when status() is failed.
+  JSONCPP_STRING const& errorMessage() const { return error_; }
+
+private:
+  enum State {
+    stateValue,
+    stateArrayFirst,
+    stateObjectFirst,
+    stateKey,
+    stateColon,
+    stateCommaOrEnd,
+    stateString,
+    stateEscape,
+    stateUnicode,
+    stateSurrogateBackslash,
+    stateSurrogateU,
+    stateNumber,
+    stateLiteral,
+    stateDone
+  };
+
+  StreamReader(StreamReader const&);
+  void operator=(StreamReader const&);
+
+  char const* readValue(char const* current);
+  char const* readString(char const* current, char const* end);
+  char const* readEscape(char const* current);
+  char const* readUnicode(char const* current);
+  bool endString(char const* begin, char const* end);
+  bool endNumber(char const* current);
+  bool endContainer(char type);
+  void endValue();
+  bool emit(bool proceed);
+  bool fail(char const* message, char const* current);
+
+  StreamHandler& handler_;
+  unsigned stackLimit_;
+  Status status_;
+  State state_;
+  // '{' or '[' per open container.
+  JSONCPP_STRING stack_;
+  // Unescaped string, or number characters, read so far.
+  JSONCPP_STRING buffer_;
+  bool isKey_;
+  char const* literal_;
+  unsigned literalLength_;
+  unsigned matched_;
+  unsigned unicode_;
+  unsigned highSurrogate_;
+  char const* chunk_;
+  size_t consumed_;
+  JSONCPP_STRING error_;
+};
+
 /** Consume entire stream and use its begin/end.
   * Someday we might have a real StreamReader, but for now this
   * is convenient.
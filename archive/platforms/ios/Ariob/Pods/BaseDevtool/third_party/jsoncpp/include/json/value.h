@@ -140,6 +140,44 @@ private:
   const char* c_str_;
 };
 
+/** \brief Immutable, reference counted string.
+ *
+ * A Value constructed from a SharedString, and every copy of that Value,
+ * points to the same buffer instead of owning a copy of the string. The
+ * buffer is released with its last reference, from any thread.
+ *
+ * Value constructors store strings of at least JSON_SHARED_STRING_MIN_LENGTH
+ * bytes this way on their own, a SharedString is only needed to share a
+ * buffer between values built separately, or to keep it outside of any Value.
+ *
+ * Example of usage:
+ * \code
+ * Json::SharedString data(frame); // copied once
+ * params["data"] = data;          // shared
+ * content["params"] = params;     // still shared
+ * \endcode
+ */
+class JSON_API SharedString {
+public:
+  SharedString();
+  SharedString(const char* data, size_t length);
+  explicit SharedString(const JSONCPP_STRING& value);
+  SharedString(const SharedString& other);
+  SharedString& operator=(SharedString other);
+  ~SharedString();
+
+  const char* data() const;
+  size_t length() const;
+  bool empty() const { return length() == 0; }
+  void swap(SharedString& other);
+
+private:
+  friend class Value;
+
+  // Stored like an allocated Value string, preceded by the reference count.
+  char* string_;
+};
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represents a:
@@ -308,6 +346,8 @@ Json::Value obj_value(Json::objectValue); // {}
    */
   Value(const StaticString& value);
   Value(const JSONCPP_STRING& value); ///< Copy data() til size(). Embedded zeroes too.
+  /// Shares the buffer of \c value, see SharedString.
+  Value(const SharedString& value);
 #ifdef JSON_USE_CPPTL
   Value(const CppTL::ConstString& value);
 #endif
@@ -344,6 +384,8 @@ Json::Value obj_value(Json::objectValue); // {}
   unsigned getCStringLength() const; //Allows you to understand the length of the CString
 #endif
   JSONCPP_STRING asString() const; ///< Embedded zeroes are possible.
+  /// Like asString(), but without a copy if the string is already shared.
+  SharedString asSharedString() const;
   /** Get raw char* of string-value.
    *  \return false if !string. (Seg-fault if str or end are NULL.)
    */
@@ -465,6 +507,19 @@ Json::Value obj_value(Json::objectValue); // {}
    * \endcode
    */
   Value& operator[](const StaticString& key);
+  /** \brief Registers a well known member name.
+   *
+   * Members later created under an equal name, through operator[] or by a
+   * Reader, store a pointer to \c key instead of a private copy, as if they
+   * had been created with a StaticString. \c key must stay valid for the
+   * lifetime of the program. Names can not be unregistered and the table
+   * holds at most 192 of them, returns false once it is full.
+   * \code
+   * static const StaticString kId("id");
+   * Json::Value::internKey(kId);
+   * \endcode
+   */
+  static bool internKey(const StaticString& key);
 #ifdef JSON_USE_CPPTL
   /// Access an object value by name, create a null member if it does not exist.
   Value& operator[](const CppTL::ConstString& key);
@@ -581,6 +636,7 @@ Json::Value obj_value(Json::objectValue); // {}
 
 private:
   void initBasic(ValueType type, bool allocated = false);
+  void initString(const char* value, unsigned length);
 
   Value& resolveReference(const char* key);
   Value& resolveReference(const char* key, const char* end);
@@ -614,6 +670,8 @@ private:
   ValueType type_ : 8;
   unsigned int allocated_ : 1; // Notes: if declared as bool, bitfield is useless.
                                // If not allocated_, string_ must be null-terminated.
+  unsigned int shared_ : 1;    // string_ comes from a SharedString, allocated_
+                               // is set as well.
   CommentInfo* comments_;
 
   // [start, limit) byte offsets in the source JSON text from which this Value
@@ -326,15 +326,7 @@ bool Reader::readToken(Token& token) {
   return true;
 }
 
-void Reader::skipSpaces() {
-  while (current_ != end_) {
-    Char c = *current_;
-    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-      ++current_;
-    else
-      break;
-  }
-}
+void Reader::skipSpaces() { current_ = skipWhitespace(current_, end_); }
 
 bool Reader::match(Location pattern, int patternLength) {
   if (end_ - current_ < patternLength)
@@ -449,15 +441,17 @@ void Reader::readNumber() {
 }
 
 bool Reader::readString() {
-  Char c = '\0';
   while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '"')
+    current_ = findQuoteOrEscape(current_, end_, '"');
+    if (current_ == end_)
       break;
+    if (*current_++ == '"')
+      return true;
+    // skip the escaped character.
+    if (current_ != end_)
+      ++current_;
   }
-  return c == '"';
+  return false;
 }
 
 bool Reader::readObject(Token& tokenStart) {
@@ -618,6 +612,10 @@ bool Reader::decodeDouble(Token& token) {
 
 bool Reader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
+  if (decodeDoubleFastPath(token.start_, token.end_, value)) {
+    decoded = value;
+    return true;
+  }
   JSONCPP_STRING buffer(token.start_, token.end_);
   JSONCPP_ISTRINGSTREAM is(buffer);
   if (!(is >> value))
@@ -644,6 +642,12 @@ bool Reader::decodeString(Token& token, JSONCPP_STRING& decoded) {
   Location current = token.start_ + 1; // skip '"'
   Location end = token.end_ - 1;       // do not include '"'
   while (current != end) {
+    // copy the unescaped run in one go.
+    Location special = findQuoteOrEscape(current, end, '"');
+    decoded.append(current, special);
+    current = special;
+    if (current == end)
+      break;
     Char c = *current++;
     if (c == '"')
       break;
@@ -685,8 +689,6 @@ bool Reader::decodeString(Token& token, JSONCPP_STRING& decoded) {
       default:
         return addError("Bad escape sequence in string", token, current);
       }
-    } else {
-      decoded += c;
     }
   }
   return true;
@@ -1301,15 +1303,7 @@ bool OurReader::readToken(Token& token) {
   return true;
 }
 
-void OurReader::skipSpaces() {
-  while (current_ != end_) {
-    Char c = *current_;
-    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-      ++current_;
-    else
-      break;
-  }
-}
+void OurReader::skipSpaces() { current_ = skipWhitespace(current_, end_); }
 
 bool OurReader::match(Location pattern, int patternLength) {
   if (end_ - current_ < patternLength)
@@ -1409,28 +1403,32 @@ bool OurReader::readNumber(bool checkInf) {
   return true;
 }
 bool OurReader::readString() {
-  Char c = 0;
   while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '"')
+    current_ = findQuoteOrEscape(current_, end_, '"');
+    if (current_ == end_)
       break;
+    if (*current_++ == '"')
+      return true;
+    // skip the escaped character.
+    if (current_ != end_)
+      ++current_;
   }
-  return c == '"';
+  return false;
 }
 
 
 bool OurReader::readStringSingleQuote() {
-  Char c = 0;
   while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '\'')
+    current_ = findQuoteOrEscape(current_, end_, '\'');
+    if (current_ == end_)
       break;
+    if (*current_++ == '\'')
+      return true;
+    // skip the escaped character.
+    if (current_ != end_)
+      ++current_;
   }
-  return c == '\'';
+  return false;
 }
 
 bool OurReader::readObject(Token& tokenStart) {
@@ -1595,6 +1593,10 @@ bool OurReader::decodeDouble(Token& token) {
 
 bool OurReader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
+  if (decodeDoubleFastPath(token.start_, token.end_, value)) {
+    decoded = value;
+    return true;
+  }
   const int bufferSize = 32;
   int count;
   ptrdiff_t const length = token.end_ - token.start_;
@@ -1647,6 +1649,12 @@ bool OurReader::decodeString(Token& token, JSONCPP_STRING& decoded) {
   Location current = token.start_ + 1; // skip '"'
   Location end = token.end_ - 1;       // do not include '"'
   while (current != end) {
+    // copy the unescaped run in one go.
+    Location special = findQuoteOrEscape(current, end, '"');
+    decoded.append(current, special);
+    current = special;
+    if (current == end)
+      break;
     Char c = *current++;
     if (c == '"')
       break;
@@ -1688,8 +1696,6 @@ bool OurReader::decodeString(Token& token, JSONCPP_STRING& decoded) {
       default:
         return addError("Bad escape sequence in string", token, current);
       }
-    } else {
-      decoded += c;
     }
   }
   return true;
@@ -2002,6 +2008,438 @@ void CharReaderBuilder::setDefaults(Json::Value* settings)
 //! [CharReaderBuilderDefaults]
 }
 
+// Implementation of class StreamReader
+// ////////////////////////////////
+
+StreamHandler::~StreamHandler() {}
+bool StreamHandler::onNull() { return true; }
+bool StreamHandler::onBool(bool) { return true; }
+bool StreamHandler::onInt(LargestInt) { return true; }
+bool StreamHandler::onUInt(LargestUInt) { return true; }
+bool StreamHandler::onDouble(double) { return true; }
+bool StreamHandler::onString(char const*, char const*) { return true; }
+bool StreamHandler::onStartObject() { return true; }
+bool StreamHandler::onKey(char const*, char const*) { return true; }
+bool StreamHandler::onEndObject() { return true; }
+bool StreamHandler::onStartArray() { return true; }
+bool StreamHandler::onEndArray() { return true; }
+
+static inline bool isNumberCharacter(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+         c == 'e' || c == 'E';
+}
+
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+StreamReader::StreamReader(StreamHandler& handler)
+    : handler_(handler), stackLimit_(1000) {
+  reset();
+}
+
+void StreamReader::setStackLimit(unsigned limit) { stackLimit_ = limit; }
+
+void StreamReader::reset() {
+  status_ = needMoreInput;
+  state_ = stateValue;
+  stack_.clear();
+  buffer_.clear();
+  isKey_ = false;
+  literal_ = 0;
+  literalLength_ = 0;
+  matched_ = 0;
+  unicode_ = 0;
+  highSurrogate_ = 0;
+  chunk_ = 0;
+  consumed_ = 0;
+  error_.clear();
+}
+
+StreamReader::Status StreamReader::feed(char const* data, size_t length) {
+  if (status_ == stopped || status_ == failed)
+    return status_;
+  chunk_ = data;
+  char const* current = data;
+  char const* end = data + length;
+  while (current != end &&
+         (status_ == needMoreInput || status_ == complete)) {
+    switch (state_) {
+    case stateString:
+      current = readString(current, end);
+      break;
+    case stateEscape:
+      current = readEscape(current);
+      break;
+    case stateUnicode:
+      current = readUnicode(current);
+      break;
+    case stateSurrogateBackslash:
+    case stateSurrogateU:
+      if (*current != (state_ == stateSurrogateBackslash ? '\\' : 'u')) {
+        fail("additional six characters expected to parse unicode surrogate "
+             "pair.",
+             current);
+        break;
+      }
+      if (state_ == stateSurrogateU) {
+        unicode_ = 0;
+        matched_ = 0;
+        state_ = stateUnicode;
+      } else {
+        state_ = stateSurrogateU;
+      }
+      ++current;
+      break;
+    case stateNumber: {
+      char const* start = current;
+      while (current != end && isNumberCharacter(*current))
+        ++current;
+      buffer_.append(start, current);
+      // the number only ends at the next character, maybe in a later chunk.
+      if (current != end)
+        endNumber(current);
+      break;
+    }
+    case stateLiteral:
+      if (*current != literal_[matched_]) {
+        fail("Syntax error: value, object or array expected.", current);
+        break;
+      }
+      ++current;
+      if (++matched_ == literalLength_) {
+        if (literal_[0] == 'n')
+          emit(handler_.onNull());
+        else
+          emit(handler_.onBool(literal_[0] == 't'));
+        endValue();
+      }
+      break;
+    default:
+      current = skipWhitespace(current, end);
+      if (current != end)
+        current = readValue(current);
+      break;
+    }
+  }
+  consumed_ += static_cast<size_t>(current - data);
+  chunk_ = 0;
+  return status_;
+}
+
+StreamReader::Status StreamReader::finish() {
+  if (status_ != needMoreInput)
+    return status_;
+  if (state_ == stateNumber)
+    endNumber(0);
+  if (status_ == needMoreInput)
+    fail("Unexpected end of input.", 0);
+  return status_;
+}
+
+char const* StreamReader::readValue(char const* current) {
+  char const c = *current;
+  switch (state_) {
+  case stateDone:
+    fail("Extra data after the root value.", current);
+    return current;
+  case stateColon:
+    if (c != ':') {
+      fail("Missing ':' after object member name", current);
+      return current;
+    }
+    state_ = stateValue;
+    return current + 1;
+  case stateCommaOrEnd: {
+    char const type = stack_[stack_.size() - 1];
+    if (c == ',') {
+      state_ = type == '{' ? stateKey : stateValue;
+      return current + 1;
+    }
+    if (c == (type == '{' ? '}' : ']')) {
+      endContainer(type);
+      return current + 1;
+    }
+    fail(type == '{' ? "Missing ',' or '}' in object declaration"
+                     : "Missing ',' or ']' in array declaration",
+         current);
+    return current;
+  }
+  case stateObjectFirst:
+    if (c == '}') {
+      endContainer('{');
+      return current + 1;
+    }
+    // fall through
+  case stateKey:
+    if (c != '"') {
+      fail("Missing '}' or object member name", current);
+      return current;
+    }
+    isKey_ = true;
+    buffer_.clear();
+    state_ = stateString;
+    return current + 1;
+  case stateArrayFirst:
+    if (c == ']') {
+      endContainer('[');
+      return current + 1;
+    }
+    break;
+  default:
+    break;
+  }
+
+  switch (c) {
+  case '{':
+  case '[':
+    if (stack_.size() >= stackLimit_) {
+      fail("Exceeded stackLimit in readValue().", current);
+      return current;
+    }
+    stack_ += c;
+    state_ = c == '{' ? stateObjectFirst : stateArrayFirst;
+    emit(c == '{' ? handler_.onStartObject() : handler_.onStartArray());
+    return current + 1;
+  case '"':
+    isKey_ = false;
+    buffer_.clear();
+    state_ = stateString;
+    return current + 1;
+  case 't':
+  case 'f':
+  case 'n':
+    literal_ = c == 't' ? "true" : c == 'f' ? "false" : "null";
+    literalLength_ = static_cast<unsigned>(strlen(literal_));
+    matched_ = 0;
+    state_ = stateLiteral;
+    return current;
+  default:
+    if (c == '-' || isDigit(c)) {
+      buffer_.clear();
+      state_ = stateNumber;
+      return current;
+    }
+    fail("Syntax error: value, object or array expected.", current);
+    return current;
+  }
+}
+
+char const* StreamReader::readString(char const* current, char const* end) {
+  char const* stop = findQuoteOrEscape(current, end, '"');
+  if (stop == end) {
+    buffer_.append(current, end);
+    return end;
+  }
+  if (*stop == '\\') {
+    buffer_.append(current, stop);
+    state_ = stateEscape;
+    return stop + 1;
+  }
+  if (buffer_.empty()) {
+    // the whole string is in this chunk and has no escape.
+    endString(current, stop);
+  } else {
+    buffer_.append(current, stop);
+    endString(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+  return stop + 1;
+}
+
+char const* StreamReader::readEscape(char const* current) {
+  char decoded;
+  switch (*current) {
+  case '"':
+    decoded = '"';
+    break;
+  case '/':
+    decoded = '/';
+    break;
+  case '\\':
+    decoded = '\\';
+    break;
+  case 'b':
+    decoded = '\b';
+    break;
+  case 'f':
+    decoded = '\f';
+    break;
+  case 'n':
+    decoded = '\n';
+    break;
+  case 'r':
+    decoded = '\r';
+    break;
+  case 't':
+    decoded = '\t';
+    break;
+  case 'u':
+    unicode_ = 0;
+    matched_ = 0;
+    state_ = stateUnicode;
+    return current + 1;
+  default:
+    fail("Bad escape sequence in string", current);
+    return current;
+  }
+  buffer_ += decoded;
+  state_ = stateString;
+  return current + 1;
+}
+
+char const* StreamReader::readUnicode(char const* current) {
+  char const c = *current;
+  unsigned digit;
+  if (c >= '0' && c <= '9')
+    digit = static_cast<unsigned>(c - '0');
+  else if (c >= 'a' && c <= 'f')
+    digit = static_cast<unsigned>(c - 'a' + 10);
+  else if (c >= 'A' && c <= 'F')
+    digit = static_cast<unsigned>(c - 'A' + 10);
+  else {
+    fail("Bad unicode escape sequence in string: four digits expected.",
+         current);
+    return current;
+  }
+  unicode_ = unicode_ * 16 + digit;
+  if (++matched_ < 4)
+    return current + 1;
+  if (highSurrogate_) {
+    if (unicode_ < 0xDC00 || unicode_ > 0xDFFF) {
+      fail("expecting another \\u token to begin the second half of a "
+           "unicode surrogate pair",
+           current);
+      return current;
+    }
+    buffer_ += codePointToUTF8(0x10000 + ((highSurrogate_ & 0x3FF) << 10) +
+                               (unicode_ & 0x3FF));
+    highSurrogate_ = 0;
+  } else if (unicode_ >= 0xD800 && unicode_ <= 0xDBFF) {
+    highSurrogate_ = unicode_;
+    state_ = stateSurrogateBackslash;
+    return current + 1;
+  } else {
+    buffer_ += codePointToUTF8(unicode_);
+  }
+  state_ = stateString;
+  return current + 1;
+}
+
+bool StreamReader::endString(char const* begin, char const* end) {
+  if (isKey_) {
+    state_ = stateColon;
+    return emit(handler_.onKey(begin, end));
+  }
+  endValue();
+  return emit(handler_.onString(begin, end));
+}
+
+bool StreamReader::endNumber(char const* current) {
+  char const* begin = buffer_.data();
+  char const* end = begin + buffer_.size();
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  char const* digits = begin + (*begin == '-' ? 1 : 0);
+  char const* p = digits;
+  bool isDouble = false;
+  bool valid = p != end;
+  if (valid && *p == '0')
+    ++p;
+  else if (valid && isDigit(*p))
+    while (p != end && isDigit(*p))
+      ++p;
+  else
+    valid = false;
+  if (valid && p != end && *p == '.') {
+    isDouble = true;
+    valid = ++p != end && isDigit(*p);
+    while (p != end && isDigit(*p))
+      ++p;
+  }
+  if (valid && p != end && (*p == 'e' || *p == 'E')) {
+    isDouble = true;
+    if (++p != end && (*p == '+' || *p == '-'))
+      ++p;
+    valid = p != end && isDigit(*p);
+    while (p != end && isDigit(*p))
+      ++p;
+  }
+  if (!valid || p != end) {
+    fail(("'" + buffer_ + "' is not a number.").c_str(), current);
+    return false;
+  }
+
+  endValue();
+  if (!isDouble) {
+    // Same as Reader::decodeNumber(), integers that do not fit are decoded
+    // as a double.
+    bool const isNegative = digits != begin;
+    LargestUInt const maxIntegerValue =
+        isNegative ? LargestUInt(Value::maxLargestInt) + 1
+                   : Value::maxLargestUInt;
+    LargestUInt const threshold = maxIntegerValue / 10;
+    LargestUInt value = 0;
+    for (p = digits; p != end; ++p) {
+      Value::UInt digit(static_cast<Value::UInt>(*p - '0'));
+      if (value >= threshold &&
+          (value > threshold || p + 1 != end ||
+           digit > maxIntegerValue % 10)) {
+        isDouble = true;
+        break;
+      }
+      value = value * 10 + digit;
+    }
+    if (!isDouble) {
+      if (isNegative && value == maxIntegerValue)
+        return emit(handler_.onInt(Value::minLargestInt));
+      if (isNegative)
+        return emit(handler_.onInt(-LargestInt(value)));
+      if (value <= LargestUInt(Value::maxLargestInt))
+        return emit(handler_.onInt(LargestInt(value)));
+      return emit(handler_.onUInt(value));
+    }
+  }
+  double value = 0;
+  if (!decodeDoubleFastPath(begin, end, value)) {
+    JSONCPP_ISTRINGSTREAM is(buffer_);
+    if (!(is >> value)) {
+      fail(("'" + buffer_ + "' is not a number.").c_str(), current);
+      return false;
+    }
+  }
+  return emit(handler_.onDouble(value));
+}
+
+bool StreamReader::endContainer(char type) {
+  stack_.resize(stack_.size() - 1);
+  endValue();
+  return emit(type == '{' ? handler_.onEndObject() : handler_.onEndArray());
+}
+
+void StreamReader::endValue() {
+  if (!stack_.empty()) {
+    state_ = stateCommaOrEnd;
+    return;
+  }
+  state_ = stateDone;
+  if (status_ == needMoreInput)
+    status_ = complete;
+}
+
+bool StreamReader::emit(bool proceed) {
+  if (!proceed && status_ != failed)
+    status_ = stopped;
+  return proceed;
+}
+
+bool StreamReader::fail(char const* message, char const* current) {
+  // |current| is null when the input has ended.
+  size_t const offset =
+      consumed_ + (current ? static_cast<size_t>(current - chunk_) : 0);
+  JSONCPP_OSTRINGSTREAM oss;
+  oss << "* Offset " << offset << "\n  " << message << "\n";
+  error_ = oss.str();
+  status_ = failed;
+  return false;
+}
+
 //////////////////////////////////
 // global functions
 
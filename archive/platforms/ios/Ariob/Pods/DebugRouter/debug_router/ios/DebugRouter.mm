@@ -178,7 +178,7 @@ class MessageHandlerDelegate : public debugrouter::core::DebugRouterMessageHandl
       if (it->isConvertibleTo(Json::stringValue)) {
         valueStr = it->asString();
       } else {
-        valueStr = it->toStyledString();
+        valueStr = Json::toCompactString(*it);
       }
       NSString *value = [NSString stringWithCString:valueStr.c_str()
                                            encoding:[NSString defaultCStringEncoding]];
@@ -6,6 +6,7 @@
 #import "DebugRouter.h"
 
 #include <unordered_map>
+#include "debug_router/native/core/debug_router_core.h"
 #include "debug_router/native/processor/message_assembler.h"
 #include "json/reader.h"
 
@@ -114,11 +115,8 @@
     md[[key UTF8String]] = [metadata[key] floatValue];
   }
 
-  auto cdp_data = debugrouter::processor::MessageAssembler::AssembleScreenCastFrame(
+  debugrouter::core::DebugRouterCore::GetInstance().SendScreenCastFrame(
       self.session_id, [data UTF8String], md);
-  NSString *msg = [NSString stringWithUTF8String:cdp_data.c_str()];
-
-  [self sendDataAsync:msg WithType:@"CDP"];
 }
 
 @end
@@ -0,0 +1,466 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/base/base64.h"
+
+#include <cstring>
+
+// The NEON kernels are off until an arm64 build runs base64_unittest.cc,
+// define this to 1 to use them.
+#ifndef DEBUGROUTER_BASE64_NEON
+#define DEBUGROUTER_BASE64_NEON 0
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BASE64_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON) && DEBUGROUTER_BASE64_NEON
+#define BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace debugrouter {
+namespace base {
+
+namespace {
+
+constexpr char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char kPadding = '=';
+constexpr uint8_t kInvalid = 0xff;
+
+struct DecodeTable {
+  uint8_t values[256];
+
+  DecodeTable() {
+    memset(values, kInvalid, sizeof(values));
+    for (uint8_t i = 0; i < 64; ++i) {
+      values[static_cast<uint8_t>(kAlphabet[i])] = i;
+    }
+  }
+};
+
+const uint8_t *DecodeValues() {
+  static const DecodeTable table;
+  return table.values;
+}
+
+// The vector kernels consume whole blocks from the front of the input and
+// return how much they consumed, the scalar code finishes the rest. A decode
+// kernel stops at the first block holding a character out of the alphabet,
+// padding included.
+using EncodeBlocks = size_t (*)(const uint8_t *src, size_t size, char *dst);
+using DecodeBlocks = size_t (*)(const char *src, size_t size, uint8_t *dst);
+
+size_t EncodeScalar(const uint8_t *src, size_t size, char *dst) {
+  char *out = dst;
+  size_t i = 0;
+  for (; i + 3 <= size; i += 3) {
+    uint32_t word = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+    out[0] = kAlphabet[word >> 18];
+    out[1] = kAlphabet[(word >> 12) & 0x3f];
+    out[2] = kAlphabet[(word >> 6) & 0x3f];
+    out[3] = kAlphabet[word & 0x3f];
+    out += 4;
+  }
+  if (i < size) {
+    uint32_t word = src[i] << 16;
+    if (i + 1 < size) {
+      word |= src[i + 1] << 8;
+    }
+    out[0] = kAlphabet[word >> 18];
+    out[1] = kAlphabet[(word >> 12) & 0x3f];
+    out[2] = i + 1 < size ? kAlphabet[(word >> 6) & 0x3f] : kPadding;
+    out[3] = kPadding;
+    out += 4;
+  }
+  return out - dst;
+}
+
+// |size| is a multiple of 4.
+bool DecodeScalar(const char *src, size_t size, uint8_t *dst,
+                  size_t &out_size) {
+  const uint8_t *values = DecodeValues();
+  uint8_t *out = dst;
+  for (size_t i = 0; i < size; i += 4) {
+    uint8_t a = values[static_cast<uint8_t>(src[i])];
+    uint8_t b = values[static_cast<uint8_t>(src[i + 1])];
+    uint8_t c = values[static_cast<uint8_t>(src[i + 2])];
+    uint8_t d = values[static_cast<uint8_t>(src[i + 3])];
+    if (a == kInvalid || b == kInvalid) {
+      return false;
+    }
+    if (c != kInvalid && d != kInvalid) {
+      out[0] = static_cast<uint8_t>((a << 2) | (b >> 4));
+      out[1] = static_cast<uint8_t>((b << 4) | (c >> 2));
+      out[2] = static_cast<uint8_t>((c << 6) | d);
+      out += 3;
+      continue;
+    }
+    // padding, only allowed in the last quartet.
+    if (i + 4 != size || src[i + 3] != kPadding) {
+      return false;
+    }
+    *out++ = static_cast<uint8_t>((a << 2) | (b >> 4));
+    if (src[i + 2] != kPadding) {
+      if (c == kInvalid) {
+        return false;
+      }
+      *out++ = static_cast<uint8_t>((b << 4) | (c >> 2));
+    }
+  }
+  out_size = out - dst;
+  return true;
+}
+
+#if defined(BASE64_X86)
+
+// After W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using
+// AVX2 Instructions". Every 128 bit lane turns 12 bytes into 16 characters
+// and back, the AVX2 kernels run two lanes at once.
+
+__attribute__((target("ssse3"))) inline __m128i EncodeLane(__m128i in) {
+  in = _mm_shuffle_epi8(
+      in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  __m128i a = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                              _mm_set1_epi32(0x04000040));
+  __m128i b = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                              _mm_set1_epi32(0x01000010));
+  __m128i indices = _mm_or_si128(a, b);
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+  __m128i slots = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  __m128i letters = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  slots = _mm_or_si128(slots, _mm_and_si128(letters, _mm_set1_epi8(13)));
+  const __m128i shifts = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  return _mm_add_epi8(_mm_shuffle_epi8(shifts, slots), indices);
+}
+
+__attribute__((target("avx2"))) inline __m256i EncodeLanes(__m256i in) {
+  in = _mm256_shuffle_epi8(
+      in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                           1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  __m256i a =
+      _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                         _mm256_set1_epi32(0x04000040));
+  __m256i b =
+      _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                         _mm256_set1_epi32(0x01000010));
+  __m256i indices = _mm256_or_si256(a, b);
+  __m256i slots = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  __m256i letters = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  slots =
+      _mm256_or_si256(slots, _mm256_and_si256(letters, _mm256_set1_epi8(13)));
+  const __m256i shifts = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  return _mm256_add_epi8(_mm256_shuffle_epi8(shifts, slots), indices);
+}
+
+// Sets |valid| to 0xff for the characters of the alphabet, 0 otherwise.
+__attribute__((target("ssse3"))) inline __m128i DecodeLane(__m128i in,
+                                                           __m128i &valid) {
+  __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                                _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), in));
+  __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                                _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), in));
+  __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                                _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+  __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+  __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+  valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                       _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+  __m128i shift = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                   _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                   _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                                _mm_and_si128(slash,
+                                              _mm_set1_epi8(63 - '/')))));
+  __m128i values = _mm_add_epi8(in, shift);
+  // 00aaaaaa 00bbbbbb 00cccccc 00dddddd -> aaaaaabb bbbbcccc ccdddddd
+  __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14,
+                                               13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("avx2"))) inline __m256i DecodeLanes(__m256i in,
+                                                           __m256i &valid) {
+  __m256i upper =
+      _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+  __m256i lower =
+      _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+  __m256i digit =
+      _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+  __m256i plus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+  __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+  valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                          _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+  __m256i shift = _mm256_or_si256(
+      _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                      _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+      _mm256_or_si256(
+          _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+          _mm256_or_si256(
+              _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+')),
+              _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/')))));
+  __m256i values = _mm256_add_epi8(in, shift);
+  __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+  __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+  return _mm256_shuffle_epi8(
+      words,
+      _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3"))) size_t EncodeSsse3(const uint8_t *src,
+                                                    size_t size, char *dst) {
+  size_t i = 0;
+  // loads 16 bytes, uses 12.
+  for (; i + 16 <= size; i += 12, dst += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), EncodeLane(in));
+  }
+  return i;
+}
+
+__attribute__((target("ssse3"))) size_t DecodeSsse3(const char *src,
+                                                    size_t size,
+                                                    uint8_t *dst) {
+  size_t i = 0;
+  // stores 16 bytes, 12 of them decoded: the 8 characters left behind leave
+  // room for the other 4.
+  for (; i + 16 + 8 <= size; i += 16, dst += 12) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i valid;
+    __m128i out = DecodeLane(in, valid);
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+      break;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), out);
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) size_t EncodeAvx2(const uint8_t *src,
+                                                  size_t size, char *dst) {
+  size_t i = 0;
+  // two lanes of 12 bytes, the second loaded from src + 12.
+  for (; i + 28 <= size; i += 24, dst += 32) {
+    __m256i in = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 12)), 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), EncodeLanes(in));
+  }
+  // one last lane of 12 bytes may fit.
+  return i + EncodeSsse3(src + i, size - i, dst);
+}
+
+__attribute__((target("avx2"))) size_t DecodeAvx2(const char *src,
+                                                  size_t size, uint8_t *dst) {
+  size_t i = 0;
+  for (; i + 32 + 8 <= size; i += 32, dst += 24) {
+    __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    __m256i valid;
+    __m256i out = DecodeLanes(in, valid);
+    if (_mm256_movemask_epi8(valid) != -1) {
+      return i + DecodeSsse3(src + i, size - i, dst);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm256_castsi256_si128(out));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12),
+                     _mm256_extracti128_si256(out, 1));
+  }
+  return i + DecodeSsse3(src + i, size - i, dst);
+}
+
+#elif defined(BASE64_NEON)
+
+// vld3q/vst4q deinterleave 48 bytes into 3 vectors and interleave 4 vectors
+// of 16 characters back, so the kernels only deal with whole bytes.
+
+size_t EncodeNeon(const uint8_t *src, size_t size, char *dst) {
+  uint8x16x4_t alphabet;
+  for (int j = 0; j < 4; ++j) {
+    alphabet.val[j] =
+        vld1q_u8(reinterpret_cast<const uint8_t *>(kAlphabet) + j * 16);
+  }
+  const uint8x16_t mask = vdupq_n_u8(0x3f);
+  size_t i = 0;
+  for (; i + 48 <= size; i += 48, dst += 64) {
+    uint8x16x3_t in = vld3q_u8(src + i);
+    uint8x16x4_t indices;
+    indices.val[0] = vshrq_n_u8(in.val[0], 2);
+    indices.val[1] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+    indices.val[2] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+    indices.val[3] = vandq_u8(in.val[2], mask);
+    uint8x16x4_t out;
+    for (int j = 0; j < 4; ++j) {
+      out.val[j] = vqtbl4q_u8(alphabet, indices.val[j]);
+    }
+    vst4q_u8(reinterpret_cast<uint8_t *>(dst), out);
+  }
+  return i;
+}
+
+// Maps 16 characters to their values, setting |valid| to 0xff for the ones
+// of the alphabet.
+inline uint8x16_t DecodeVector(uint8x16_t in, uint8x16_t &valid) {
+  uint8x16_t upper =
+      vandq_u8(vcgeq_u8(in, vdupq_n_u8('A')), vcleq_u8(in, vdupq_n_u8('Z')));
+  uint8x16_t lower =
+      vandq_u8(vcgeq_u8(in, vdupq_n_u8('a')), vcleq_u8(in, vdupq_n_u8('z')));
+  uint8x16_t digit =
+      vandq_u8(vcgeq_u8(in, vdupq_n_u8('0')), vcleq_u8(in, vdupq_n_u8('9')));
+  uint8x16_t plus = vceqq_u8(in, vdupq_n_u8('+'));
+  uint8x16_t slash = vceqq_u8(in, vdupq_n_u8('/'));
+  valid = vorrq_u8(vorrq_u8(upper, lower),
+                   vorrq_u8(digit, vorrq_u8(plus, slash)));
+  uint8x16_t shift = vorrq_u8(
+      vorrq_u8(vandq_u8(upper, vdupq_n_u8(static_cast<uint8_t>(-'A'))),
+               vandq_u8(lower, vdupq_n_u8(static_cast<uint8_t>(26 - 'a')))),
+      vorrq_u8(vandq_u8(digit, vdupq_n_u8(static_cast<uint8_t>(52 - '0'))),
+               vorrq_u8(vandq_u8(plus, vdupq_n_u8(62 - '+')),
+                        vandq_u8(slash, vdupq_n_u8(63 - '/')))));
+  return vaddq_u8(in, shift);
+}
+
+size_t DecodeNeon(const char *src, size_t size, uint8_t *dst) {
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64, dst += 48) {
+    uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t *>(src + i));
+    uint8x16x4_t values;
+    uint8x16_t valid = vdupq_n_u8(0xff);
+    for (int j = 0; j < 4; ++j) {
+      uint8x16_t lane_valid;
+      values.val[j] = DecodeVector(in.val[j], lane_valid);
+      valid = vandq_u8(valid, lane_valid);
+    }
+    if (vminvq_u8(valid) != 0xff) {
+      break;
+    }
+    uint8x16x3_t out;
+    out.val[0] =
+        vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+    out.val[1] =
+        vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+    vst3q_u8(dst, out);
+  }
+  return i;
+}
+
+#endif
+
+struct Kernels {
+  EncodeBlocks encode = nullptr;
+  DecodeBlocks decode = nullptr;
+  const char *name = "scalar";
+
+  Kernels() {
+#if defined(BASE64_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      encode = EncodeAvx2;
+      decode = DecodeAvx2;
+      name = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+      encode = EncodeSsse3;
+      decode = DecodeSsse3;
+      name = "ssse3";
+    }
+#elif defined(BASE64_NEON)
+    encode = EncodeNeon;
+    decode = DecodeNeon;
+    name = "neon";
+#endif
+  }
+};
+
+const Kernels &GetKernels() {
+  static const Kernels kernels;
+  return kernels;
+}
+
+}  // namespace
+
+size_t Base64Encode(const uint8_t *data, size_t size, char *out) {
+  const Kernels &kernels = GetKernels();
+  size_t done = kernels.encode ? kernels.encode(data, size, out) : 0;
+  return done / 3 * 4 + EncodeScalar(data + done, size - done,
+                                     out + done / 3 * 4);
+}
+
+void Base64Encode(const uint8_t *data, size_t size, std::string &out) {
+  size_t offset = out.size();
+  out.resize(offset + Base64EncodedSize(size));
+  Base64Encode(data, size, &out[offset]);
+}
+
+bool Base64Decode(const char *data, size_t size, uint8_t *out,
+                  size_t &out_size) {
+  if (size % 4 != 0) {
+    return false;
+  }
+  const Kernels &kernels = GetKernels();
+  size_t done = kernels.decode ? kernels.decode(data, size, out) : 0;
+  size_t tail_size = 0;
+  if (!DecodeScalar(data + done, size - done, out + done / 4 * 3,
+                    tail_size)) {
+    return false;
+  }
+  out_size = done / 4 * 3 + tail_size;
+  return true;
+}
+
+bool Base64Decode(const char *data, size_t size, std::string &out) {
+  size_t offset = out.size();
+  out.resize(offset + Base64DecodedMaxSize(size));
+  size_t decoded = 0;
+  if (!Base64Decode(data, size, reinterpret_cast<uint8_t *>(&out[offset]),
+                    decoded)) {
+    out.resize(offset);
+    return false;
+  }
+  out.resize(offset + decoded);
+  return true;
+}
+
+const char *Base64Implementation() { return GetKernels().name; }
+
+void Base64StreamEncoder::Append(const uint8_t *data, size_t size) {
+  while (carry_size_ > 0 && carry_size_ < 3 && size > 0) {
+    carry_[carry_size_++] = *data++;
+    --size;
+  }
+  if (carry_size_ == 3) {
+    Base64Encode(carry_, 3, out_);
+    carry_size_ = 0;
+  }
+  size_t whole = size / 3 * 3;
+  Base64Encode(data, whole, out_);
+  for (size_t i = whole; i < size; ++i) {
+    carry_[carry_size_++] = data[i];
+  }
+}
+
+void Base64StreamEncoder::Finish() {
+  Base64Encode(carry_, carry_size_, out_);
+  carry_size_ = 0;
+}
+
+}  // namespace base
+}  // namespace debugrouter
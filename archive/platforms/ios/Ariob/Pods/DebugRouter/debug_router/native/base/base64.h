@@ -0,0 +1,60 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_BASE_BASE64_H_
+#define DEBUGROUTER_NATIVE_BASE_BASE64_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace debugrouter {
+namespace base {
+
+/*
+ * Standard base64 (RFC 4648) with padding, the output of modp_b64.
+ *
+ * Blocks are processed with AVX2 or SSSE3 on x86, picked at runtime, and
+ * with NEON on arm64 when built with DEBUGROUTER_BASE64_NEON=1. Whatever
+ * the vector code leaves, the tail or a block holding padding or an invalid
+ * character, goes through the scalar code.
+ * Also what BaseDevtool encodes its compressed CDP payloads with.
+ */
+inline size_t Base64EncodedSize(size_t size) { return (size + 2) / 3 * 4; }
+inline size_t Base64DecodedMaxSize(size_t size) { return size / 4 * 3; }
+
+// Writes Base64EncodedSize(size) characters to |out|, returns their count.
+size_t Base64Encode(const uint8_t *data, size_t size, char *out);
+// Appends to |out|.
+void Base64Encode(const uint8_t *data, size_t size, std::string &out);
+
+// Writes at most Base64DecodedMaxSize(size) bytes to |out|. Returns false if
+// |data| is not a padded base64 text, |out| then holds garbage.
+bool Base64Decode(const char *data, size_t size, uint8_t *out,
+                  size_t &out_size);
+// Appends to |out|, which is left unchanged on failure.
+bool Base64Decode(const char *data, size_t size, std::string &out);
+
+// "avx2", "ssse3", "neon" or "scalar", the code used on this cpu.
+const char *Base64Implementation();
+
+// Encodes bytes arriving in pieces of any size as if they came at once.
+class Base64StreamEncoder {
+ public:
+  explicit Base64StreamEncoder(std::string &out) : out_(out) {}
+
+  void Append(const uint8_t *data, size_t size);
+  // Writes the last bytes and the padding.
+  void Finish();
+
+ private:
+  std::string &out_;
+  uint8_t carry_[3];
+  size_t carry_size_ = 0;
+};
+
+}  // namespace base
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_BASE_BASE64_H_
@@ -0,0 +1,89 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "debug_router/native/base/base64.h"
+
+namespace debugrouter {
+namespace base {
+
+namespace {
+
+constexpr char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// A plain table loop, what modp_b64 does for every block. The tail is left
+// out, it does not weigh at these sizes.
+void ScalarEncode(const std::string &data, std::string &out) {
+  out.resize((data.size() + 2) / 3 * 4);
+  const uint8_t *src = reinterpret_cast<const uint8_t *>(data.data());
+  char *dst = &out[0];
+  size_t i = 0;
+  for (; i + 3 <= data.size(); i += 3, dst += 4) {
+    uint32_t word = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+    dst[0] = kAlphabet[word >> 18];
+    dst[1] = kAlphabet[(word >> 12) & 0x3f];
+    dst[2] = kAlphabet[(word >> 6) & 0x3f];
+    dst[3] = kAlphabet[word & 0x3f];
+  }
+}
+
+// Compressed payloads and JPEG frames look random to the codec.
+std::string RandomBytes(size_t size) {
+  std::mt19937 random(1);
+  std::string data(size, '\0');
+  for (char &c : data) {
+    c = static_cast<char>(random());
+  }
+  return data;
+}
+
+}  // namespace
+
+static void BM_Base64EncodeScalar(benchmark::State &state) {
+  std::string data = RandomBytes(state.range(0));
+  std::string out;
+  for (auto _ : state) {
+    ScalarEncode(data, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Base64EncodeScalar)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+static void BM_Base64Encode(benchmark::State &state) {
+  std::string data = RandomBytes(state.range(0));
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    Base64Encode(reinterpret_cast<const uint8_t *>(data.data()), data.size(),
+                 out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetLabel(Base64Implementation());
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Base64Encode)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+static void BM_Base64Decode(benchmark::State &state) {
+  std::string data = RandomBytes(state.range(0));
+  std::string text;
+  Base64Encode(reinterpret_cast<const uint8_t *>(data.data()), data.size(),
+               text);
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    Base64Decode(text.data(), text.size(), out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetLabel(Base64Implementation());
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Base64Decode)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+}  // namespace base
+}  // namespace debugrouter
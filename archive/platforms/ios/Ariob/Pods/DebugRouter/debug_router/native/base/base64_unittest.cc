@@ -0,0 +1,174 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/base/base64.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace base {
+
+namespace {
+
+const std::string kAlphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// One quartet at a time, the way RFC 4648 reads. Only the headers of
+// modp_b64 are in the tree, so it can't serve as the reference.
+std::string ReferenceEncode(const std::string &data) {
+  std::string out;
+  for (size_t i = 0; i < data.size(); i += 3) {
+    size_t left = data.size() - i;
+    uint32_t word = static_cast<uint8_t>(data[i]) << 16;
+    if (left > 1) {
+      word |= static_cast<uint8_t>(data[i + 1]) << 8;
+    }
+    if (left > 2) {
+      word |= static_cast<uint8_t>(data[i + 2]);
+    }
+    out += kAlphabet[word >> 18];
+    out += kAlphabet[(word >> 12) & 0x3f];
+    out += left > 1 ? kAlphabet[(word >> 6) & 0x3f] : '=';
+    out += left > 2 ? kAlphabet[word & 0x3f] : '=';
+  }
+  return out;
+}
+
+bool ReferenceDecode(const std::string &text, std::string &out) {
+  out.clear();
+  if (text.size() % 4 != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < text.size(); i += 4) {
+    size_t padding = 0;
+    if (i + 4 == text.size() && text[i + 3] == '=') {
+      padding = text[i + 2] == '=' ? 2 : 1;
+    }
+    uint32_t word = 0;
+    for (size_t j = 0; j < 4; ++j) {
+      size_t value = 0;
+      if (j < 4 - padding) {
+        value = kAlphabet.find(text[i + j]);
+        if (value == std::string::npos) {
+          return false;
+        }
+      }
+      word = (word << 6) | static_cast<uint32_t>(value);
+    }
+    out += static_cast<char>(word >> 16);
+    if (padding < 2) {
+      out += static_cast<char>(word >> 8);
+    }
+    if (padding < 1) {
+      out += static_cast<char>(word);
+    }
+  }
+  return true;
+}
+
+std::string RandomBytes(std::mt19937 &random, size_t size) {
+  std::string data(size, '\0');
+  for (char &c : data) {
+    c = static_cast<char>(random());
+  }
+  return data;
+}
+
+// Sizes around the 12, 24, 48 and 64 byte blocks of the vector kernels.
+size_t RandomSize(std::mt19937 &random) {
+  return random() % 4 == 0 ? random() % 4096 : random() % 200;
+}
+
+}  // namespace
+
+// Whatever Base64Implementation() picked on this cpu must write what the
+// reference writes, from any alignment.
+TEST(Base64Test, EncodeMatchesReference) {
+  std::mt19937 random(20250301);
+  for (int i = 0; i < 20000; ++i) {
+    std::string data = RandomBytes(random, RandomSize(random) + 16);
+    size_t offset = random() % 16;
+    std::string slice = data.substr(offset);
+    std::string out = "prefix";
+    Base64Encode(reinterpret_cast<const uint8_t *>(data.data()) + offset,
+                 slice.size(), out);
+    ASSERT_EQ(out, "prefix" + ReferenceEncode(slice))
+        << Base64Implementation() << " size " << slice.size();
+  }
+}
+
+TEST(Base64Test, DecodeRoundTrips) {
+  std::mt19937 random(7);
+  for (int i = 0; i < 20000; ++i) {
+    std::string data = RandomBytes(random, RandomSize(random));
+    std::string text = ReferenceEncode(data);
+    std::string out = "prefix";
+    ASSERT_TRUE(Base64Decode(text.data(), text.size(), out)) << text;
+    ASSERT_EQ(out, "prefix" + data) << Base64Implementation();
+  }
+}
+
+// Valid texts with a few characters replaced, by padding, characters next
+// to the alphabet or bytes above 0x7f, must be accepted or rejected as the
+// reference does, and decode to the same bytes when accepted.
+TEST(Base64Test, DecodeMatchesReferenceOnCorruptInput) {
+  const char kNoiseChars[] = "=@[`{/+09AZaz\0\x7f\x80\xff-_ \n";
+  const std::string kNoise(kNoiseChars, sizeof(kNoiseChars) - 1);
+  std::mt19937 random(99);
+  for (int i = 0; i < 50000; ++i) {
+    std::string text =
+        ReferenceEncode(RandomBytes(random, RandomSize(random)));
+    if (text.empty()) {
+      continue;
+    }
+    int changes = 1 + random() % 3;
+    for (int j = 0; j < changes; ++j) {
+      // often near the end, where padding is allowed.
+      size_t position = random() % 2 ? random() % text.size()
+                                     : text.size() - 1 - random() % 4;
+      text[position] = kNoise[random() % kNoise.size()];
+    }
+    std::string expected;
+    bool valid = ReferenceDecode(text, expected);
+    std::string out = "prefix";
+    ASSERT_EQ(Base64Decode(text.data(), text.size(), out), valid) << text;
+    ASSERT_EQ(out, valid ? "prefix" + expected : "prefix") << text;
+  }
+}
+
+TEST(Base64Test, RejectsMalformedText) {
+  std::string out;
+  for (const char *text : {"A", "AB", "ABC", "A===", "AB=A", "A=B=", "====",
+                           "AB==AB==", "AB\nC", "ABCD="}) {
+    EXPECT_FALSE(Base64Decode(text, strlen(text), out)) << text;
+    EXPECT_TRUE(out.empty()) << text;
+  }
+  EXPECT_TRUE(Base64Decode("", 0, out));
+  EXPECT_TRUE(out.empty());
+}
+
+TEST(Base64Test, StreamEncoderMatchesOneShot) {
+  std::mt19937 random(3);
+  for (int i = 0; i < 5000; ++i) {
+    std::string data = RandomBytes(random, RandomSize(random));
+    std::string out;
+    Base64StreamEncoder encoder(out);
+    for (size_t offset = 0; offset < data.size();) {
+      size_t piece = std::min<size_t>(data.size() - offset, random() % 70);
+      encoder.Append(reinterpret_cast<const uint8_t *>(data.data()) + offset,
+                     piece);
+      offset += piece;
+    }
+    encoder.Finish();
+    ASSERT_EQ(out, ReferenceEncode(data));
+  }
+}
+
+}  // namespace base
+}  // namespace debugrouter
@@ -0,0 +1,66 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_BASE_COPY_ON_WRITE_H_
+#define DEBUGROUTER_NATIVE_BASE_COPY_ON_WRITE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace debugrouter {
+namespace base {
+
+/*
+ * A value read far more often than written, registries of handlers and
+ * listeners walked for every message.
+ *
+ * Readers take an immutable snapshot, which costs a reference count and no
+ * allocation, and may keep it while the value changes under them: a handler
+ * removed during a dispatch still gets that message. Writers copy the value,
+ * modify the copy and publish it, readers only ever wait for the pointer
+ * swap. Writers are serialized among themselves. A snapshot is freed with its
+ * last reader.
+ *
+ * Reads are not lock-free: libc++ and libstdc++ implement the atomic
+ * shared_ptr functions with a small pool of locks picked by address. Load
+ * holds one only for the reference count, and shares it with the store of
+ * Update and with any shared_ptr hashed to the same lock, never with the
+ * copy or the update itself.
+ */
+template <typename T>
+class CopyOnWrite {
+ public:
+  CopyOnWrite() : value_(std::make_shared<const T>()) {}
+
+  CopyOnWrite(const CopyOnWrite &) = delete;
+  CopyOnWrite &operator=(const CopyOnWrite &) = delete;
+
+  std::shared_ptr<const T> Load() const {
+    return std::atomic_load_explicit(&value_, std::memory_order_acquire);
+  }
+
+  // Calls |update| with a copy of the value, which is published if it
+  // returns true.
+  template <typename Function>
+  void Update(Function update) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    // only writers store, so value_ can't change while it is copied.
+    auto copy = std::make_shared<T>(*value_);
+    if (update(*copy)) {
+      std::atomic_store_explicit(&value_,
+                                 std::shared_ptr<const T>(std::move(copy)),
+                                 std::memory_order_release);
+    }
+  }
+
+ private:
+  std::shared_ptr<const T> value_;
+  std::mutex write_mutex_;
+};
+
+}  // namespace base
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_BASE_COPY_ON_WRITE_H_
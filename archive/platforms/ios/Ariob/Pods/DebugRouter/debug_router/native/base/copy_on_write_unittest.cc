@@ -0,0 +1,127 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/base/copy_on_write.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace base {
+
+TEST(CopyOnWriteTest, StartsEmptyAndPublishesUpdates) {
+  CopyOnWrite<std::map<int, int>> value;
+  EXPECT_TRUE(value.Load()->empty());
+
+  value.Update([](std::map<int, int> &map) {
+    map[1] = 10;
+    return true;
+  });
+  std::shared_ptr<const std::map<int, int>> snapshot = value.Load();
+  ASSERT_EQ(snapshot->size(), 1u);
+  EXPECT_EQ(snapshot->at(1), 10);
+
+  // a declined update publishes nothing.
+  value.Update([](std::map<int, int> &map) {
+    map[2] = 20;
+    return false;
+  });
+  EXPECT_EQ(value.Load(), snapshot);
+}
+
+TEST(CopyOnWriteTest, SnapshotIsUnchangedByLaterUpdates) {
+  CopyOnWrite<std::vector<int>> value;
+  value.Update([](std::vector<int> &vector) {
+    vector.push_back(1);
+    return true;
+  });
+  std::shared_ptr<const std::vector<int>> snapshot = value.Load();
+  value.Update([](std::vector<int> &vector) {
+    vector.clear();
+    vector.push_back(2);
+    return true;
+  });
+  EXPECT_EQ(*snapshot, std::vector<int>({1}));
+  EXPECT_EQ(*value.Load(), std::vector<int>({2}));
+
+  // the snapshot outlives the value it came from.
+  std::unique_ptr<CopyOnWrite<std::vector<int>>> owner(
+      new CopyOnWrite<std::vector<int>>());
+  owner->Update([](std::vector<int> &vector) {
+    vector.assign(100, 3);
+    return true;
+  });
+  snapshot = owner->Load();
+  owner.reset();
+  EXPECT_EQ(snapshot->size(), 100u);
+}
+
+TEST(CopyOnWriteTest, SnapshotsStayValidAcrossConcurrentUpdates) {
+  const int kWriters = 4;
+  const int kUpdates = 500;
+  const int kReaders = 4;
+  // every published vector holds 0, 1, ..., n-1, so a reader can tell a
+  // torn or freed snapshot from a valid one.
+  CopyOnWrite<std::vector<int>> value;
+  std::atomic<bool> writing(true);
+  std::atomic<int> invalid(0);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&]() {
+      size_t last_size = 0;
+      do {
+        std::shared_ptr<const std::vector<int>> snapshot = value.Load();
+        const size_t size = snapshot->size();
+        // writers only append, so the size never goes back.
+        if (size < last_size) {
+          ++invalid;
+        }
+        last_size = size;
+        // updates published meanwhile leave the snapshot as it was.
+        std::this_thread::yield();
+        for (size_t j = 0; j < snapshot->size(); ++j) {
+          if ((*snapshot)[j] != static_cast<int>(j)) {
+            ++invalid;
+            break;
+          }
+        }
+        if (snapshot->size() != size) {
+          ++invalid;
+        }
+      } while (writing);
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int i = 0; i < kWriters; ++i) {
+    writers.emplace_back([&]() {
+      for (int j = 0; j < kUpdates; ++j) {
+        value.Update([](std::vector<int> &vector) {
+          vector.push_back(static_cast<int>(vector.size()));
+          return true;
+        });
+      }
+    });
+  }
+  for (std::thread &writer : writers) {
+    writer.join();
+  }
+  writing = false;
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(invalid.load(), 0);
+  // no update was lost to a concurrent one.
+  EXPECT_EQ(value.Load()->size(), static_cast<size_t>(kWriters * kUpdates));
+}
+
+}  // namespace base
+}  // namespace debugrouter
@@ -0,0 +1,117 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_BASE_TRANSPORT_STATS_H_
+#define DEBUGROUTER_NATIVE_BASE_TRANSPORT_STATS_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace debugrouter {
+namespace base {
+
+/*
+ * Measures the outbound queue of a transport: what waits in it, how long
+ * messages wait, and how fast the writer drains it.
+ *
+ * Throughput is measured over the time the writer spends on each message,
+ * from the moment it could start on it (queued, or done with the previous
+ * message) to the moment it is written, so idle links are not mistaken for
+ * slow ones. Both rates are exponentially weighted moving averages.
+ */
+class TransportStats {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Snapshot {
+    size_t queued_bytes = 0;
+    size_t queued_messages = 0;
+    // time spent in the queue by the messages sent lately.
+    std::chrono::milliseconds queue_delay{0};
+    // bytes per second, 0 until the first message is sent.
+    double throughput = 0;
+
+    // Time the messages queued now will wait, at the current throughput.
+    std::chrono::milliseconds ExpectedDelay() const {
+      if (throughput <= 0) {
+        return queue_delay;
+      }
+      auto drain = std::chrono::milliseconds(
+          static_cast<int64_t>(queued_bytes * 1000.0 / throughput));
+      return std::max(queue_delay, drain);
+    }
+  };
+
+  // Returns the time to pass to OnSent() once the message is written.
+  Clock::time_point OnQueued(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.queued_bytes += bytes;
+    ++snapshot_.queued_messages;
+    return Clock::now();
+  }
+
+  void OnSent(size_t bytes, Clock::time_point queued_time) {
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.queued_bytes -= std::min(snapshot_.queued_bytes, bytes);
+    if (snapshot_.queued_messages > 0) {
+      --snapshot_.queued_messages;
+    }
+    double delay = std::chrono::duration<double, std::milli>(
+                       now - queued_time)
+                       .count();
+    queue_delay_ = Average(queue_delay_, delay);
+    snapshot_.queue_delay =
+        std::chrono::milliseconds(static_cast<int64_t>(queue_delay_));
+    Clock::time_point begin = std::max(queued_time, last_sent_time_);
+    last_sent_time_ = now;
+    double seconds = std::chrono::duration<double>(now - begin).count();
+    // small messages are dominated by the syscall, not by the link.
+    if (bytes >= kMinMeasuredBytes && seconds > 0) {
+      snapshot_.throughput = Average(snapshot_.throughput, bytes / seconds);
+    }
+  }
+
+  // A message queued but given up before being written.
+  void OnDropped(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.queued_bytes -= std::min(snapshot_.queued_bytes, bytes);
+    if (snapshot_.queued_messages > 0) {
+      --snapshot_.queued_messages;
+    }
+  }
+
+  // The queue is cleared, e.g. on disconnect.
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_ = Snapshot();
+    queue_delay_ = 0;
+    last_sent_time_ = Clock::time_point();
+  }
+
+  Snapshot GetSnapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+  }
+
+ private:
+  static constexpr double kWeight = 0.2;
+  static constexpr size_t kMinMeasuredBytes = 4096;
+
+  static double Average(double average, double sample) {
+    return average <= 0 ? sample : average + kWeight * (sample - average);
+  }
+
+  std::mutex mutex_;
+  Snapshot snapshot_;
+  double queue_delay_ = 0;
+  Clock::time_point last_sent_time_;
+};
+
+}  // namespace base
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_BASE_TRANSPORT_STATS_H_
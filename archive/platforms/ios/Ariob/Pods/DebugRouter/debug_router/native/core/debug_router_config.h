@@ -14,6 +14,16 @@ namespace core {
 
 static const std::string kForbidReconnectWhenClose =
     "debugrouter_forbid_reconnect_on_close";
+// "true" dispatches the messages of each session on a serial lane of its own,
+// instead of all in order on the transport thread. Session handlers and slots
+// are then called on lane workers, several sessions at once, so only enable
+// it when they do not rely on the thread they are called on.
+static const std::string kSessionDispatchLanes =
+    "debugrouter_session_dispatch_lanes";
+// "true" moves global messages (no session) to a lane of their own, instead
+// of dispatching them on the transport thread.
+static const std::string kGlobalDispatchLane =
+    "debugrouter_global_dispatch_lane";
 
 /**
  * Store configs of DebugRouter
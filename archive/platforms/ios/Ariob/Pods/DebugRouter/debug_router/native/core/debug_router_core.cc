@@ -4,7 +4,7 @@
 
 #include "debug_router/native/core/debug_router_core.h"
 
-#include <mutex>
+#include <algorithm>
 
 #include "debug_router/native/base/no_destructor.h"
 #include "debug_router/native/core/debug_router_config.h"
@@ -17,15 +17,20 @@
 #include "debug_router/native/net/websocket_client.h"
 #include "debug_router/native/processor/message_handler.h"
 #include "debug_router/native/processor/processor.h"
+#include "debug_router/native/protocol/protocol.h"
 #include "debug_router/native/thread/debug_router_executor.h"
 #include "debug_router_state_listener.h"
 #include "json/value.h"
+#include "json/writer.h"
 
 namespace debugrouter {
 
 namespace core {
 class MessageHandlerCore : public processor::MessageHandler {
  public:
+  // all messages without a session share one lane.
+  static constexpr int64_t kGlobalLane = -1;
+
   MessageHandlerCore() {}
 
   std::string GetRoomId() override {
@@ -36,60 +41,51 @@ class MessageHandlerCore : public processor::MessageHandler {
     return DebugRouterCore::GetInstance().app_info_;
   }
 
-  std::unordered_map<int, std::string> GetSessionList() override {
-    std::unordered_map<int, std::string> session_list;
-    std::lock_guard<std::recursive_mutex> lock(
-        DebugRouterCore::GetInstance().slots_mutex_);
-    const auto &slots = DebugRouterCore::GetInstance().slots_;
-    if (!slots.empty()) {
-      for (auto it = slots.begin(); it != slots.end(); ++it) {
-        Json::Value session_info;
-        session_info["type"] = it->second->GetType();
-        session_info["url"] = it->second->GetUrl();
-        session_list[it->first] = session_info.toStyledString();
-      }
-    }
-    return session_list;
-  }
-
   std::string HandleAppAction(const std::string &method,
                               const std::string &params) override {
-    DebugRouterMessageHandler *handler =
-        DebugRouterCore::GetInstance().message_handlers_[method];
-    if (handler) {
-      LOGI("DebugRouterCore: handle exists: " << method);
-      return handler->Handle(params);
-    } else {
-      LOGI("DebugRouterCore: handle does not exists: " << method);
-      return "{\"code\":-2,\"message\":\"not implemented\"}";
-    }
+    return DebugRouterCore::GetInstance().HandleAppAction(method, params);
   }
 
   void OnMessage(const std::string &type, int session_id,
                  const std::string &message) override {
+    DebugRouterCore &core = DebugRouterCore::GetInstance();
+    const std::atomic<bool> &lanes_enabled = session_id < 0
+                                                 ? core.global_lane_enabled_
+                                                 : core.session_lanes_enabled_;
+    if (!lanes_enabled.load(std::memory_order_relaxed)) {
+      Dispatch(type, session_id, message);
+      return;
+    }
+    core.dispatch_lanes_.Post(session_id < 0 ? kGlobalLane : session_id,
+                              [type, session_id, message]() {
+                                Dispatch(type, session_id, message);
+                              });
+  }
+
+  // Hands a message to the handlers and, for a session, to its slot.
+  static void Dispatch(const std::string &type, int session_id,
+                       const std::string &message) {
     if (session_id < 0) {
-      const auto &global_handler_map =
-          DebugRouterCore::GetInstance().global_handler_map_;
-      for (auto it : global_handler_map) {
+      auto global_handler_map =
+          DebugRouterCore::GetInstance().global_handler_map_.Load();
+      for (const auto &it : *global_handler_map) {
         it.second->OnMessage(message, type);
       }
       return;
     }
 
-    const auto &session_handler_map =
-        DebugRouterCore::GetInstance().session_handler_map_;
-    for (auto it : session_handler_map) {
-      it.second->OnMessage(message, type, session_id);
+    // called without any lock held, the slot is pinned by |slot|. A pulled
+    // session's handlers have had OnSessionDestroy, they get nothing more.
+    auto slot = DebugRouterCore::GetInstance().slots_.Find(session_id);
+    if (!slot) {
+      return;
     }
-
-    // reduce the holding time of slots_mutex_
-    std::lock_guard<std::recursive_mutex> lock(
-        DebugRouterCore::GetInstance().slots_mutex_);
-    const auto &slots = DebugRouterCore::GetInstance().slots_;
-    auto it = slots.find(session_id);
-    if (it != slots.end()) {
-      it->second->OnMessage(message, type);
+    auto session_handler_map =
+        DebugRouterCore::GetInstance().session_handler_map_.Load();
+    for (const auto &it : *session_handler_map) {
+      it.second->OnMessage(message, type, session_id);
     }
+    slot->OnMessage(message, type);
   }
 
   void SendMessage(const std::string &message) override {
@@ -97,9 +93,9 @@ class MessageHandlerCore : public processor::MessageHandler {
   }
 
   void OpenCard(const std::string &url) override {
-    const auto &global_handler_map_ =
-        DebugRouterCore::GetInstance().global_handler_map_;
-    for (auto it : global_handler_map_) {
+    auto global_handler_map =
+        DebugRouterCore::GetInstance().global_handler_map_.Load();
+    for (const auto &it : *global_handler_map) {
       it.second->OpenCard(url);
     }
   }
@@ -110,6 +106,15 @@ class MessageHandlerCore : public processor::MessageHandler {
   }
 
   void ReportError(const std::string &error) override {}
+
+  base::TransportStats::Snapshot GetTransportStats() override {
+    const auto &transceiver =
+        DebugRouterCore::GetInstance().current_transceiver_;
+    if (!transceiver) {
+      return base::TransportStats::Snapshot();
+    }
+    return transceiver->GetTransportStats()->GetSnapshot();
+  }
 };
 
 DebugRouterCore &DebugRouterCore::GetInstance() {
@@ -118,7 +123,10 @@ DebugRouterCore &DebugRouterCore::GetInstance() {
 }
 
 DebugRouterCore::DebugRouterCore()
-    : connection_state_(DISCONNECTED),
+    : dispatch_lanes_(thread::SerialLanes::DefaultWorkerCount()),
+      session_lanes_enabled_(false),
+      global_lane_enabled_(false),
+      connection_state_(DISCONNECTED),
       current_transceiver_(nullptr),
       max_session_id_(0),
       report_(nullptr),
@@ -126,6 +134,7 @@ DebugRouterCore::DebugRouterCore()
       retry_times_(0),
       handler_count_(1),
       is_first_connect_(UNINIT) {
+  protocol::RemoteDebugProtocol::InternKeys();
 #if ENABLE_MESSAGE_IMPL
   size_t transceiver_count = 0;
   message_transceivers_[transceiver_count++] =
@@ -200,14 +209,14 @@ void DebugRouterCore::Connect(const std::string &url, const std::string &room,
   if (room == GetRoomId() && curr_host_ == host_url_ &&
       GetConnectionState() != DISCONNECTED) {
     catagaryJson["attribution"] = "User Incorrect Call";
-    std::string catagary = catagaryJson.toStyledString();
+    std::string catagary = Json::toCompactString(catagaryJson);
     LOGI("DebugRouterCore::Connect already connect this host and room.");
     Report("RedundantConnect", catagary, "", "");
     return;
   }
 
   // report all connect event.
-  std::string catagary = catagaryJson.toStyledString();
+  std::string catagary = Json::toCompactString(catagaryJson);
   if (is_reconnect) {
     LOGI("is_reconnect");
     Report("Reconnect", catagary, "", "");
@@ -264,21 +273,35 @@ void DebugRouterCore::SendDataAsync(const std::string &data,
       [=]() { SendData(data, type, session, mark, is_object); });
 }
 
-int32_t DebugRouterCore::Plug(const std::shared_ptr<core::NativeSlot> &slot) {
-  {
-    std::lock_guard<std::recursive_mutex> lock(slots_mutex_);
-    max_session_id_++;
-    slots_[max_session_id_] = slot;
-  }
-  LOGI("plug session: " << max_session_id_);
-  if (connection_state_.load(std::memory_order_relaxed) == CONNECTED) {
-    processor_->FlushSessionList();
+void DebugRouterCore::SendScreenCastFrame(
+    int32_t session, const std::string &data,
+    const std::unordered_map<std::string, float> &metadata) {
+  if (connection_state_.load(std::memory_order_relaxed) != CONNECTED) {
+    return;
   }
+  auto frame = std::make_shared<processor::ScreencastFrame>();
+  frame->session_id = session;
+  frame->data = std::make_shared<const std::string>(data);
+  frame->metadata = metadata;
+  thread::DebugRouterExecutor::GetInstance().Post(
+      [=]() { processor_->SendScreencastFrame(frame); });
+}
+
+int32_t DebugRouterCore::Plug(const std::shared_ptr<core::NativeSlot> &slot) {
+  int32_t session_id =
+      max_session_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  slots_.Insert(session_id, slot);
+  LOGI("plug session: " << session_id);
+  processor_->OnSessionPlugged(session_id, slot->GetType(), slot->GetUrl());
   NotifyConnectStateByMessage(GetConnectionState());
-  for (auto it : session_handler_map_) {
-    it.second->OnSessionCreate(max_session_id_, slot->GetUrl());
-  }
-  return max_session_id_;
+  std::string url = slot->GetUrl();
+  RunOnSessionLane(session_id, [this, session_id, url]() {
+    auto session_handler_map = session_handler_map_.Load();
+    for (const auto &it : *session_handler_map) {
+      it.second->OnSessionCreate(session_id, url);
+    }
+  });
+  return session_id;
 }
 
 int32_t DebugRouterCore::GetUSBPort() {
@@ -287,16 +310,23 @@ int32_t DebugRouterCore::GetUSBPort() {
 
 void DebugRouterCore::Pull(int32_t session_id_) {
   LOGI("pull session: " << session_id_);
-  {
-    std::lock_guard<std::recursive_mutex> lock(slots_mutex_);
-    slots_.erase(session_id_);
-  }
-  if (connection_state_.load(std::memory_order_relaxed) == CONNECTED) {
-    processor_->FlushSessionList();
-  }
-  for (auto it : session_handler_map_) {
-    it.second->OnSessionDestroy(session_id_);
+  slots_.Erase(session_id_);
+  processor_->OnSessionPulled(session_id_);
+  RunOnSessionLane(session_id_, [this, session_id_]() {
+    auto session_handler_map = session_handler_map_.Load();
+    for (const auto &it : *session_handler_map) {
+      it.second->OnSessionDestroy(session_id_);
+    }
+  });
+}
+
+void DebugRouterCore::RunOnSessionLane(int32_t session_id,
+                                       std::function<void()> work) {
+  if (!session_lanes_enabled_.load(std::memory_order_relaxed)) {
+    work();
+    return;
   }
+  dispatch_lanes_.Post(session_id, std::move(work));
 }
 
 void DebugRouterCore::OnInit(
@@ -333,6 +363,13 @@ void DebugRouterCore::OnOpen(
     }
   }
   LOGI("DebugRouterCore: onOpen.");
+  DebugRouterConfigs &configs = DebugRouterConfigs::GetInstance();
+  session_lanes_enabled_.store(
+      configs.GetConfig(kSessionDispatchLanes, "false") == "true",
+      std::memory_order_relaxed);
+  global_lane_enabled_.store(
+      configs.GetConfig(kGlobalDispatchLane, "false") == "true",
+      std::memory_order_relaxed);
   current_transceiver_ = transceiver;
   connection_state_.store(CONNECTED, std::memory_order_relaxed);
   NotifyConnectStateByMessage(CONNECTED);
@@ -343,30 +380,25 @@ void DebugRouterCore::OnOpen(
     room_id_ = "";
     Json::Value catagaryJson;
     catagaryJson["connect_type"] = "usb";
-    std::string catagary = catagaryJson.toStyledString();
+    std::string catagary = Json::toCompactString(catagaryJson);
     Report("OnOpen", catagary, "", "");
   } else if (is_first_connect_.load() == FIRST_CONNECT) {
     Json::Value catagaryJson;
     catagaryJson["connect_type"] = "websocket";
     catagaryJson["is_first_connect"] = "true";
-    std::string catagary = catagaryJson.toStyledString();
+    std::string catagary = Json::toCompactString(catagaryJson);
     Report("OnOpen", catagary, "", "");
     is_first_connect_.store(NON_FIRST_CONNECT);
   } else {
     Json::Value catagaryJson;
     catagaryJson["connect_type"] = "websocket";
     catagaryJson["is_first_connect"] = "false";
-    std::string catagary = catagaryJson.toStyledString();
+    std::string catagary = Json::toCompactString(catagaryJson);
     Report("OnOpen", catagary, "", "");
   }
 
-  std::vector<std::shared_ptr<DebugRouterStateListener>> listeners;
-  {
-    std::lock_guard<std::recursive_mutex> lock(state_listeners_mutex_);
-    listeners = state_listeners_;
-  }
-
-  for (const auto &listener : listeners) {
+  auto listeners = state_listeners_.Load();
+  for (const auto &listener : *listeners) {
     LOGI("do state_listeners_ onopen.");
     listener->OnOpen(connect_type);
   }
@@ -385,13 +417,8 @@ void DebugRouterCore::OnClosed(
   if (transceiver->GetType() == ConnectionType::kUsb ||
       (transceiver->GetType() == ConnectionType::kWebSocket &&
        retry_times_.load(std::memory_order_relaxed) >= 3)) {
-    std::vector<std::shared_ptr<DebugRouterStateListener>> listeners;
-    {
-      std::lock_guard<std::recursive_mutex> lock(state_listeners_mutex_);
-      listeners = state_listeners_;
-    }
-
-    for (const auto &listener : listeners) {
+    auto listeners = state_listeners_.Load();
+    for (const auto &listener : *listeners) {
       LOGI("do state_listeners_ onclose.");
       listener->OnClose(-1, "unknown reason");
     }
@@ -428,14 +455,14 @@ void DebugRouterCore::OnFailure(
       catagaryJson["connect_type"] = "usb";
       catagaryJson["error_code"] = error_code;
       catagaryJson["error_msg"] = error_message;
-      std::string catagary = catagaryJson.toStyledString();
+      std::string catagary = Json::toCompactString(catagaryJson);
       Report("OnFailure", catagary, "", "");
     } else {
       Json::Value catagaryJson;
       catagaryJson["connect_type"] = "websocket";
       catagaryJson["error_code"] = error_code;
       catagaryJson["error_msg"] = error_message;
-      std::string catagary = catagaryJson.toStyledString();
+      std::string catagary = Json::toCompactString(catagaryJson);
       Report("OnFailure", catagary, "", "");
     }
   } else {
@@ -447,7 +474,7 @@ void DebugRouterCore::OnFailure(
       catagaryJson["is_websocket_first_connect"] = "true";
     }
     catagaryJson["error_msg"] = error_message;
-    std::string catagary = catagaryJson.toStyledString();
+    std::string catagary = Json::toCompactString(catagaryJson);
     Report("OnFailure", catagary, "", "");
   }
   connection_state_.store(DISCONNECTED, std::memory_order_relaxed);
@@ -457,13 +484,8 @@ void DebugRouterCore::OnFailure(
   if (transceiver->GetType() == ConnectionType::kUsb ||
       (transceiver->GetType() == ConnectionType::kWebSocket &&
        retry_times_.load(std::memory_order_relaxed) >= 3)) {
-    std::vector<std::shared_ptr<DebugRouterStateListener>> listeners;
-    {
-      std::lock_guard<std::recursive_mutex> lock(state_listeners_mutex_);
-      listeners = state_listeners_;
-    }
-
-    for (const auto &listener : listeners) {
+    auto listeners = state_listeners_.Load();
+    for (const auto &listener : *listeners) {
       // TODO(zhoumingsong.smile): add more details
       LOGI("do state_listeners_ onfailure.");
       listener->OnError(error_message);
@@ -488,13 +510,8 @@ void DebugRouterCore::OnMessage(
   LOGI("DebugRouter OnMessage.");
   processor_->Process(message);
 
-  std::vector<std::shared_ptr<DebugRouterStateListener>> listeners;
-  {
-    std::lock_guard<std::recursive_mutex> lock(state_listeners_mutex_);
-    listeners = state_listeners_;
-  }
-
-  for (const auto &listener : listeners) {
+  auto listeners = state_listeners_.Load();
+  for (const auto &listener : *listeners) {
     LOGI("do state_listeners_ onmessage.");
     listener->OnMessage(message);
   }
@@ -506,23 +523,30 @@ DebugRouterCore::~DebugRouterCore() {
 }
 
 int DebugRouterCore::AddGlobalHandler(DebugRouterGlobalHandler *handler) {
-  for (auto key : global_handler_map_) {
-    if (key.second == handler) {
-      return key.first;
-    }
-  }
-  int handler_id = handler_count_.fetch_add(1, std::memory_order_relaxed);
-  global_handler_map_[handler_id] = handler;
+  int handler_id = -1;
+  global_handler_map_.Update(
+      [&](std::unordered_map<int, DebugRouterGlobalHandler *> &handlers) {
+        for (const auto &key : handlers) {
+          if (key.second == handler) {
+            handler_id = key.first;
+            return false;
+          }
+        }
+        handler_id = handler_count_.fetch_add(1, std::memory_order_relaxed);
+        handlers[handler_id] = handler;
+        return true;
+      });
   return handler_id;
 }
 
 bool DebugRouterCore::RemoveGlobalHandler(int handler_id) {
-  DebugRouterGlobalHandler *handler = global_handler_map_[handler_id];
-  if (handler) {
-    global_handler_map_.erase(handler_id);
-    return true;
-  }
-  return false;
+  bool removed = false;
+  global_handler_map_.Update(
+      [&](std::unordered_map<int, DebugRouterGlobalHandler *> &handlers) {
+        removed = handlers.erase(handler_id) > 0;
+        return removed;
+      });
+  return removed;
 }
 
 void DebugRouterCore::AddMessageHandler(DebugRouterMessageHandler *handler) {
@@ -544,23 +568,42 @@ bool DebugRouterCore::RemoveMessageHandler(const std::string &handler_name) {
 }
 
 int DebugRouterCore::AddSessionHandler(DebugRouterSessionHandler *handler) {
-  for (auto key : session_handler_map_) {
-    if (key.second == handler) {
-      return key.first;
-    }
-  }
-  int handler_id = handler_count_.fetch_add(1, std::memory_order_relaxed);
-  session_handler_map_[handler_id] = handler;
+  int handler_id = -1;
+  session_handler_map_.Update(
+      [&](std::unordered_map<int, DebugRouterSessionHandler *> &handlers) {
+        for (const auto &key : handlers) {
+          if (key.second == handler) {
+            handler_id = key.first;
+            return false;
+          }
+        }
+        handler_id = handler_count_.fetch_add(1, std::memory_order_relaxed);
+        handlers[handler_id] = handler;
+        return true;
+      });
   return handler_id;
 }
 
 bool DebugRouterCore::RemoveSessionHandler(int handler_id) {
-  DebugRouterSessionHandler *handler = session_handler_map_[handler_id];
+  bool removed = false;
+  session_handler_map_.Update(
+      [&](std::unordered_map<int, DebugRouterSessionHandler *> &handlers) {
+        removed = handlers.erase(handler_id) > 0;
+        return removed;
+      });
+  return removed;
+}
+
+std::string DebugRouterCore::HandleAppAction(const std::string &method,
+                                             const std::string &params) {
+  DebugRouterMessageHandler *handler = message_handlers_[method];
   if (handler) {
-    session_handler_map_.erase(handler_id);
-    return true;
+    LOGI("DebugRouterCore: handle exists: " << method);
+    return handler->Handle(params);
+  } else {
+    LOGI("DebugRouterCore: handle does not exists: " << method);
+    return "{\"code\":-2,\"message\":\"not implemented\"}";
   }
-  return false;
 }
 
 bool DebugRouterCore::IsValidSchema(const std::string &schema) {
@@ -576,12 +619,12 @@ bool DebugRouterCore::HandleSchema(const std::string &encode_schema) {
   LOGI("handle schema: " << schema);
   Json::Value catagaryJson;
   catagaryJson["schema"] = schema;
-  std::string catagary = catagaryJson.toStyledString();
+  std::string catagary = Json::toCompactString(catagaryJson);
   Report("HandleSchema", catagary, "", "");
   int32_t query_index = static_cast<int32_t>(schema.find('?'));
   if (query_index == std::string::npos) {
     catagaryJson["attribution"] = "User Incorrect Useage";
-    catagary = catagaryJson.toStyledString();
+    catagary = Json::toCompactString(catagaryJson);
     Report("InvalidSchema", catagary, "", "");
     LOGE("Invalid schema:" << schema);
     return false;
@@ -590,7 +633,7 @@ bool DebugRouterCore::HandleSchema(const std::string &encode_schema) {
   int32_t cmd_index = static_cast<int32_t>(path.find_last_of('/'));
   if (cmd_index == std::string::npos) {
     catagaryJson["attribution"] = "User Incorrect Useage";
-    catagary = catagaryJson.toStyledString();
+    catagary = Json::toCompactString(catagaryJson);
     Report("InvalidSchema", catagary, "", "");
     LOGE("Invalid schema:" << schema);
     return false;
@@ -631,7 +674,7 @@ bool DebugRouterCore::HandleSchema(const std::string &encode_schema) {
 
     if (url.empty()) {
       catagaryJson["attribution"] = "User Incorrect Useage";
-      catagary = catagaryJson.toStyledString();
+      catagary = Json::toCompactString(catagaryJson);
       Report("InvalidSchema", catagary, "", "");
       LOGE("invalid schema" << schema);
       return false;
@@ -645,7 +688,7 @@ bool DebugRouterCore::HandleSchema(const std::string &encode_schema) {
     return true;
   } else {
     catagaryJson["attribution"] = "User Incorrect Useage";
-    catagary = catagaryJson.toStyledString();
+    catagary = Json::toCompactString(catagaryJson);
     Report("InvalidSchema", catagary, "", "");
     return false;
   }
@@ -657,8 +700,27 @@ void DebugRouterCore::AddStateListener(
   if (listener == nullptr) {
     return;
   }
-  std::lock_guard<std::recursive_mutex> lock(state_listeners_mutex_);
-  state_listeners_.push_back(listener);
+  state_listeners_.Update(
+      [&](std::vector<std::shared_ptr<DebugRouterStateListener>> &listeners) {
+        listeners.push_back(listener);
+        return true;
+      });
+}
+
+bool DebugRouterCore::RemoveStateListener(
+    const std::shared_ptr<DebugRouterStateListener> &listener) {
+  bool removed = false;
+  state_listeners_.Update(
+      [&](std::vector<std::shared_ptr<DebugRouterStateListener>> &listeners) {
+        auto it = std::find(listeners.begin(), listeners.end(), listener);
+        if (it == listeners.end()) {
+          return false;
+        }
+        listeners.erase(it);
+        removed = true;
+        return true;
+      });
+  return removed;
 }
 
 void DebugRouterCore::TryToReconnect() {
@@ -8,20 +8,23 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "debug_router/native/base/copy_on_write.h"
 #include "debug_router/native/core/debug_router_global_handler.h"
 #include "debug_router/native/core/debug_router_message_handler.h"
 #include "debug_router/native/core/debug_router_session_handler.h"
 #include "debug_router/native/core/debug_router_state_listener.h"
 #include "debug_router/native/core/message_transceiver.h"
 #include "debug_router/native/core/native_slot.h"
+#include "debug_router/native/core/slot_table.h"
 #include "debug_router/native/report/debug_router_native_report.h"
+#include "debug_router/native/thread/serial_lanes.h"
 
 namespace debugrouter {
 namespace thread {
@@ -29,6 +32,7 @@ class DebugRouterExecutor;
 }
 namespace processor {
 class Processor;
+struct ScreencastFrame;
 }
 
 namespace core {
@@ -86,6 +90,16 @@ class DebugRouterCore : public MessageTransceiverDelegate {
   void SendDataAsync(const std::string &data, const std::string &type,
                      int32_t session, int32_t mark, bool is_object);
 
+  // Sends a Page.screencastFrame of |session|, paced to the acks of the
+  // frontend: frames arriving faster than they are acked are dropped.
+  void SendScreenCastFrame(
+      int32_t session, const std::string &data,
+      const std::unordered_map<std::string, float> &metadata);
+
+  // Session handlers see OnSessionCreate, then the session's messages, then
+  // OnSessionDestroy, and nothing of it once pulled. With session lanes the
+  // two notifications run on the session's lane, after Plug() and Pull()
+  // have returned.
   int32_t Plug(const std::shared_ptr<core::NativeSlot> &slot);
 
   int32_t GetUSBPort();
@@ -109,6 +123,9 @@ class DebugRouterCore : public MessageTransceiverDelegate {
   int AddSessionHandler(DebugRouterSessionHandler *handler);
   bool RemoveSessionHandler(int handler_id);
 
+  std::string HandleAppAction(const std::string &method,
+                              const std::string &params);
+
   bool IsValidSchema(const std::string &schema);
 
   bool HandleSchema(const std::string &schema);
@@ -126,6 +143,8 @@ class DebugRouterCore : public MessageTransceiverDelegate {
 
   void AddStateListener(
       const std::shared_ptr<core::DebugRouterStateListener> &listener);
+  bool RemoveStateListener(
+      const std::shared_ptr<core::DebugRouterStateListener> &listener);
 
   DebugRouterCore(const DebugRouterCore &) = delete;
   DebugRouterCore &operator=(const DebugRouterCore &) = delete;
@@ -135,10 +154,8 @@ class DebugRouterCore : public MessageTransceiverDelegate {
   virtual ~DebugRouterCore();
 
  protected:
-  std::recursive_mutex slots_mutex_;
-  std::recursive_mutex state_listeners_mutex_;
   friend class MessageHandlerCore;
-  std::unordered_map<int32_t, std::shared_ptr<core::NativeSlot> > slots_;
+  core::SlotTable slots_;
   std::string room_id_;
   std::string server_url_;
   std::string host_url_;
@@ -147,22 +164,36 @@ class DebugRouterCore : public MessageTransceiverDelegate {
   std::unordered_map<std::string, std::string> app_info_;
 
   // for add global handler and session handler, judge if handler is valid
-  // for remove global handler and session handler
-  std::unordered_map<int, DebugRouterGlobalHandler *> global_handler_map_;
-  std::unordered_map<int, DebugRouterSessionHandler *> session_handler_map_;
+  // for remove global handler and session handler. Copied on write, so that
+  // messages are dispatched to them without locking.
+  base::CopyOnWrite<std::unordered_map<int, DebugRouterGlobalHandler *> >
+      global_handler_map_;
+  base::CopyOnWrite<std::unordered_map<int, DebugRouterSessionHandler *> >
+      session_handler_map_;
+
+  // inbound messages can be dispatched to handlers and slots on a lane per
+  // session, see kSessionDispatchLanes and kGlobalDispatchLane, read when a
+  // connection opens. Both are off by default.
+  thread::SerialLanes dispatch_lanes_;
+  std::atomic<bool> session_lanes_enabled_;
+  std::atomic<bool> global_lane_enabled_;
 
  private:
   void Reconnect();
+  // Runs |work| on the lane of |session_id| if session lanes are enabled,
+  // right away otherwise.
+  void RunOnSessionLane(int32_t session_id, std::function<void()> work);
   void Connect(const std::string &url, const std::string &room,
                bool is_reconnect);
   std::atomic<ConnectionState> connection_state_;
   std::shared_ptr<MessageTransceiver> current_transceiver_;
   std::array<std::shared_ptr<MessageTransceiver>, kTransceiverCount>
       message_transceivers_;
-  int32_t max_session_id_;
+  std::atomic<int32_t> max_session_id_;
   std::unique_ptr<report::DebugRouterNativeReport> report_;
   std::unique_ptr<debugrouter::processor::Processor> processor_;
-  std::vector<std::shared_ptr<core::DebugRouterStateListener> >
+  base::CopyOnWrite<
+      std::vector<std::shared_ptr<core::DebugRouterStateListener> > >
       state_listeners_;
   std::atomic<int> retry_times_;
   void TryToReconnect();
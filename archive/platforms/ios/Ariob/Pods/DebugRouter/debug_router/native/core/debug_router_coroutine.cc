@@ -0,0 +1,341 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/core/debug_router_coroutine.h"
+
+#if DEBUGROUTER_ENABLE_COROUTINE
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "debug_router/native/base/no_destructor.h"
+#include "debug_router/native/core/debug_router_core.h"
+#include "debug_router/native/core/debug_router_global_handler.h"
+#include "debug_router/native/core/debug_router_session_handler.h"
+#include "debug_router/native/log/logging.h"
+#include "json/reader.h"
+
+namespace debugrouter {
+namespace core {
+namespace internal {
+
+namespace {
+
+class ConnectStateListener
+    : public DebugRouterStateListener,
+      public std::enable_shared_from_this<ConnectStateListener> {
+ public:
+  explicit ConnectStateListener(
+      const std::shared_ptr<AwaitState<ConnectResult>> &state)
+      : state_(state) {}
+
+  void OnOpen(ConnectionType type) override {
+    ConnectResult result;
+    result.connected = true;
+    result.type = type;
+    Finish(std::move(result));
+  }
+
+  void OnClose(int32_t code, const std::string &reason) override {
+    ConnectResult result;
+    result.code = code;
+    result.reason = reason;
+    Finish(std::move(result));
+  }
+
+  void OnMessage(const std::string & /*message*/) override {}
+
+  void OnError(const std::string &error) override {
+    ConnectResult result;
+    result.code = -1;
+    result.reason = error;
+    Finish(std::move(result));
+  }
+
+  void Finish(ConnectResult result) {
+    if (state_->Complete(std::move(result))) {
+      DebugRouterCore::GetInstance().RemoveStateListener(shared_from_this());
+    }
+  }
+
+ private:
+  std::shared_ptr<AwaitState<ConnectResult>> state_;
+};
+
+// Reads the top level "id" of a message. Parsing stops as soon as its value
+// is known, the rest of the message is neither read nor materialized.
+class AckIdReader : public Json::StreamHandler {
+ public:
+  bool Read(const std::string &message, int64_t &id) {
+    Json::StreamReader reader(*this);
+    reader.feed(message);
+    if (!found_) {
+      return false;
+    }
+    id = id_;
+    return true;
+  }
+
+  bool onNull() override { return !is_id_; }
+  bool onBool(bool /*value*/) override { return !is_id_; }
+  bool onInt(Json::LargestInt value) override { return Found(value); }
+  // above the int64 range, not an id that can be acknowledged.
+  bool onUInt(Json::LargestUInt /*value*/) override { return !is_id_; }
+  bool onDouble(double value) override {
+    // Json::Value::isIntegral() also accepts integral doubles.
+    if (is_id_ && value >= -9223372036854775808.0 &&
+        value < 9223372036854775808.0 && std::floor(value) == value) {
+      return Found(static_cast<int64_t>(value));
+    }
+    return !is_id_;
+  }
+  bool onString(const char * /*begin*/, const char * /*end*/) override {
+    return !is_id_;
+  }
+  bool onStartObject() override {
+    ++depth_;
+    return !is_id_;
+  }
+  bool onKey(const char *begin, const char *end) override {
+    is_id_ = depth_ == 1 && end - begin == 2 && begin[0] == 'i' &&
+             begin[1] == 'd';
+    return true;
+  }
+  bool onEndObject() override {
+    --depth_;
+    return true;
+  }
+  bool onStartArray() override {
+    ++depth_;
+    return !is_id_;
+  }
+  bool onEndArray() override {
+    --depth_;
+    return true;
+  }
+
+ private:
+  bool Found(int64_t id) {
+    if (!is_id_) {
+      return true;
+    }
+    id_ = id;
+    found_ = true;
+    return false;
+  }
+
+  int depth_ = 0;
+  bool is_id_ = false;
+  bool found_ = false;
+  int64_t id_ = 0;
+};
+
+// Pending SendWithAck requests, keyed by (type, session_id, id). Registered
+// into DebugRouterCore once, on the first SendWithAck.
+class PendingAckTable : public DebugRouterGlobalHandler,
+                        public DebugRouterSessionHandler {
+ public:
+  using Key = std::tuple<std::string, int32_t, int64_t>;
+
+  static PendingAckTable &GetInstance() {
+    static base::NoDestructor<PendingAckTable> instance;
+    return *instance;
+  }
+
+  void EnsureRegistered();
+
+  bool Add(const Key &key,
+           const std::shared_ptr<AwaitState<AckResult>> &state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.emplace(key, state).second;
+  }
+
+  void Remove(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(key);
+  }
+
+  void FailAll(const std::string &error) {
+    std::map<Key, std::shared_ptr<AwaitState<AckResult>>> pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending.swap(pending_);
+    }
+    for (auto &item : pending) {
+      AckResult result;
+      result.error = error;
+      item.second->Complete(std::move(result));
+    }
+  }
+
+  void OpenCard(const std::string & /*url*/) override {}
+
+  void OnMessage(const std::string &message, const std::string &type) override {
+    Dispatch(message, type, -1);
+  }
+
+  void OnSessionCreate(int /*session_id*/,
+                       const std::string & /*url*/) override {}
+
+  void OnSessionDestroy(int /*session_id*/) override {}
+
+  void OnMessage(const std::string &message, const std::string &type,
+                 int session_id) override {
+    Dispatch(message, type, session_id);
+  }
+
+ private:
+  friend class base::NoDestructor<PendingAckTable>;
+  PendingAckTable() = default;
+
+  void Dispatch(const std::string &message, const std::string &type,
+                int32_t session_id) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_.empty()) {
+        return;
+      }
+    }
+    int64_t id = 0;
+    if (!AckIdReader().Read(message, id)) {
+      return;
+    }
+    std::shared_ptr<AwaitState<AckResult>> state;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = pending_.find(Key(type, session_id, id));
+      if (it == pending_.end()) {
+        return;
+      }
+      state = std::move(it->second);
+      pending_.erase(it);
+    }
+    AckResult result;
+    result.success = true;
+    result.message = message;
+    state->Complete(std::move(result));
+  }
+
+  std::once_flag registered_;
+  std::mutex mutex_;
+  std::map<Key, std::shared_ptr<AwaitState<AckResult>>> pending_;
+};
+
+class AckConnectionWatcher : public DebugRouterStateListener {
+ public:
+  void OnOpen(ConnectionType /*type*/) override {}
+
+  void OnClose(int32_t /*code*/, const std::string &reason) override {
+    PendingAckTable::GetInstance().FailAll("connection closed: " + reason);
+  }
+
+  void OnMessage(const std::string & /*message*/) override {}
+
+  void OnError(const std::string &error) override {
+    PendingAckTable::GetInstance().FailAll("connection error: " + error);
+  }
+};
+
+void PendingAckTable::EnsureRegistered() {
+  std::call_once(registered_, [this]() {
+    DebugRouterCore &core = DebugRouterCore::GetInstance();
+    core.AddGlobalHandler(this);
+    core.AddSessionHandler(this);
+    core.AddStateListener(std::make_shared<AckConnectionWatcher>());
+  });
+}
+
+}  // namespace
+
+bool IsConnectedTo(const std::string &url, const std::string &room) {
+  DebugRouterCore &core = DebugRouterCore::GetInstance();
+  return core.IsConnected() && core.GetServerUrl() == url &&
+         core.GetRoomId() == room;
+}
+
+void StartConnect(const std::shared_ptr<AwaitState<ConnectResult>> &state,
+                  const std::string &url, const std::string &room) {
+  auto listener = std::make_shared<ConnectStateListener>(state);
+  DebugRouterCore::GetInstance().AddStateListener(listener);
+  thread::DebugRouterExecutor::GetInstance().Post([listener, url, room]() {
+    DebugRouterCore &core = DebugRouterCore::GetInstance();
+    core.Connect(url, room);
+    // Connect() returns early without any state change if this host and
+    // room are already connected, so no OnOpen will follow.
+    if (core.GetConnectionState() == CONNECTED) {
+      ConnectResult result;
+      result.connected = true;
+      listener->Finish(std::move(result));
+    }
+  });
+}
+
+void StartSend(const std::shared_ptr<AwaitState<bool>> &state,
+               const std::string &message) {
+  thread::DebugRouterExecutor::GetInstance().Post([state, message]() {
+    DebugRouterCore &core = DebugRouterCore::GetInstance();
+    bool connected = core.IsConnected();
+    if (connected) {
+      core.Send(message);
+    }
+    state->Complete(connected);
+  });
+}
+
+void StartSendWithAck(const std::shared_ptr<AwaitState<AckResult>> &state,
+                      const std::string &type, int32_t session_id, int64_t id,
+                      const std::string &message, bool is_object) {
+  if (is_object) {
+    // spliced into the envelope as is, a broken object would corrupt it.
+    Json::Reader reader;
+    Json::Value root;
+    if (!reader.parse(message, root, false) || !root.isObject()) {
+      LOGE("SendWithAck: message is not a JSON object, session "
+           << session_id << " id " << id);
+      AckResult result;
+      result.error = "invalid message";
+      state->Complete(std::move(result));
+      return;
+    }
+  }
+  PendingAckTable &table = PendingAckTable::GetInstance();
+  table.EnsureRegistered();
+  PendingAckTable::Key key(type, session_id, id);
+  if (!table.Add(key, state)) {
+    LOGW("SendWithAck: duplicated id " << id << " for session " << session_id);
+    AckResult result;
+    result.error = "duplicated id";
+    state->Complete(std::move(result));
+    return;
+  }
+  thread::DebugRouterExecutor::GetInstance().Post(
+      [state, key, type, session_id, message, is_object]() {
+        DebugRouterCore &core = DebugRouterCore::GetInstance();
+        if (!core.IsConnected()) {
+          PendingAckTable::GetInstance().Remove(key);
+          AckResult result;
+          result.error = "not connected";
+          state->Complete(std::move(result));
+          return;
+        }
+        core.SendData(message, type, session_id, -1, is_object);
+      });
+}
+
+void StartAppAction(const std::shared_ptr<AwaitState<std::string>> &state,
+                    const std::string &method, const std::string &params) {
+  thread::DebugRouterExecutor::GetInstance().Post([state, method, params]() {
+    state->Complete(
+        DebugRouterCore::GetInstance().HandleAppAction(method, params));
+  });
+}
+
+}  // namespace internal
+}  // namespace core
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_ENABLE_COROUTINE
@@ -0,0 +1,407 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_CORE_DEBUG_ROUTER_COROUTINE_H_
+#define DEBUGROUTER_NATIVE_CORE_DEBUG_ROUTER_COROUTINE_H_
+
+// Awaitable wrappers around DebugRouterCore. Only available when the
+// toolchain supports C++20 coroutines, the rest of DebugRouter stays C++14.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define DEBUGROUTER_ENABLE_COROUTINE 1
+#endif
+#endif
+
+#ifndef DEBUGROUTER_ENABLE_COROUTINE
+#define DEBUGROUTER_ENABLE_COROUTINE 0
+#endif
+
+#if DEBUGROUTER_ENABLE_COROUTINE
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "debug_router/native/core/debug_router_state_listener.h"
+#include "debug_router/native/thread/debug_router_executor.h"
+
+namespace debugrouter {
+namespace core {
+
+/*
+ * Usage:
+ *
+ *   core::Task<void> Attach(std::string url, std::string room) {
+ *     core::ConnectResult result = co_await core::AwaitConnect(url, room);
+ *     if (!result.connected) {
+ *       co_return;
+ *     }
+ *     core::AckResult ack = co_await core::SendWithAck("CDP", session, id,
+ *                                                      request, true);
+ *     ...
+ *   }
+ *
+ *   core::Launch(Attach(url, room));
+ *
+ * Every coroutine is resumed on DebugRouterExecutor, so code between two
+ * co_await points runs on the same thread as the rest of DebugRouter.
+ */
+
+struct ConnectResult {
+  bool connected = false;
+  ConnectionType type = ConnectionType::kWebSocket;
+  int32_t code = 0;
+  std::string reason;
+};
+
+struct AckResult {
+  bool success = false;
+  // the inbound message carrying the same id, valid if success is true.
+  std::string message;
+  // reason of the failure, valid if success is false.
+  std::string error;
+};
+
+template <typename T>
+class Task;
+
+namespace internal {
+
+class TaskPromiseBase {
+ public:
+  struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept {
+      TaskPromiseBase &promise = handle.promise();
+      if (promise.continuation_) {
+        return promise.continuation_;
+      }
+      if (promise.detached_) {
+        handle.destroy();
+      }
+      return std::noop_coroutine();
+    }
+
+    void await_resume() noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+
+  void unhandled_exception() noexcept {
+#if __cpp_exceptions >= 199711L
+    exception_ = std::current_exception();
+#else
+    std::terminate();
+#endif
+  }
+
+  void RethrowIfNeeded() {
+#if __cpp_exceptions >= 199711L
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+#endif
+  }
+
+  std::coroutine_handle<> continuation_;
+  bool detached_ = false;
+#if __cpp_exceptions >= 199711L
+  std::exception_ptr exception_;
+#endif
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+ public:
+  Task<T> get_return_object() noexcept;
+
+  template <typename U>
+  void return_value(U &&value) {
+    value_.emplace(std::forward<U>(value));
+  }
+
+  T TakeResult() {
+    RethrowIfNeeded();
+    return std::move(*value_);
+  }
+
+ private:
+  std::optional<T> value_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+ public:
+  Task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+
+  void TakeResult() { RethrowIfNeeded(); }
+};
+
+// Shared between an awaiter and whoever completes it. Complete() only wins
+// once, so a late callback (e.g. a disconnect racing with an ack) is dropped.
+template <typename T>
+class AwaitState {
+ public:
+  void SetHandle(std::coroutine_handle<> handle) { handle_ = handle; }
+
+  // Stores the result without resuming, used before the awaiter suspends.
+  bool Resolve(T result) {
+    bool expected = false;
+    if (!done_.compare_exchange_strong(expected, true)) {
+      return false;
+    }
+    result_ = std::move(result);
+    return true;
+  }
+
+  bool Complete(T result) {
+    if (!Resolve(std::move(result))) {
+      return false;
+    }
+    std::coroutine_handle<> handle = handle_;
+    thread::DebugRouterExecutor::GetInstance().Post(
+        [handle]() { handle.resume(); }, false);
+    return true;
+  }
+
+  T TakeResult() { return std::move(result_); }
+
+ private:
+  std::atomic<bool> done_{false};
+  std::coroutine_handle<> handle_;
+  T result_;
+};
+
+void StartConnect(const std::shared_ptr<AwaitState<ConnectResult>> &state,
+                  const std::string &url, const std::string &room);
+bool IsConnectedTo(const std::string &url, const std::string &room);
+
+void StartSend(const std::shared_ptr<AwaitState<bool>> &state,
+               const std::string &message);
+
+void StartSendWithAck(const std::shared_ptr<AwaitState<AckResult>> &state,
+                      const std::string &type, int32_t session_id, int64_t id,
+                      const std::string &message, bool is_object);
+
+void StartAppAction(const std::shared_ptr<AwaitState<std::string>> &state,
+                    const std::string &method, const std::string &params);
+
+template <typename T>
+class StateAwaiter {
+ public:
+  StateAwaiter() : state_(std::make_shared<AwaitState<T>>()) {}
+
+  bool await_ready() const noexcept { return false; }
+  T await_resume() { return state_->TakeResult(); }
+
+ protected:
+  std::shared_ptr<AwaitState<T>> state_;
+};
+
+}  // namespace internal
+
+template <typename T>
+class Task {
+ public:
+  using promise_type = internal::TaskPromise<T>;
+
+  Task() = default;
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+  Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  ~Task() { Reset(); }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() const noexcept { return !handle || handle.done(); }
+
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> continuation) noexcept {
+        handle.promise().continuation_ = continuation;
+        return handle;
+      }
+
+      T await_resume() { return handle.promise().TakeResult(); }
+    };
+    return Awaiter{handle_};
+  }
+
+  // Runs the task on DebugRouterExecutor without waiting for it. The
+  // coroutine frame is released when the task finishes.
+  void Start() && {
+    std::coroutine_handle<promise_type> handle = std::exchange(handle_, {});
+    if (!handle) {
+      return;
+    }
+    handle.promise().detached_ = true;
+    thread::DebugRouterExecutor::GetInstance().Post(
+        [handle]() { handle.resume(); }, false);
+  }
+
+ private:
+  void Reset() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = {};
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+namespace internal {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+}  // namespace internal
+
+template <typename T>
+void Launch(Task<T> &&task) {
+  std::move(task).Start();
+}
+
+class ConnectAwaiter : public internal::StateAwaiter<ConnectResult> {
+ public:
+  ConnectAwaiter(std::string url, std::string room)
+      : url_(std::move(url)), room_(std::move(room)) {}
+
+  bool await_ready() {
+    if (!internal::IsConnectedTo(url_, room_)) {
+      return false;
+    }
+    ConnectResult result;
+    result.connected = true;
+    state_->Resolve(std::move(result));
+    return true;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    state_->SetHandle(handle);
+    internal::StartConnect(state_, url_, room_);
+  }
+
+ private:
+  std::string url_;
+  std::string room_;
+};
+
+class SendAwaiter : public internal::StateAwaiter<bool> {
+ public:
+  explicit SendAwaiter(std::string message) : message_(std::move(message)) {}
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    state_->SetHandle(handle);
+    internal::StartSend(state_, message_);
+  }
+
+ private:
+  std::string message_;
+};
+
+class AckAwaiter : public internal::StateAwaiter<AckResult> {
+ public:
+  AckAwaiter(std::string type, int32_t session_id, int64_t id,
+             std::string message, bool is_object)
+      : type_(std::move(type)),
+        session_id_(session_id),
+        id_(id),
+        message_(std::move(message)),
+        is_object_(is_object) {}
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    state_->SetHandle(handle);
+    internal::StartSendWithAck(state_, type_, session_id_, id_, message_,
+                               is_object_);
+  }
+
+ private:
+  std::string type_;
+  int32_t session_id_;
+  int64_t id_;
+  std::string message_;
+  bool is_object_;
+};
+
+class AppActionAwaiter : public internal::StateAwaiter<std::string> {
+ public:
+  AppActionAwaiter(std::string method, std::string params)
+      : method_(std::move(method)), params_(std::move(params)) {}
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    state_->SetHandle(handle);
+    internal::StartAppAction(state_, method_, params_);
+  }
+
+ private:
+  std::string method_;
+  std::string params_;
+};
+
+// Completes when the connection is opened, or when DebugRouterCore gives up
+// (usb closed or websocket retries exhausted). Completes immediately if the
+// same url and room are already connected.
+inline ConnectAwaiter AwaitConnect(std::string url, std::string room) {
+  return ConnectAwaiter(std::move(url), std::move(room));
+}
+
+// Completes with false if the connection is not open when the message is
+// handed to the transceiver.
+inline SendAwaiter AwaitSend(std::string message) {
+  return SendAwaiter(std::move(message));
+}
+
+// Wraps |message| as a customized message of |type| for |session_id| and
+// completes when an inbound message of the same type and session carries
+// the same "id". Pending acks fail when the connection is closed, so several
+// requests can be in flight at the same time.
+// |message| is sent as a JSON string unless |is_object| is set, in which case
+// it must hold a JSON object; one that doesn't parse fails the request.
+inline AckAwaiter SendWithAck(std::string type, int32_t session_id, int64_t id,
+                              std::string message, bool is_object = false) {
+  return AckAwaiter(std::move(type), session_id, id, std::move(message),
+                    is_object);
+}
+
+// Runs the DebugRouterMessageHandler registered for |method| on
+// DebugRouterExecutor and completes with its result.
+inline AppActionAwaiter AwaitAppAction(std::string method, std::string params) {
+  return AppActionAwaiter(std::move(method), std::move(params));
+}
+
+}  // namespace core
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_ENABLE_COROUTINE
+
+#endif  // DEBUGROUTER_NATIVE_CORE_DEBUG_ROUTER_COROUTINE_H_
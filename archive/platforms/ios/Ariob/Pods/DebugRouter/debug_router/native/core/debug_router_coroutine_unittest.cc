@@ -0,0 +1,258 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/core/debug_router_coroutine.h"
+
+#if DEBUGROUTER_ENABLE_COROUTINE
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "debug_router/native/core/debug_router_core.h"
+#include "debug_router/native/core/message_transceiver.h"
+#include "gtest/gtest.h"
+#include "json/value.h"
+#include "json/writer.h"
+
+namespace debugrouter {
+namespace core {
+
+namespace {
+
+constexpr int kClientId = 5;
+constexpr auto kTimeout = std::chrono::seconds(5);
+
+// A usb connection that records what is sent, and is never really opened.
+class FakeTransceiver : public MessageTransceiver {
+ public:
+  bool Connect(const std::string & /*url*/) override { return false; }
+  void Disconnect() override {}
+  ConnectionType GetType() override { return ConnectionType::kUsb; }
+
+  void Send(const std::string &data) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_.push_back(data);
+    condition_.notify_all();
+  }
+
+  // Waits until |count| messages were sent, returns all of them.
+  std::vector<std::string> WaitForSent(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait_for(lock, kTimeout,
+                        [&]() { return sent_.size() >= count; });
+    return sent_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<std::string> sent_;
+};
+
+std::string GlobalCDPEnvelope(const std::string &message) {
+  Json::Value root(Json::objectValue);
+  root["event"] = "Customized";
+  root["data"]["type"] = "CDP";
+  root["data"]["sender"] = kClientId;
+  root["data"]["data"]["client_id"] = kClientId;
+  root["data"]["data"]["session_id"] = -1;
+  root["data"]["data"]["message"] = message;
+  return Json::FastWriter().write(root);
+}
+
+std::thread::id ExecutorThreadId() {
+  std::promise<std::thread::id> id;
+  thread::DebugRouterExecutor::GetInstance().Post(
+      [&id]() { id.set_value(std::this_thread::get_id()); });
+  return id.get_future().get();
+}
+
+struct Resumed {
+  AckResult ack;
+  std::thread::id thread;
+};
+
+Task<void> SendAndWait(int64_t id, std::shared_ptr<std::promise<Resumed>> out) {
+  Resumed resumed;
+  resumed.ack = co_await SendWithAck("CDP", -1, id,
+                                     "{\"id\":" + std::to_string(id) + "}");
+  resumed.thread = std::this_thread::get_id();
+  out->set_value(std::move(resumed));
+}
+
+Task<int> Add(int lhs, int rhs) { co_return lhs + rhs; }
+
+Task<void> AddTwice(std::shared_ptr<std::promise<int>> out) {
+  int sum = co_await Add(1, 2);
+  sum += co_await Add(sum, 4);
+  out->set_value(sum);
+}
+
+Task<void> Hold(std::shared_ptr<int> held, bool *ran) {
+  *ran = held != nullptr;
+  co_return;
+}
+
+class DebugRouterCoroutineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    transceiver_ = std::make_shared<FakeTransceiver>();
+    DebugRouterCore &core = DebugRouterCore::GetInstance();
+    core.OnOpen(transceiver_);
+    core.OnMessage("{\"event\":\"Initialize\",\"data\":5}", transceiver_);
+  }
+
+  void TearDown() override {
+    DebugRouterCore::GetInstance().OnClosed(transceiver_);
+  }
+
+  void Receive(const std::string &message) {
+    DebugRouterCore::GetInstance().OnMessage(GlobalCDPEnvelope(message),
+                                             transceiver_);
+  }
+
+  std::shared_ptr<FakeTransceiver> transceiver_;
+};
+
+}  // namespace
+
+TEST_F(DebugRouterCoroutineTest, ResumesOnTheExecutor) {
+  auto sent = std::make_shared<std::promise<std::thread::id>>();
+  auto task = [](std::shared_ptr<std::promise<std::thread::id>> out)
+      -> Task<void> {
+    bool success = co_await AwaitSend("{}");
+    EXPECT_TRUE(success);
+    out->set_value(std::this_thread::get_id());
+  };
+  Launch(task(sent));
+  std::future<std::thread::id> resumed = sent->get_future();
+  ASSERT_EQ(resumed.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_EQ(resumed.get(), ExecutorThreadId());
+
+  // an ack received on this thread still resumes on the executor.
+  auto out = std::make_shared<std::promise<Resumed>>();
+  size_t before = transceiver_->WaitForSent(0).size();
+  Launch(SendAndWait(1, out));
+  transceiver_->WaitForSent(before + 1);
+  Receive("{\"id\":1,\"result\":{}}");
+  std::future<Resumed> acked = out->get_future();
+  ASSERT_EQ(acked.wait_for(kTimeout), std::future_status::ready);
+  Resumed resumed_ack = acked.get();
+  EXPECT_TRUE(resumed_ack.ack.success);
+  EXPECT_EQ(resumed_ack.thread, ExecutorThreadId());
+  EXPECT_NE(resumed_ack.thread, std::this_thread::get_id());
+}
+
+TEST_F(DebugRouterCoroutineTest, MatchesAcksById) {
+  auto first = std::make_shared<std::promise<Resumed>>();
+  auto second = std::make_shared<std::promise<Resumed>>();
+  size_t before = transceiver_->WaitForSent(0).size();
+  Launch(SendAndWait(10, first));
+  Launch(SendAndWait(11, second));
+  ASSERT_EQ(transceiver_->WaitForSent(before + 2).size(), before + 2);
+
+  std::future<Resumed> first_acked = first->get_future();
+  std::future<Resumed> second_acked = second->get_future();
+  // neither an unknown id nor an id nested in the params completes them.
+  Receive("{\"id\":12,\"result\":{}}");
+  Receive("{\"method\":\"Event\",\"params\":{\"id\":10}}");
+  EXPECT_EQ(first_acked.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+
+  Receive("{\"id\":11,\"result\":{\"value\":2}}");
+  ASSERT_EQ(second_acked.wait_for(kTimeout), std::future_status::ready);
+  Resumed resumed = second_acked.get();
+  EXPECT_TRUE(resumed.ack.success);
+  EXPECT_EQ(resumed.ack.message, "{\"id\":11,\"result\":{\"value\":2}}");
+  EXPECT_EQ(first_acked.wait_for(std::chrono::milliseconds(0)),
+            std::future_status::timeout);
+
+  Receive("{\"id\":10,\"result\":{\"value\":1}}");
+  ASSERT_EQ(first_acked.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_EQ(first_acked.get().ack.message,
+            "{\"id\":10,\"result\":{\"value\":1}}");
+}
+
+TEST_F(DebugRouterCoroutineTest, DisconnectFailsEveryPendingAck) {
+  std::vector<std::future<Resumed>> pending;
+  size_t before = transceiver_->WaitForSent(0).size();
+  for (int64_t id = 20; id < 23; ++id) {
+    auto out = std::make_shared<std::promise<Resumed>>();
+    pending.push_back(out->get_future());
+    Launch(SendAndWait(id, out));
+  }
+  ASSERT_EQ(transceiver_->WaitForSent(before + 3).size(), before + 3);
+
+  DebugRouterCore::GetInstance().OnClosed(transceiver_);
+  for (std::future<Resumed> &result : pending) {
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    Resumed resumed = result.get();
+    EXPECT_FALSE(resumed.ack.success);
+    EXPECT_EQ(resumed.ack.error.find("connection closed"), 0u)
+        << resumed.ack.error;
+  }
+
+  // once closed, requests fail right away.
+  auto out = std::make_shared<std::promise<Resumed>>();
+  Launch(SendAndWait(23, out));
+  std::future<Resumed> result = out->get_future();
+  ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_EQ(result.get().ack.error, "not connected");
+}
+
+TEST_F(DebugRouterCoroutineTest, FailsADuplicatedId) {
+  auto first = std::make_shared<std::promise<Resumed>>();
+  auto second = std::make_shared<std::promise<Resumed>>();
+  Launch(SendAndWait(30, first));
+  Launch(SendAndWait(30, second));
+  std::future<Resumed> duplicated = second->get_future();
+  ASSERT_EQ(duplicated.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_EQ(duplicated.get().ack.error, "duplicated id");
+
+  Receive("{\"id\":30}");
+  std::future<Resumed> acked = first->get_future();
+  ASSERT_EQ(acked.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_TRUE(acked.get().ack.success);
+}
+
+TEST_F(DebugRouterCoroutineTest, AwaitsNestedTasks) {
+  auto out = std::make_shared<std::promise<int>>();
+  Launch(AddTwice(out));
+  std::future<int> sum = out->get_future();
+  ASSERT_EQ(sum.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_EQ(sum.get(), 10);
+}
+
+TEST_F(DebugRouterCoroutineTest, DestroyingATaskReleasesItsFrame) {
+  auto held = std::make_shared<int>(0);
+  std::weak_ptr<int> watch = held;
+  bool ran = false;
+  {
+    // suspended before its first statement, never started.
+    Task<void> task = Hold(std::move(held), &ran);
+    EXPECT_FALSE(watch.expired());
+  }
+  EXPECT_TRUE(watch.expired());
+  EXPECT_FALSE(ran);
+
+  // a launched task frees its frame itself once finished.
+  held = std::make_shared<int>(0);
+  watch = held;
+  Launch(Hold(std::move(held), &ran));
+  // the executor runs works in order, the task is done after this one.
+  ExecutorThreadId();
+  EXPECT_TRUE(ran);
+  EXPECT_TRUE(watch.expired());
+}
+
+}  // namespace core
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_ENABLE_COROUTINE
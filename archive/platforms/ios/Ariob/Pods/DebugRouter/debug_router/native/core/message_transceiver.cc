@@ -6,7 +6,8 @@
 
 namespace debugrouter {
 namespace core {
-MessageTransceiver::MessageTransceiver() {}
+MessageTransceiver::MessageTransceiver()
+    : transport_stats_(std::make_shared<base::TransportStats>()) {}
 
 void MessageTransceiver::HandleReceivedMessage(const std::string &message) {
   if (delegate_) {
@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 
+#include "debug_router/native/base/transport_stats.h"
 #include "debug_router/native/core/debug_router_state_listener.h"
 
 namespace debugrouter {
@@ -43,6 +44,13 @@ class MessageTransceiver
   virtual void HandleReceivedMessage(const std::string &message);
   virtual void SetDelegate(MessageTransceiverDelegate *delegate);
   virtual MessageTransceiverDelegate *delegate();
+  // Stats of the outbound queue, updated by the transceiver.
+  const std::shared_ptr<base::TransportStats> &GetTransportStats() const {
+    return transport_stats_;
+  }
+
+ protected:
+  std::shared_ptr<base::TransportStats> transport_stats_;
 
  private:
   MessageTransceiverDelegate *delegate_ = nullptr;
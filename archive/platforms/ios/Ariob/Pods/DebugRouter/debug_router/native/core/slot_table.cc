@@ -0,0 +1,45 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/core/slot_table.h"
+
+#include "debug_router/native/core/native_slot.h"
+
+namespace debugrouter {
+namespace core {
+
+constexpr size_t SlotTable::kShardCount;
+
+void SlotTable::Insert(int32_t session_id,
+                       const std::shared_ptr<NativeSlot> &slot) {
+  Shard &shard = ShardOf(session_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.slots[session_id] = slot;
+}
+
+bool SlotTable::Erase(int32_t session_id) {
+  std::shared_ptr<NativeSlot> slot;
+  Shard &shard = ShardOf(session_id);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.slots.find(session_id);
+    if (it == shard.slots.end()) {
+      return false;
+    }
+    // released out of the lock, in case this was its last reference.
+    slot = std::move(it->second);
+    shard.slots.erase(it);
+  }
+  return true;
+}
+
+std::shared_ptr<NativeSlot> SlotTable::Find(int32_t session_id) {
+  Shard &shard = ShardOf(session_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.slots.find(session_id);
+  return it == shard.slots.end() ? nullptr : it->second;
+}
+
+}  // namespace core
+}  // namespace debugrouter
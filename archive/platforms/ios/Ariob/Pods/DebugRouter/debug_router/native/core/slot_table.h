@@ -0,0 +1,60 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_CORE_SLOT_TABLE_H_
+#define DEBUGROUTER_NATIVE_CORE_SLOT_TABLE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace debugrouter {
+namespace core {
+
+class NativeSlot;
+
+/*
+ * The slots plugged into DebugRouterCore, by session id.
+ *
+ * Split in shards with a lock each, picked from the session id, so lookups
+ * of different sessions don't contend with one another nor with plugging
+ * and pulling. Find() returns the slot itself: messages are dispatched to it
+ * after the lock is released, and a slot pulled meanwhile lives until the
+ * dispatch is over.
+ */
+class SlotTable {
+ public:
+  SlotTable() = default;
+  SlotTable(const SlotTable &) = delete;
+  SlotTable &operator=(const SlotTable &) = delete;
+
+  void Insert(int32_t session_id, const std::shared_ptr<NativeSlot> &slot);
+  // Returns false if there was no such session.
+  bool Erase(int32_t session_id);
+  // nullptr if there is no such session.
+  std::shared_ptr<NativeSlot> Find(int32_t session_id);
+
+ private:
+  // session ids are consecutive, so they spread evenly over the shards.
+  static constexpr size_t kShardCount = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<int32_t, std::shared_ptr<NativeSlot>> slots;
+  };
+
+  Shard &ShardOf(int32_t session_id) {
+    return shards_[static_cast<uint32_t>(session_id) % kShardCount];
+  }
+
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace core
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_CORE_SLOT_TABLE_H_
@@ -0,0 +1,181 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/core/slot_table.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "debug_router/native/core/native_slot.h"
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace core {
+
+namespace {
+
+// Counts its messages, and whether it was used after being destroyed.
+class CountingSlot : public NativeSlot {
+ public:
+  explicit CountingSlot(int32_t session_id)
+      : NativeSlot("Lynx", "url"), session_id_(session_id) {}
+  ~CountingSlot() override { session_id_ = -1; }
+
+  void OnMessage(const std::string & /*message*/,
+                 const std::string & /*type*/) override {
+    ++messages_;
+  }
+
+  int32_t session_id() const { return session_id_; }
+  int messages() const { return messages_; }
+
+ private:
+  std::atomic<int32_t> session_id_;
+  std::atomic<int> messages_{0};
+};
+
+std::shared_ptr<CountingSlot> Find(SlotTable &table, int32_t session_id) {
+  return std::static_pointer_cast<CountingSlot>(table.Find(session_id));
+}
+
+}  // namespace
+
+TEST(SlotTableTest, InsertsFindsAndErasesAcrossShards) {
+  const int32_t kSessions = 100;
+  SlotTable table;
+  for (int32_t id = 1; id <= kSessions; ++id) {
+    table.Insert(id, std::make_shared<CountingSlot>(id));
+  }
+  for (int32_t id = 1; id <= kSessions; ++id) {
+    std::shared_ptr<CountingSlot> slot = Find(table, id);
+    ASSERT_NE(slot, nullptr) << id;
+    EXPECT_EQ(slot->session_id(), id);
+  }
+  EXPECT_EQ(table.Find(0), nullptr);
+  EXPECT_EQ(table.Find(kSessions + 1), nullptr);
+  EXPECT_EQ(table.Find(-1), nullptr);
+
+  for (int32_t id = 1; id <= kSessions; id += 2) {
+    EXPECT_TRUE(table.Erase(id));
+  }
+  for (int32_t id = 1; id <= kSessions; ++id) {
+    EXPECT_EQ(table.Find(id) == nullptr, id % 2 == 1) << id;
+  }
+  EXPECT_FALSE(table.Erase(1));
+  EXPECT_FALSE(table.Erase(kSessions + 1));
+
+  // inserting again replaces the slot.
+  auto replacement = std::make_shared<CountingSlot>(200);
+  table.Insert(2, replacement);
+  EXPECT_EQ(table.Find(2), replacement);
+}
+
+TEST(SlotTableTest, KeysOfOneShardStayApart) {
+  // 16 shards, so these ids all land in the shard of 3, and so does -13
+  // once cast to unsigned.
+  const int32_t ids[] = {3, 19, 35, 16 * 1000 + 3, -13};
+  SlotTable table;
+  for (int32_t id : ids) {
+    table.Insert(id, std::make_shared<CountingSlot>(id));
+  }
+  for (int32_t id : ids) {
+    ASSERT_NE(table.Find(id), nullptr) << id;
+    EXPECT_EQ(Find(table, id)->session_id(), id);
+  }
+  EXPECT_EQ(table.Find(51), nullptr);
+
+  EXPECT_TRUE(table.Erase(19));
+  EXPECT_EQ(table.Find(19), nullptr);
+  for (int32_t id : {3, 35, 16 * 1000 + 3, -13}) {
+    EXPECT_EQ(Find(table, id)->session_id(), id);
+  }
+}
+
+TEST(SlotTableTest, FoundSlotOutlivesItsErase) {
+  SlotTable table;
+  table.Insert(7, std::make_shared<CountingSlot>(7));
+  std::shared_ptr<CountingSlot> slot = Find(table, 7);
+  std::weak_ptr<CountingSlot> watch = slot;
+  EXPECT_TRUE(table.Erase(7));
+  // pulled during its dispatch, the slot still gets that message.
+  slot->OnMessage("{}", "CDP");
+  EXPECT_EQ(slot->session_id(), 7);
+  EXPECT_EQ(slot->messages(), 1);
+  slot.reset();
+  EXPECT_TRUE(watch.expired());
+}
+
+TEST(SlotTableTest, FindsWhileOtherThreadsInsertAndErase) {
+  const int32_t kStable = 32;
+  const int kRounds = 2000;
+  SlotTable table;
+  for (int32_t id = 1; id <= kStable; ++id) {
+    table.Insert(id, std::make_shared<CountingSlot>(id));
+  }
+  std::atomic<bool> mutating(true);
+  std::atomic<int> invalid(0);
+
+  // writers plug and pull sessions in the shards of the stable ones.
+  std::vector<std::thread> writers;
+  for (int w = 0; w < 2; ++w) {
+    writers.emplace_back([&table, w]() {
+      for (int round = 0; round < kRounds; ++round) {
+        int32_t id = 1000 + w * kRounds + round;
+        table.Insert(id, std::make_shared<CountingSlot>(id));
+        if (round >= 4) {
+          table.Erase(id - 4);
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r) {
+    readers.emplace_back([&]() {
+      do {
+        for (int32_t id = 1; id <= kStable; ++id) {
+          std::shared_ptr<CountingSlot> slot = Find(table, id);
+          if (!slot || slot->session_id() != id) {
+            ++invalid;
+            continue;
+          }
+          slot->OnMessage("{}", "CDP");
+        }
+        // transient sessions are either there whole or not at all.
+        for (int32_t id = 1000; id < 1000 + 2 * kRounds; id += 97) {
+          std::shared_ptr<CountingSlot> slot = Find(table, id);
+          if (slot && slot->session_id() != id) {
+            ++invalid;
+          }
+        }
+      } while (mutating);
+    });
+  }
+
+  for (std::thread &writer : writers) {
+    writer.join();
+  }
+  mutating = false;
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(invalid.load(), 0);
+  for (int w = 0; w < 2; ++w) {
+    int32_t last = 1000 + w * kRounds + kRounds - 1;
+    for (int32_t id = last - 3; id <= last; ++id) {
+      EXPECT_NE(table.Find(id), nullptr) << id;
+    }
+    EXPECT_EQ(table.Find(last - 4), nullptr);
+  }
+  for (int32_t id = 1; id <= kStable; ++id) {
+    EXPECT_GT(Find(table, id)->messages(), 0) << id;
+  }
+}
+
+}  // namespace core
+}  // namespace debugrouter
@@ -70,6 +70,7 @@ SocketServerClient::SocketServerClient() {}
 void SocketServerClient::Init() {
   listener_ = std::make_shared<ConnectionListener>(shared_from_this());
   socket_server_ = socket_server::SocketServer::CreateSocketServer(listener_);
+  socket_server_->SetTransportStats(transport_stats_);
   socket_server_->Init();
 }
 
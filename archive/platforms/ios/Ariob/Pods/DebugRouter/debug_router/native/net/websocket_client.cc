@@ -77,9 +77,13 @@ core::ConnectionType WebSocketClient::GetType() {
 
 void WebSocketClient::Send(const std::string &data) {
   LOGI("WebSocketClient::Send.");
-  work_thread_.submit([this, data]() {
+  auto queued_time = transport_stats_->OnQueued(data.size());
+  work_thread_.submit([this, data, queued_time]() {
     if (current_task_) {
       current_task_->SendInternal(data);
+      transport_stats_->OnSent(data.size(), queued_time);
+    } else {
+      transport_stats_->OnDropped(data.size());
     }
   });
 }
@@ -6,6 +6,7 @@
 
 #include "debug_router/native/core/util.h"
 #include "debug_router/native/log/logging.h"
+#include "debug_router/native/protocol/binary_envelope.h"
 
 #if defined(_WIN32)
 #include <winsock2.h>
@@ -62,7 +63,10 @@ void WebSocketTask::SendInternal(const std::string &data) {
   uint8_t prefix[14];
   size_t prefix_len = 2;
 
-  prefix[0] = 1 /*OP_TEXT*/ | 0x80 /*FIN*/;
+  // binary envelopes are not UTF-8 and cannot go in text frames.
+  prefix[0] = (protocol::IsBinaryEnvelope(data) ? 2 /*OP_BINARY*/
+                                                : 1 /*OP_TEXT*/) |
+              0x80 /*FIN*/;
 
   if (payloadLen > 65535) {
     prefix[1] = 127;
@@ -6,7 +6,6 @@
 #define DEBUGROUTER_NATIVE_PROCESSOR_MESSAGE_ASSEMBLER_H_
 
 #include <string>
-#include <unordered_map>
 
 namespace debugrouter {
 namespace processor {
@@ -16,9 +15,6 @@ class MessageAssembler {
   static std::string AssembleDispatchDocumentUpdated();
   static std::string AssembleDispatchFrameNavigated(std::string url);
   static std::string AssembleDispatchScreencastVisibilityChanged(bool status);
-  static std::string AssembleScreenCastFrame(
-      int session_id, const std::string &data,
-      const std::unordered_map<std::string, float> &metadata);
 };
 
 }  // namespace processor
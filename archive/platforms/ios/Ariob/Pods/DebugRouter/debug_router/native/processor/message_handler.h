@@ -8,6 +8,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "debug_router/native/base/transport_stats.h"
+
 namespace debugrouter {
 namespace processor {
 
@@ -16,7 +18,6 @@ class MessageHandler {
   virtual ~MessageHandler() {}
   virtual std::string GetRoomId() = 0;
   virtual std::unordered_map<std::string, std::string> GetClientInfo() = 0;
-  virtual std::unordered_map<int, std::string> GetSessionList() = 0;
   virtual void OnMessage(const std::string &type, int session_id,
                          const std::string &message) = 0;
   virtual void SendMessage(const std::string &message) = 0;
@@ -26,6 +27,10 @@ class MessageHandler {
   virtual void ChangeRoomServer(const std::string &url,
                                 const std::string &room) = 0;
   virtual void ReportError(const std::string &error) = 0;
+  // State of the outbound queue of the current connection.
+  virtual base::TransportStats::Snapshot GetTransportStats() {
+    return base::TransportStats::Snapshot();
+  }
 };
 
 }  // namespace processor
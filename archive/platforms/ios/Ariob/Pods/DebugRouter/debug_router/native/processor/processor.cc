@@ -4,24 +4,162 @@
 
 #include "debug_router/native/processor/processor.h"
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "debug_router/native/log/logging.h"
+#include "debug_router/native/protocol/binary_envelope.h"
+#include "debug_router/native/protocol/envelope_scanner.h"
 #include "debug_router/native/protocol/events.h"
+#include "debug_router/native/thread/debug_router_executor.h"
 #include "json/reader.h"
 
 namespace debugrouter {
 namespace processor {
 
+namespace {
+
+constexpr const char *kScreencastFrameAck = "Page.screencastFrameAck";
+
+// Writes the Page.screencastFrame message of |frame| as a json object.
+void WriteScreencastFrame(const ScreencastFrame &frame,
+                          protocol::ProtocolWriter &writer) {
+  writer.StartObject();
+  writer.Key(protocol::kKeyMethod);
+  writer.String("Page.screencastFrame");
+  writer.Key(protocol::kKeyParams);
+  writer.StartObject();
+  writer.Key("data");
+  writer.String(frame.data->data(), frame.data->size());
+  writer.Key("metadata");
+  std::vector<const std::pair<const std::string, float> *> metadata;
+  metadata.reserve(frame.metadata.size());
+  for (const auto &item : frame.metadata) {
+    metadata.push_back(&item);
+  }
+  std::sort(metadata.begin(), metadata.end(),
+            [](const std::pair<const std::string, float> *lhs,
+               const std::pair<const std::string, float> *rhs) {
+              return lhs->first < rhs->first;
+            });
+  writer.StartObject();
+  for (const auto *item : metadata) {
+    writer.Key(item->first);
+    writer.Value(Json::Value(item->second));
+  }
+  writer.EndObject();
+  writer.Key("sessionId");
+  writer.Int(frame.session_id);
+  writer.EndObject();
+  writer.EndObject();
+}
+
+// Reads the top level "method" of a CDP message. Parsing stops as soon as
+// its value is known, so the params are neither read nor materialized.
+class MethodReader : public Json::StreamHandler {
+ public:
+  bool Read(const std::string &message, std::string &method) {
+    Json::StreamReader reader(*this);
+    reader.feed(message);
+    if (!found_) {
+      return false;
+    }
+    method.swap(method_);
+    return true;
+  }
+
+  bool onNull() override { return !is_method_; }
+  bool onBool(bool /*value*/) override { return !is_method_; }
+  bool onInt(Json::LargestInt /*value*/) override { return !is_method_; }
+  bool onUInt(Json::LargestUInt /*value*/) override { return !is_method_; }
+  bool onDouble(double /*value*/) override { return !is_method_; }
+  bool onString(const char *begin, const char *end) override {
+    if (!is_method_) {
+      return true;
+    }
+    method_.assign(begin, end);
+    found_ = true;
+    return false;
+  }
+  bool onStartObject() override {
+    ++depth_;
+    return !is_method_;
+  }
+  bool onKey(const char *begin, const char *end) override {
+    size_t size = static_cast<size_t>(end - begin);
+    is_method_ = depth_ == 1 && size == strlen(protocol::kKeyMethod) &&
+                 memcmp(begin, protocol::kKeyMethod, size) == 0;
+    return true;
+  }
+  bool onEndObject() override {
+    --depth_;
+    return true;
+  }
+  bool onStartArray() override {
+    ++depth_;
+    return !is_method_;
+  }
+  bool onEndArray() override {
+    --depth_;
+    return true;
+  }
+
+ private:
+  int depth_ = 0;
+  bool is_method_ = false;
+  bool found_ = false;
+  std::string method_;
+};
+
+// The CDP data of a Customized envelope carrying |frame_|. Like every other
+// CDP message the frame goes out as a json string, it is written into a
+// buffer reused by every frame on this thread rather than into message_.
+struct CustomData4ScreencastFrame : public protocol::CustomData4CDP {
+  std::shared_ptr<ScreencastFrame> frame_;
+
+  void Stringify(protocol::ProtocolWriter &writer) override {
+    static thread_local std::string message;
+    message.clear();
+    protocol::ProtocolWriter message_writer(message);
+    WriteScreencastFrame(*frame_, message_writer);
+
+    writer.StartObject();
+    writer.Key(protocol::kKeyClientId);
+    writer.Uint(client_id_);
+    writer.Key(protocol::kKeyMessage);
+    writer.String(message);
+    writer.Key(protocol::kKeySessionId);
+    writer.Int(session_id_);
+    writer.EndObject();
+  }
+};
+
+}  // namespace
+
 Processor::Processor(std::unique_ptr<MessageHandler> message_handler)
-    : message_handler_(std::move(message_handler)), is_reconnect_(false) {}
+    : message_handler_(std::move(message_handler)),
+      is_reconnect_(false),
+      session_flush_scheduled_(false),
+      session_delta_enabled_(false),
+      binary_envelope_(false) {}
 
 void Processor::Process(const std::string &message) {
-  Json::Reader reader;
-  Json::Value root;
 #if __cpp_exceptions >= 199711L
   try {
 #endif
+    if (protocol::IsBinaryEnvelope(message)) {
+      forwardBinary(message);
+      return;
+    }
+    if (forward(message)) {
+      return;
+    }
+    Json::Reader reader;
+    Json::Value root;
     reader.parse(message, root);
-    process(root);
+    process(root, message);
 #if __cpp_exceptions >= 199711L
   } catch (const std::exception &e) {
     std::string error_message;
@@ -33,65 +171,169 @@ void Processor::Process(const std::string &message) {
 #endif
 }
 
-void Processor::process(const Json::Value &root) {
+bool Processor::forward(const std::string &message) {
+  protocol::Envelope envelope;
+  if (!protocol::EnvelopeScanner::Scan(message, envelope) ||
+      !envelope.event.Equals(protocol::kRemoteDebugServerEvent4Custom) ||
+      !envelope.sender.IsInt() || !envelope.client_id.IsInt() ||
+      !envelope.session_id.IsInt()) {
+    return false;
+  }
+  std::string type;
+  if (!envelope.type.DecodeString(type)) {
+    return false;
+  }
+  protocol::CustomKind kind = protocol::CustomKindOf(type);
+  switch (kind) {
+    case protocol::CustomKind::kD2RStopAtEntry:
+    case protocol::CustomKind::kD2RStopLepusAtEntry:
+    case protocol::CustomKind::kOpenCard:
+    case protocol::CustomKind::kListSession:
+    case protocol::CustomKind::kMessageHandler:
+      return false;
+    default:
+      break;
+  }
+  std::string payload;
+  if (envelope.message.IsString()) {
+    payload = std::move(envelope.decoded_message);
+  } else if (envelope.message.IsObject()) {
+    payload.assign(envelope.message.begin, envelope.message.end);
+  } else {
+    return false;
+  }
+
+  bool is_cdp = kind == protocol::CustomKind::kCDP;
+  if (!is_cdp) {
+    LOGI("extension");
+  }
+  if (static_cast<protocol::RemoteDebugPrococolClientId>(
+          envelope.client_id.AsInt()) == client_id_) {
+    if (is_cdp) {
+      LOGI("CDP Message %s" << payload.c_str());
+    }
+    processMessage(type, envelope.session_id.AsInt(), payload);
+  }
+  return true;
+}
+
+void Processor::forwardBinary(const std::string &message) {
+  protocol::BinaryEnvelope envelope;
+  if (!protocol::DecodeBinaryEnvelope(message.data(), message.size(),
+                                      envelope)) {
+    LOGE("invalid binary envelope, size: " << message.size());
+    return;
+  }
+  // only CDP and extension messages are sent in binary envelopes.
+  protocol::CustomKind kind = protocol::CustomKindOf(envelope.type);
+  if (kind != protocol::CustomKind::kCDP &&
+      kind != protocol::CustomKind::kOther) {
+    LOGW("unexpected binary envelope type: " << envelope.type);
+    return;
+  }
+  if (envelope.client_id == client_id_) {
+    processMessage(envelope.type, envelope.session_id,
+                   std::string(envelope.message, envelope.message_size));
+  }
+}
+
+void Processor::process(const Json::Value &root, const std::string &message) {
   std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
-      protocol::RemoteDebugProtocol::Parse(root);
+      protocol::RemoteDebugProtocol::Parse(root, message);
   if (!body) {
     return;
   }
 
-  if (body->IsProtocolBody4Init()) {
-    auto init_data = body->AsInit();
-    client_id_ = init_data->client_id_;
-    if (client_id_ > 0) {
-      LOGI("registerDevice");
-      registerDevice();
+  switch (body->Kind()) {
+    case protocol::EventKind::kInit: {
+      auto init_data = body->AsInit();
+      client_id_ = init_data->client_id_;
+      session_delta_enabled_.store(false, std::memory_order_relaxed);
+      binary_envelope_.store(false, std::memory_order_relaxed);
+      screencast_pacer_.Reset();
+      screencast_quality_.Reset();
+      if (client_id_ > 0) {
+        LOGI("registerDevice");
+        registerDevice();
+      }
+      break;
     }
-  } else if (body->IsProtocolBody4Registered()) {
-    LOGI("joinRoom");
-    joinRoom();
-  } else if (body->IsProtocolBody4RoomJoined()) {
-    LOGI("get sessionList");
-    sessionList();
-  } else if (body->IsProtocolBody4ChangeRoomServer()) {
-    LOGI("changeRoomServer");
-    auto server_data = body->AsChangeRoomServer();
-    changeRoomServer(server_data->url_, server_data->room_id_);
-  } else if (body->IsProtocolBody4Custom()) {
-    auto custom = body->AsCustom();
-    if (custom->Is4CDP()) {
+    case protocol::EventKind::kRegistered: {
+      auto registered_data = body->AsRegistered();
+      bool binary = registered_data && registered_data->envelope_encoding_ ==
+                                           protocol::kEnvelopeEncodingCbor;
+      LOGI("envelope encoding: " << (binary ? "cbor" : "json"));
+      binary_envelope_.store(binary, std::memory_order_relaxed);
+      LOGI("joinRoom");
+      joinRoom();
+      break;
+    }
+    case protocol::EventKind::kRoomJoined:
+      LOGI("get sessionList");
+      sessionList();
+      break;
+    case protocol::EventKind::kChangeRoomServer: {
+      LOGI("changeRoomServer");
+      auto server_data = body->AsChangeRoomServer();
+      changeRoomServer(server_data->url_, server_data->room_id_);
+      break;
+    }
+    case protocol::EventKind::kCustom:
+      processCustom(body->AsCustom());
+      break;
+    default:
+      break;
+  }
+}
+
+void Processor::processCustom(
+    const std::shared_ptr<protocol::RemoteDebugProtocolBodyData4Custom>
+        &custom) {
+  switch (custom->Kind()) {
+    case protocol::CustomKind::kCDP: {
       auto cdp = custom->AsCDP();
       if (cdp->client_id_ == client_id_) {
         LOGI("CDP Message %s" << cdp->message_.c_str());
         processMessage("CDP", cdp->session_id_, cdp->message_);
       }
-    } else if (custom->Is4D2RStopAtEntry()) {
+      break;
+    }
+    case protocol::CustomKind::kD2RStopAtEntry:
       if (custom->client_id_ == client_id_) {
         processMessage(
             protocol::kRemoteDebugProtocolBodyData4Custom4D2RStopAtEntry, -1,
             custom->AsD2RStopAtEntry() ? "true" : "false");
       }
-    } else if (custom->Is4D2RStopLepusAtEntry()) {
+      break;
+    case protocol::CustomKind::kD2RStopLepusAtEntry:
       if (custom->client_id_ == client_id_) {
         processMessage(
             protocol::kRemoteDebugProtocolBodyData4Custom4D2RStopLepusAtEntry,
             -1, custom->AsD2RStopLepusAtEntry() ? "true" : "false");
       }
-    } else if (custom->Is4OpenCard()) {
+      break;
+    case protocol::CustomKind::kOpenCard:
       LOGI("openCard");
       openCard(custom->AsOpenCardData()->url);
-    } else if (custom->Is4ListSession()) {
+      break;
+    case protocol::CustomKind::kListSession:
       LOGI("FlushSessionList");
+      if (custom->list_session_data_ && custom->list_session_data_->delta_) {
+        session_delta_enabled_.store(true, std::memory_order_relaxed);
+      }
       FlushSessionList();
-    } else if (custom->Is4MessageHandler()) {
+      break;
+    case protocol::CustomKind::kMessageHandler:
       LOGI("HandleAppAction");
       HandleAppAction(custom);
-    } else {
+      break;
+    default: {
       LOGI("extension");
       auto ext = custom->AsExtension();
       if (ext->client_id_ == client_id_) {
         processMessage(custom->type_, ext->session_id_, ext->message_);
       }
+      break;
     }
   }
 }
@@ -110,12 +352,22 @@ std::string Processor::WrapCustomizedMessage(const std::string &type,
                                              const std::string &message,
                                              int mark, bool isObject) {
   // handle legacy message type
-  if (type == protocol::kRemoteDebugProtocolBodyData4Custom4R2DStopAtEntry ||
-      type ==
-          protocol::kRemoteDebugProtocolBodyData4Custom4R2DStopLepusAtEntry) {
+  protocol::CustomKind kind = protocol::CustomKindOf(type);
+  if (kind == protocol::CustomKind::kR2DStopAtEntry ||
+      kind == protocol::CustomKind::kR2DStopLepusAtEntry) {
     return wrapStopAtEntryMessage(type, message);
   }
 
+  if (binary_envelope_.load(std::memory_order_relaxed)) {
+    protocol::CustomData4CDP cdp_data;
+    cdp_data.client_id_ = client_id_;
+    cdp_data.session_id_ = session_id;
+    cdp_data.message_ = message;
+    std::string envelope;
+    protocol::EncodeBinaryEnvelope(type, client_id_, cdp_data, mark, envelope);
+    return envelope;
+  }
+
   std::shared_ptr<protocol::CustomData4CDP> cdp_data =
       std::make_shared<protocol::CustomData4CDP>();
   cdp_data->client_id_ = client_id_;
@@ -136,11 +388,14 @@ void Processor::SetIsReconnect(bool is_reconnect) {
 
 void Processor::registerDevice() {
   if (message_handler_) {
+    std::unordered_map<std::string, std::string> client_info =
+        message_handler_->GetClientInfo();
+    client_info[protocol::kKeyEnvelopeEncodings] =
+        protocol::kEnvelopeEncodingCbor;
     std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
         protocol::RemoteDebugProtocol::CreateProtocolBody4Register(
-            client_id_, message_handler_->GetClientInfo(), is_reconnect_);
-    message_handler_->SendMessage(
-        protocol::RemoteDebugProtocol::Stringify(body));
+            client_id_, std::move(client_info), is_reconnect_);
+    sendBody(body);
   }
 }
 
@@ -149,8 +404,7 @@ void Processor::joinRoom() {
     std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
         protocol::RemoteDebugProtocol::CreateProtocolBody4JoinRoom(
             message_handler_->GetRoomId());
-    message_handler_->SendMessage(
-        protocol::RemoteDebugProtocol::Stringify(body));
+    sendBody(body);
   }
 }
 
@@ -163,34 +417,83 @@ void Processor::reportError(const std::string &error) {
 
 void Processor::sessionList() {
   if (message_handler_) {
-    std::unique_ptr<protocol::CustomData4SessionList> session_list =
-        std::make_unique<protocol::CustomData4SessionList>();
-    Json::Reader reader;
-    Json::Value info;
-    for (const auto &pair : message_handler_->GetSessionList()) {
-      std::shared_ptr<protocol::SessionInfo> session_info =
-          std::make_shared<protocol::SessionInfo>();
-      session_info->session_id_ = pair.first;
-
-      std::string url;
-      if (reader.parse(pair.second, info)) {
-        session_info->type_ = info["type"].asString();
-        url = info["url"].asString();
-      } else {
-        url = pair.second;
-      }
-      if (url.compare(protocol::kInvalidTempalteUrl) == 0) {
-        continue;
-      }
-      session_info->url_ = url;
-      session_list->list_.push_back(session_info);
-    }
+    std::string digest;
+    std::shared_ptr<protocol::CustomData4SessionList> session_list =
+        sessions_.TakeList(digest);
     std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
         protocol::RemoteDebugProtocol::CreateProtocolBody4Custom(
             protocol::kRemoteDebugProtocolBodyData4Custom4SessionList,
             client_id_, std::move(session_list));
-    message_handler_->SendMessage(
-        protocol::RemoteDebugProtocol::Stringify(body));
+    if (session_delta_enabled_.load(std::memory_order_relaxed)) {
+      body->AsCustom()->session_digest_ = std::move(digest);
+    }
+    sendBody(body);
+  }
+}
+
+void Processor::OnSessionPlugged(int session_id, const std::string &type,
+                                 const std::string &url) {
+  if (sessions_.Add(session_id, type, url)) {
+    scheduleSessionFlush();
+  }
+}
+
+void Processor::OnSessionPulled(int session_id) {
+  screencast_pacer_.Remove(session_id);
+  if (sessions_.Remove(session_id)) {
+    scheduleSessionFlush();
+  }
+}
+
+void Processor::scheduleSessionFlush() {
+  if (session_flush_scheduled_.exchange(true)) {
+    return;
+  }
+  thread::DebugRouterExecutor::GetInstance().PostDelayed(
+      [this]() { flushSessionChanges(); }, kSessionListFlushDelay);
+}
+
+void Processor::flushSessionChanges() {
+  // cleared first, a change racing with this flush schedules the next one.
+  session_flush_scheduled_.store(false);
+  if (!message_handler_) {
+    return;
+  }
+  // peers that did not ask for deltas only understand SessionList.
+  if (!session_delta_enabled_.load(std::memory_order_relaxed)) {
+    sessionList();
+    return;
+  }
+  SessionRegistry::Delta delta = sessions_.TakeDelta();
+  if (delta.Empty()) {
+    return;
+  }
+  // the full list is smaller than a delta touching every session.
+  if (delta.Size() > sessions_.Size()) {
+    sessionList();
+    return;
+  }
+  if (!delta.removed.empty()) {
+    std::shared_ptr<protocol::CustomData4SessionRemoved> removed =
+        std::make_shared<protocol::CustomData4SessionRemoved>();
+    removed->session_ids_ = std::move(delta.removed);
+    std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
+        protocol::RemoteDebugProtocol::CreateProtocolBody4Custom(
+            protocol::kRemoteDebugProtocolBodyData4Custom4SessionRemoved,
+            client_id_, std::move(removed));
+    body->AsCustom()->session_digest_ = std::move(delta.digest_after_removed);
+    sendBody(body);
+  }
+  if (!delta.added.empty()) {
+    std::shared_ptr<protocol::CustomData4SessionList> added =
+        std::make_shared<protocol::CustomData4SessionList>();
+    added->list_ = std::move(delta.added);
+    std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
+        protocol::RemoteDebugProtocol::CreateProtocolBody4Custom(
+            protocol::kRemoteDebugProtocolBodyData4Custom4SessionAdded,
+            client_id_, std::move(added));
+    body->AsCustom()->session_digest_ = std::move(delta.digest);
+    sendBody(body);
   }
 }
 
@@ -200,8 +503,7 @@ void Processor::changeRoomServer(const std::string &url,
     std::shared_ptr<protocol::RemoteDebugProtocolBody> body =
         protocol::RemoteDebugProtocol::CreateProtocolBody4ChangeRoomServerAck(
             client_id_);
-    message_handler_->SendMessage(
-        protocol::RemoteDebugProtocol::Stringify(body));
+    sendBody(body);
 
     message_handler_->ChangeRoomServer(url, room);
   }
@@ -236,7 +538,7 @@ void Processor::HandleAppAction(
     error[protocol::kKeyCode] = kDebugRouterErrorCode;
     error[protocol::kKeyMessage] = kDebugRouterErrorMessage;
     app_message_data_result = std::make_shared<protocol::AppMessageData>(
-        method, id, error.toStyledString(), protocol::kError);
+        method, id, Json::toCompactString(error), protocol::kError);
   }
   auto app_protocol_data = std::make_shared<protocol::AppProtocolData>(
       client_id_, app_message_data_result);
@@ -245,12 +547,94 @@ void Processor::HandleAppAction(
           protocol::kRemoteDebugProtocolBodyData4Custom4MessageHandler,
           custom_data->client_id_, app_protocol_data);
 
-  message_handler_->SendMessage(
-      protocol::RemoteDebugProtocol::Stringify(body_result));
+  sendBody(body_result);
+}
+
+void Processor::sendBody(
+    const std::shared_ptr<protocol::RemoteDebugProtocolBody> &body) const {
+  // transceivers copy the message into their own queue, so the envelope can
+  // be built in a buffer that is reused by every send on this thread.
+  static thread_local std::string buffer;
+  buffer.clear();
+  protocol::RemoteDebugProtocol::StringifyTo(body, -1, buffer);
+  message_handler_->SendMessage(buffer);
+}
+
+void Processor::SendScreencastFrame(std::shared_ptr<ScreencastFrame> frame) {
+  if (message_handler_) {
+    // the decision goes out with the frame.
+    screencast_quality_
+        .Update(message_handler_->GetTransportStats(),
+                std::chrono::steady_clock::now())
+        .FillMetadata(frame->metadata);
+  }
+  if (auto ready = screencast_pacer_.Submit(std::move(frame))) {
+    sendScreencastFrame(ready);
+  }
+}
+
+void Processor::sendScreencastFrame(
+    const std::shared_ptr<ScreencastFrame> &frame) {
+  if (!message_handler_) {
+    return;
+  }
+  if (binary_envelope_.load(std::memory_order_relaxed)) {
+    // the frame is written straight into the envelope, it is the only copy
+    // of the image made after it left the platform.
+    static thread_local std::string buffer;
+    buffer.clear();
+    buffer.reserve(frame->data->size() + 256);
+    size_t message_begin = protocol::StartBinaryEnvelope(
+        protocol::kRemoteDebugProtocolBodyData4CDP, client_id_, client_id_,
+        frame->session_id, -1, buffer);
+    protocol::ProtocolWriter writer(buffer);
+    WriteScreencastFrame(*frame, writer);
+    protocol::FinishBinaryEnvelope(message_begin, buffer);
+    message_handler_->SendMessage(buffer);
+  } else {
+    auto cdp_data = std::make_shared<CustomData4ScreencastFrame>();
+    cdp_data->client_id_ = client_id_;
+    cdp_data->session_id_ = frame->session_id;
+    cdp_data->frame_ = frame;
+    sendBody(protocol::RemoteDebugProtocol::CreateProtocolBody4Custom(
+        protocol::kRemoteDebugProtocolBodyData4CDP, client_id_, cdp_data));
+  }
+  int session_id = frame->session_id;
+  thread::DebugRouterExecutor::GetInstance().PostDelayed(
+      [this, session_id]() { expireScreencastFrame(session_id); },
+      kScreencastAckTimeout);
+}
+
+void Processor::expireScreencastFrame(int session_id) {
+  if (auto frame = screencast_pacer_.Expire(session_id)) {
+    LOGW("screencast frame of session " << session_id << " not acked");
+    sendScreencastFrame(frame);
+  }
+}
+
+void Processor::checkScreencastAck(const std::string &type, int session_id,
+                                   const std::string &message) {
+  // acks are only looked for while a frame waits for one, and only messages
+  // naming the method are parsed: the name may as well appear in the params
+  // of another method.
+  if (!screencast_pacer_.HasFrameInFlight() ||
+      protocol::CustomKindOf(type) != protocol::CustomKind::kCDP ||
+      message.find(kScreencastFrameAck) == std::string::npos) {
+    return;
+  }
+  std::string method;
+  if (!MethodReader().Read(message, method) || method != kScreencastFrameAck) {
+    return;
+  }
+  if (auto frame = screencast_pacer_.Ack(session_id)) {
+    thread::DebugRouterExecutor::GetInstance().Post(
+        [this, frame]() { sendScreencastFrame(frame); });
+  }
 }
 
 void Processor::processMessage(const std::string &type, int session_id,
                                const std::string &message) {
+  checkScreencastAck(type, session_id, message);
   if (message_handler_) {
     message_handler_->OnMessage(type, session_id, message);
   }
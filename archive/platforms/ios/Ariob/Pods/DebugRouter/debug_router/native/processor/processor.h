@@ -5,9 +5,14 @@
 #ifndef DEBUGROUTER_NATIVE_PROCESSOR_PROCESSOR_H_
 #define DEBUGROUTER_NATIVE_PROCESSOR_PROCESSOR_H_
 
+#include <atomic>
+#include <chrono>
 #include <string>
 
 #include "debug_router/native/processor/message_handler.h"
+#include "debug_router/native/processor/screencast_pacer.h"
+#include "debug_router/native/processor/screencast_quality_controller.h"
+#include "debug_router/native/processor/session_registry.h"
 #include "debug_router/native/protocol/protocol.h"
 
 namespace debugrouter {
@@ -15,6 +20,9 @@ namespace processor {
 
 constexpr const char *kDebugRouterErrorMessage = "DebugRouterError";
 constexpr int kDebugRouterErrorCode = -3;
+// plugs and pulls within this window are sent together, views are usually
+// created in bursts on startup.
+constexpr std::chrono::milliseconds kSessionListFlushDelay(50);
 
 class Processor {
  public:
@@ -23,7 +31,15 @@ class Processor {
   std::string WrapCustomizedMessage(const std::string &type, int session_id,
                                     const std::string &message, int mark,
                                     bool isObject = false);
+  // Sends the whole session list now.
   void FlushSessionList();
+  // Record a change of the session list, sent after kSessionListFlushDelay.
+  void OnSessionPlugged(int session_id, const std::string &type,
+                        const std::string &url);
+  void OnSessionPulled(int session_id);
+  // Sends a Page.screencastFrame, paced by ScreencastPacer. The envelope is
+  // written directly around the image, as json or in a binary envelope.
+  void SendScreencastFrame(std::shared_ptr<ScreencastFrame> frame);
   void SetIsReconnect(bool is_reconnect);
 
  private:
@@ -31,6 +47,12 @@ class Processor {
   void joinRoom();
   void reportError(const std::string &error);
   void sessionList();
+  void scheduleSessionFlush();
+  void flushSessionChanges();
+  void checkScreencastAck(const std::string &type, int session_id,
+                          const std::string &message);
+  void sendScreencastFrame(const std::shared_ptr<ScreencastFrame> &frame);
+  void expireScreencastFrame(int session_id);
   void changeRoomServer(const std::string &url, const std::string &room);
   void openCard(const std::string &url);
   void processMessage(const std::string &type, int session_id,
@@ -40,12 +62,30 @@ class Processor {
           custom_data);
   std::string wrapStopAtEntryMessage(const std::string &type,
                                      const std::string &message) const;
+  void sendBody(
+      const std::shared_ptr<protocol::RemoteDebugProtocolBody> &body) const;
 
   debugrouter::protocol::RemoteDebugPrococolClientId client_id_;
   std::unique_ptr<MessageHandler> message_handler_;
   bool is_reconnect_;
+  SessionRegistry sessions_;
+  std::atomic<bool> session_flush_scheduled_;
+  // set once the peer asks for deltas, reset on every new connection.
+  std::atomic<bool> session_delta_enabled_;
+  // CDP and extension messages are sent in binary envelopes, negotiated on
+  // Register and reset on every new connection.
+  std::atomic<bool> binary_envelope_;
+  ScreencastPacer screencast_pacer_;
+  ScreencastQualityController screencast_quality_;
 
-  void process(const Json::Value &root);
+  void process(const Json::Value &root, const std::string &message);
+  void processCustom(
+      const std::shared_ptr<protocol::RemoteDebugProtocolBodyData4Custom>
+          &custom);
+  // Routes CDP and extension messages straight from the raw envelope,
+  // returns false if the message needs the full Json::Reader path.
+  bool forward(const std::string &message);
+  void forwardBinary(const std::string &message);
 };
 
 }  // namespace processor
@@ -0,0 +1,98 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "debug_router/native/processor/processor.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+class NullMessageHandler : public MessageHandler {
+ public:
+  std::string GetRoomId() override { return ""; }
+  std::unordered_map<std::string, std::string> GetClientInfo() override {
+    return {};
+  }
+  void OnMessage(const std::string &type, int session_id,
+                 const std::string &message) override {}
+  void SendMessage(const std::string &message) override {
+    benchmark::DoNotOptimize(message.data());
+  }
+  void OpenCard(const std::string &url) override {}
+  std::string HandleAppAction(const std::string &method,
+                              const std::string &params) override {
+    return "";
+  }
+  void ChangeRoomServer(const std::string &url,
+                        const std::string &room) override {}
+  void ReportError(const std::string &error) override {}
+};
+
+const char kAck[] =
+    "{\"event\":\"Customized\",\"data\":{\"type\":\"CDP\",\"sender\":5,"
+    "\"data\":{\"client_id\":5,\"session_id\":1,\"message\":\"{\\\"id\\\":9,"
+    "\\\"method\\\":\\\"Page.screencastFrameAck\\\",\\\"params\\\":"
+    "{\\\"sessionId\\\":1}}\"}}}";
+
+std::shared_ptr<const std::string> FrameData(size_t size) {
+  std::string data(size, 'A');
+  for (size_t i = 0; i < size; i += 7) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  return std::make_shared<const std::string>(std::move(data));
+}
+
+// How frames went out before they were written in place: a Json::Value
+// tree serialized with toStyledString(), then wrapped as a CDP message.
+void BM_ScreencastFrameJsonValue(benchmark::State &state) {
+  Processor processor(std::make_unique<NullMessageHandler>());
+  processor.Process("{\"event\":\"Initialize\",\"data\":5}");
+  std::shared_ptr<const std::string> data =
+      FrameData(static_cast<size_t>(state.range(0)));
+  NullMessageHandler handler;
+  for (auto _ : state) {
+    Json::Value content;
+    content["method"] = "Page.screencastFrame";
+    content["params"]["data"] = *data;
+    content["params"]["metadata"]["pageScaleFactor"] = 1.0f;
+    content["params"]["metadata"]["offsetTop"] = 0.0f;
+    content["params"]["sessionId"] = 1;
+    handler.SendMessage(processor.WrapCustomizedMessage(
+        "CDP", 1, content.toStyledString(), -1));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(BM_ScreencastFrameJsonValue)->Arg(64 << 10)->Arg(512 << 10);
+
+// Processor::SendScreencastFrame, acked after every frame.
+void BM_ScreencastFrameInPlace(benchmark::State &state) {
+  Processor processor(std::make_unique<NullMessageHandler>());
+  processor.Process("{\"event\":\"Initialize\",\"data\":5}");
+  std::shared_ptr<const std::string> data =
+      FrameData(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto frame = std::make_shared<ScreencastFrame>();
+    frame->session_id = 1;
+    frame->data = data;
+    frame->metadata["pageScaleFactor"] = 1.0f;
+    frame->metadata["offsetTop"] = 0.0f;
+    processor.SendScreencastFrame(std::move(frame));
+    processor.Process(kAck);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(BM_ScreencastFrameInPlace)->Arg(64 << 10)->Arg(512 << 10);
+
+}  // namespace
+
+}  // namespace processor
+}  // namespace debugrouter
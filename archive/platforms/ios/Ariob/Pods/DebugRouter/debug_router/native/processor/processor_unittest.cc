@@ -0,0 +1,203 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/processor.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "debug_router/native/protocol/binary_envelope.h"
+#include "debug_router/native/thread/debug_router_executor.h"
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+constexpr int kClientId = 5;
+constexpr int kSessionId = 1;
+
+class RecordingMessageHandler : public MessageHandler {
+ public:
+  std::string GetRoomId() override { return "room"; }
+  std::unordered_map<std::string, std::string> GetClientInfo() override {
+    return {};
+  }
+  void OnMessage(const std::string &type, int session_id,
+                 const std::string &message) override {}
+  void SendMessage(const std::string &message) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (protocol::IsBinaryEnvelope(message)) {
+      binary_messages_.push_back(message);
+      condition_.notify_all();
+      return;
+    }
+    Json::Value root;
+    // JoinRoom carries the room id as its data.
+    if (Json::Reader().parse(message, root, false) &&
+        root["data"].isObject() && root["data"]["type"] == "CDP") {
+      cdp_messages_.push_back(root["data"]["data"]);
+      condition_.notify_all();
+    }
+  }
+  void OpenCard(const std::string &url) override {}
+  std::string HandleAppAction(const std::string &method,
+                              const std::string &params) override {
+    return "";
+  }
+  void ChangeRoomServer(const std::string &url,
+                        const std::string &room) override {}
+  void ReportError(const std::string &error) override {}
+
+  // Waits until |count| CDP envelopes were sent, returns all of them.
+  std::vector<Json::Value> WaitForCDPMessages(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait_for(lock, std::chrono::milliseconds(500), [&]() {
+      return cdp_messages_.size() >= count;
+    });
+    return cdp_messages_;
+  }
+
+  // Waits until |count| binary envelopes were sent, returns all of them.
+  std::vector<std::string> WaitForBinaryMessages(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait_for(lock, std::chrono::milliseconds(500), [&]() {
+      return binary_messages_.size() >= count;
+    });
+    return binary_messages_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<Json::Value> cdp_messages_;
+  std::vector<std::string> binary_messages_;
+};
+
+std::string CDPEnvelope(const std::string &message) {
+  Json::Value root(Json::objectValue);
+  root["event"] = "Customized";
+  root["data"]["type"] = "CDP";
+  root["data"]["sender"] = kClientId;
+  root["data"]["data"]["client_id"] = kClientId;
+  root["data"]["data"]["session_id"] = kSessionId;
+  root["data"]["data"]["message"] = message;
+  return Json::FastWriter().write(root);
+}
+
+std::shared_ptr<ScreencastFrame> MakeFrame(const std::string &data) {
+  auto frame = std::make_shared<ScreencastFrame>();
+  frame->session_id = kSessionId;
+  frame->data = std::make_shared<const std::string>(data);
+  frame->metadata["offsetTop"] = 0;
+  frame->metadata["pageScaleFactor"] = 1;
+  return frame;
+}
+
+class ProcessorTest : public ::testing::Test {
+ protected:
+  // the executor can only be started once per process.
+  static void SetUpTestSuite() {
+    thread::DebugRouterExecutor::GetInstance().Start();
+  }
+
+  void SetUp() override {
+    handler_ = new RecordingMessageHandler();
+    // delayed expiries posted to the shared executor keep pointing at the
+    // processor, so it is never destroyed.
+    processor_ = new Processor(std::unique_ptr<MessageHandler>(handler_));
+    processor_->Process("{\"event\":\"Initialize\",\"data\":5}");
+  }
+
+  RecordingMessageHandler *handler_;
+  Processor *processor_;
+};
+
+}  // namespace
+
+// As before frames were written in place, the CDP message is a json string.
+TEST_F(ProcessorTest, ScreencastFrameIsSentAsJsonString) {
+  processor_->SendScreencastFrame(MakeFrame("aGVsbG8="));
+  std::vector<Json::Value> sent = handler_->WaitForCDPMessages(1);
+  ASSERT_EQ(sent.size(), 1u);
+  EXPECT_EQ(sent[0]["client_id"].asInt(), kClientId);
+  EXPECT_EQ(sent[0]["session_id"].asInt(), kSessionId);
+  ASSERT_TRUE(sent[0]["message"].isString());
+
+  Json::Value message;
+  ASSERT_TRUE(
+      Json::Reader().parse(sent[0]["message"].asString(), message, false));
+  EXPECT_EQ(message["method"], "Page.screencastFrame");
+  EXPECT_EQ(message["params"]["data"], "aGVsbG8=");
+  EXPECT_EQ(message["params"]["sessionId"].asInt(), kSessionId);
+  EXPECT_EQ(message["params"]["metadata"]["pageScaleFactor"].asDouble(), 1);
+}
+
+TEST_F(ProcessorTest, OnlyTheAckMethodReleasesTheNextFrame) {
+  processor_->SendScreencastFrame(MakeFrame("first"));
+  processor_->SendScreencastFrame(MakeFrame("second"));
+  ASSERT_EQ(handler_->WaitForCDPMessages(1).size(), 1u);
+
+  // names the ack method without being one.
+  processor_->Process(CDPEnvelope(
+      "{\"id\":3,\"method\":\"Runtime.evaluate\",\"params\":{\"expression\":"
+      "\"send('Page.screencastFrameAck')\"}}"));
+  // only the top level method counts.
+  processor_->Process(CDPEnvelope(
+      "{\"id\":4,\"params\":{\"method\":\"Page.screencastFrameAck\"},"
+      "\"method\":\"Runtime.evaluate\"}"));
+  EXPECT_EQ(handler_->WaitForCDPMessages(2).size(), 1u);
+
+  processor_->Process(CDPEnvelope(
+      "{\"id\":5,\"method\":\"Page.screencastFrameAck\",\"params\":"
+      "{\"sessionId\":1}}"));
+  std::vector<Json::Value> sent = handler_->WaitForCDPMessages(2);
+  ASSERT_EQ(sent.size(), 2u);
+  Json::Value message;
+  ASSERT_TRUE(
+      Json::Reader().parse(sent[1]["message"].asString(), message, false));
+  EXPECT_EQ(message["params"]["data"], "second");
+}
+
+TEST_F(ProcessorTest, RegisteredCborSwitchesOutboundMessages) {
+  processor_->Process(
+      "{\"event\":\"Registered\",\"data\":{\"envelopeEncoding\":\"cbor\"}}");
+
+  std::string wrapped =
+      processor_->WrapCustomizedMessage("CDP", kSessionId, "{\"id\":1}", 3);
+  protocol::BinaryEnvelope envelope;
+  ASSERT_TRUE(
+      protocol::DecodeBinaryEnvelope(wrapped.data(), wrapped.size(), envelope));
+  EXPECT_EQ(envelope.type, "CDP");
+  EXPECT_EQ(envelope.client_id, static_cast<uint32_t>(kClientId));
+  EXPECT_EQ(envelope.session_id, kSessionId);
+  EXPECT_EQ(envelope.mark, 3);
+  EXPECT_EQ(std::string(envelope.message, envelope.message_size), "{\"id\":1}");
+
+  processor_->SendScreencastFrame(MakeFrame("aGVsbG8="));
+  std::vector<std::string> sent = handler_->WaitForBinaryMessages(1);
+  ASSERT_EQ(sent.size(), 1u);
+  ASSERT_TRUE(
+      protocol::DecodeBinaryEnvelope(sent[0].data(), sent[0].size(), envelope));
+  Json::Value message;
+  ASSERT_TRUE(Json::Reader().parse(
+      envelope.message, envelope.message + envelope.message_size, message,
+      false));
+  EXPECT_EQ(message["method"], "Page.screencastFrame");
+  EXPECT_EQ(message["params"]["data"], "aGVsbG8=");
+  EXPECT_TRUE(handler_->WaitForCDPMessages(1).empty());
+
+  // a new connection starts over with json.
+  processor_->Process("{\"event\":\"Initialize\",\"data\":5}");
+  wrapped = processor_->WrapCustomizedMessage("CDP", kSessionId, "{}", -1);
+  EXPECT_FALSE(protocol::IsBinaryEnvelope(wrapped));
+}
+
+}  // namespace processor
+}  // namespace debugrouter
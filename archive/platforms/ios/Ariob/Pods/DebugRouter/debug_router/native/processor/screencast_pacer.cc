@@ -0,0 +1,79 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/screencast_pacer.h"
+
+#include <utility>
+
+namespace debugrouter {
+namespace processor {
+
+ScreencastPacer::ScreencastPacer() : in_flight_count_(0) {}
+
+std::shared_ptr<ScreencastFrame> ScreencastPacer::Submit(
+    std::shared_ptr<ScreencastFrame> frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  State &state = sessions_[frame->session_id];
+  if (state.in_flight) {
+    state.pending = std::move(frame);
+    return nullptr;
+  }
+  SetInFlight(state, true);
+  state.sent_time = std::chrono::steady_clock::now();
+  return frame;
+}
+
+std::shared_ptr<ScreencastFrame> ScreencastPacer::Ack(int session_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(session_id);
+  if (it == sessions_.end()) {
+    return nullptr;
+  }
+  return TakePending(it->second);
+}
+
+std::shared_ptr<ScreencastFrame> ScreencastPacer::Expire(int session_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(session_id);
+  if (it == sessions_.end() || !it->second.in_flight ||
+      std::chrono::steady_clock::now() - it->second.sent_time <
+          kScreencastAckTimeout) {
+    return nullptr;
+  }
+  return TakePending(it->second);
+}
+
+void ScreencastPacer::Remove(int session_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(session_id);
+  if (it != sessions_.end()) {
+    SetInFlight(it->second, false);
+    sessions_.erase(it);
+  }
+}
+
+void ScreencastPacer::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sessions_.clear();
+  in_flight_count_.store(0, std::memory_order_relaxed);
+}
+
+std::shared_ptr<ScreencastFrame> ScreencastPacer::TakePending(State &state) {
+  if (!state.pending) {
+    SetInFlight(state, false);
+    return nullptr;
+  }
+  state.sent_time = std::chrono::steady_clock::now();
+  return std::move(state.pending);
+}
+
+void ScreencastPacer::SetInFlight(State &state, bool in_flight) {
+  if (state.in_flight != in_flight) {
+    state.in_flight = in_flight;
+    in_flight_count_.fetch_add(in_flight ? 1 : -1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace processor
+}  // namespace debugrouter
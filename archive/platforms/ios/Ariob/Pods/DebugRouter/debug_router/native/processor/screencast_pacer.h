@@ -0,0 +1,76 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROCESSOR_SCREENCAST_PACER_H_
+#define DEBUGROUTER_NATIVE_PROCESSOR_SCREENCAST_PACER_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace debugrouter {
+namespace processor {
+
+// a frame still not acked after this long is considered lost, so a frontend
+// that does not ack does not freeze the screencast.
+constexpr std::chrono::milliseconds kScreencastAckTimeout(1000);
+
+struct ScreencastFrame {
+  int session_id;
+  // base64 image, shared instead of copied while the frame waits.
+  std::shared_ptr<const std::string> data;
+  std::unordered_map<std::string, float> metadata;
+};
+
+/*
+ * Paces the Page.screencastFrame of each session to the rate the frontend
+ * acks them with Page.screencastFrameAck.
+ *
+ * At most one frame per session is in flight. Frames submitted meanwhile
+ * replace each other, only the latest one is sent once the frame in flight
+ * is acked.
+ */
+class ScreencastPacer {
+ public:
+  ScreencastPacer();
+
+  // Returns |frame| if it can be sent now, nullptr if it waits.
+  std::shared_ptr<ScreencastFrame> Submit(
+      std::shared_ptr<ScreencastFrame> frame);
+  // Returns the frame waiting for this ack, if any, which is now in flight.
+  std::shared_ptr<ScreencastFrame> Ack(int session_id);
+  // To be called kScreencastAckTimeout after a frame is sent: if it is still
+  // not acked, handles it as if it was.
+  std::shared_ptr<ScreencastFrame> Expire(int session_id);
+
+  void Remove(int session_id);
+  void Reset();
+
+  // Cheap check before looking for acks in incoming messages.
+  bool HasFrameInFlight() const {
+    return in_flight_count_.load(std::memory_order_relaxed) > 0;
+  }
+
+ private:
+  struct State {
+    bool in_flight = false;
+    std::chrono::steady_clock::time_point sent_time;
+    std::shared_ptr<ScreencastFrame> pending;
+  };
+
+  void SetInFlight(State &state, bool in_flight);
+  std::shared_ptr<ScreencastFrame> TakePending(State &state);
+
+  std::mutex mutex_;
+  std::unordered_map<int, State> sessions_;
+  std::atomic<int> in_flight_count_;
+};
+
+}  // namespace processor
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROCESSOR_SCREENCAST_PACER_H_
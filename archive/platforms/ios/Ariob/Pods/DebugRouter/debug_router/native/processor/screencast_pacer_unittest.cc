@@ -0,0 +1,71 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/screencast_pacer.h"
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+std::shared_ptr<ScreencastFrame> MakeFrame(int session_id) {
+  auto frame = std::make_shared<ScreencastFrame>();
+  frame->session_id = session_id;
+  return frame;
+}
+
+}  // namespace
+
+TEST(ScreencastPacerTest, SendsOneFramePerAck) {
+  ScreencastPacer pacer;
+  EXPECT_FALSE(pacer.HasFrameInFlight());
+  auto first = MakeFrame(1);
+  EXPECT_EQ(pacer.Submit(first), first);
+  EXPECT_TRUE(pacer.HasFrameInFlight());
+
+  EXPECT_EQ(pacer.Submit(MakeFrame(1)), nullptr);
+  auto latest = MakeFrame(1);
+  EXPECT_EQ(pacer.Submit(latest), nullptr);
+  // only the latest waiting frame is sent.
+  EXPECT_EQ(pacer.Ack(1), latest);
+  EXPECT_TRUE(pacer.HasFrameInFlight());
+  EXPECT_EQ(pacer.Ack(1), nullptr);
+  EXPECT_FALSE(pacer.HasFrameInFlight());
+}
+
+TEST(ScreencastPacerTest, PacesSessionsIndependently) {
+  ScreencastPacer pacer;
+  auto one = MakeFrame(1);
+  auto two = MakeFrame(2);
+  EXPECT_EQ(pacer.Submit(one), one);
+  EXPECT_EQ(pacer.Submit(two), two);
+  EXPECT_EQ(pacer.Ack(1), nullptr);
+  EXPECT_TRUE(pacer.HasFrameInFlight());
+  pacer.Remove(2);
+  EXPECT_FALSE(pacer.HasFrameInFlight());
+  EXPECT_EQ(pacer.Ack(2), nullptr);
+}
+
+TEST(ScreencastPacerTest, ExpiresOnlyAfterTheTimeout) {
+  ScreencastPacer pacer;
+  pacer.Submit(MakeFrame(1));
+  pacer.Submit(MakeFrame(1));
+  EXPECT_EQ(pacer.Expire(1), nullptr);
+  EXPECT_TRUE(pacer.HasFrameInFlight());
+}
+
+TEST(ScreencastPacerTest, ResetDropsEverything) {
+  ScreencastPacer pacer;
+  pacer.Submit(MakeFrame(1));
+  pacer.Submit(MakeFrame(1));
+  pacer.Reset();
+  EXPECT_FALSE(pacer.HasFrameInFlight());
+  auto frame = MakeFrame(1);
+  EXPECT_EQ(pacer.Submit(frame), frame);
+}
+
+}  // namespace processor
+}  // namespace debugrouter
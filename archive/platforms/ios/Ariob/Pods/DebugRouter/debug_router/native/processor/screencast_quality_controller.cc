@@ -0,0 +1,71 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/screencast_quality_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+constexpr double kMinLevel = 0.05;
+constexpr double kDecrease = 0.75;
+constexpr double kIncrease = 0.05;
+
+// Maps |level| in [begin, end] to [0, 1].
+double Ramp(double level, double begin, double end) {
+  return std::min(1.0, std::max(0.0, (level - begin) / (end - begin)));
+}
+
+}  // namespace
+
+void ScreencastQuality::FillMetadata(
+    std::unordered_map<std::string, float> &metadata) const {
+  metadata[kScreencastMetadataMaxFps] = static_cast<float>(max_fps);
+  metadata[kScreencastMetadataScale] = scale;
+  metadata[kScreencastMetadataQuality] = static_cast<float>(quality);
+}
+
+ScreencastQualityController::ScreencastQualityController() : level_(1) {}
+
+ScreencastQuality ScreencastQualityController::Update(
+    const base::TransportStats::Snapshot &stats,
+    std::chrono::steady_clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (now - last_change_ >= kScreencastQualityPeriod) {
+    std::chrono::milliseconds delay = stats.ExpectedDelay();
+    if (delay > kScreencastTargetLatency) {
+      level_ = std::max(kMinLevel, level_ * kDecrease);
+      last_change_ = now;
+    } else if (delay * 2 < kScreencastTargetLatency && level_ < 1) {
+      level_ = std::min(1.0, level_ + kIncrease);
+      last_change_ = now;
+    }
+  }
+  return QualityOf(level_);
+}
+
+void ScreencastQualityController::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  level_ = 1;
+  last_change_ = std::chrono::steady_clock::time_point();
+}
+
+ScreencastQuality ScreencastQualityController::QualityOf(double level) {
+  ScreencastQuality quality;
+  quality.quality =
+      static_cast<int>(std::lround(40 + 50 * Ramp(level, 0.6, 1)));
+  // in steps of 5%, producers usually cache buffers of a given size.
+  quality.scale = static_cast<float>(
+      std::round((0.4 + 0.6 * Ramp(level, 0.25, 0.6)) * 20) / 20);
+  quality.max_fps =
+      static_cast<int>(std::lround(5 + 25 * Ramp(level, kMinLevel, 0.25)));
+  return quality;
+}
+
+}  // namespace processor
+}  // namespace debugrouter
@@ -0,0 +1,69 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROCESSOR_SCREENCAST_QUALITY_CONTROLLER_H_
+#define DEBUGROUTER_NATIVE_PROCESSOR_SCREENCAST_QUALITY_CONTROLLER_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "debug_router/native/base/transport_stats.h"
+
+namespace debugrouter {
+namespace processor {
+
+// queueing delay of the transport the controller aims to stay under.
+constexpr std::chrono::milliseconds kScreencastTargetLatency(150);
+// how long a decision is given to show in the stats before the next one.
+constexpr std::chrono::milliseconds kScreencastQualityPeriod(250);
+
+// Metadata of a Page.screencastFrame telling the producer the quality to use
+// for the next frames, which the frontend may display as well.
+constexpr const char *kScreencastMetadataMaxFps = "maxFps";
+constexpr const char *kScreencastMetadataScale = "scale";
+constexpr const char *kScreencastMetadataQuality = "quality";
+
+struct ScreencastQuality {
+  int max_fps = 30;
+  // of the screen size, in (0, 1].
+  float scale = 1;
+  // JPEG quality, in [0, 100].
+  int quality = 90;
+
+  void FillMetadata(std::unordered_map<std::string, float> &metadata) const;
+};
+
+/*
+ * Adapts the screencast to the transport it goes through, so frames stay
+ * close to real time on a slow usb or websocket link instead of piling up in
+ * its queue.
+ *
+ * The state is a level in [kMinLevel, 1], lowered by a quarter when the
+ * expected queueing delay exceeds kScreencastTargetLatency and raised
+ * slowly while it stays under half of it (AIMD). JPEG quality gives in
+ * first, then scale, then frame rate, as the cheapest ones to lose.
+ */
+class ScreencastQualityController {
+ public:
+  ScreencastQualityController();
+
+  // Returns the quality to use from now on, given the transport state.
+  ScreencastQuality Update(const base::TransportStats::Snapshot &stats,
+                           std::chrono::steady_clock::time_point now);
+  void Reset();
+
+ private:
+  static ScreencastQuality QualityOf(double level);
+
+  std::mutex mutex_;
+  double level_;
+  std::chrono::steady_clock::time_point last_change_;
+};
+
+}  // namespace processor
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROCESSOR_SCREENCAST_QUALITY_CONTROLLER_H_
@@ -0,0 +1,187 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/screencast_quality_controller.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+// an hour after the clock's epoch, so the first update may change the level.
+const Clock::time_point kStart = Clock::time_point() + std::chrono::hours(1);
+
+base::TransportStats::Snapshot Delayed(milliseconds delay) {
+  base::TransportStats::Snapshot stats;
+  stats.queue_delay = delay;
+  return stats;
+}
+
+const base::TransportStats::Snapshot kCongested = Delayed(milliseconds(500));
+const base::TransportStats::Snapshot kIdle = Delayed(milliseconds(0));
+
+bool IsFull(const ScreencastQuality &quality) {
+  return quality.max_fps == 30 && quality.scale == 1 && quality.quality == 90;
+}
+
+bool IsLowest(const ScreencastQuality &quality) {
+  return quality.max_fps == 5 && quality.scale == 0.4f &&
+         quality.quality == 40;
+}
+
+// Lowers the level until it stops changing, one period apart, returns the
+// time of the last update.
+Clock::time_point LowerToTheFloor(ScreencastQualityController &controller,
+                                  Clock::time_point now) {
+  for (int i = 0; i < 100; ++i) {
+    now += kScreencastQualityPeriod;
+    if (IsLowest(controller.Update(kCongested, now))) {
+      break;
+    }
+  }
+  return now;
+}
+
+}  // namespace
+
+TEST(ScreencastQualityControllerTest, LowersOnlyOncePerPeriod) {
+  ScreencastQualityController controller;
+  ScreencastQuality first = controller.Update(kCongested, kStart);
+  EXPECT_LT(first.quality, 90);
+
+  // the first drop has not shown in the stats yet.
+  ScreencastQuality held = controller.Update(
+      kCongested, kStart + kScreencastQualityPeriod - milliseconds(1));
+  EXPECT_EQ(held.quality, first.quality);
+
+  ScreencastQuality second =
+      controller.Update(kCongested, kStart + kScreencastQualityPeriod);
+  EXPECT_LT(second.quality, first.quality);
+}
+
+TEST(ScreencastQualityControllerTest, StopsAtTheLowestLevel) {
+  ScreencastQualityController controller;
+  Clock::time_point now = LowerToTheFloor(controller, kStart);
+  ASSERT_TRUE(IsLowest(controller.Update(kCongested, now)));
+
+  for (int i = 0; i < 20; ++i) {
+    now += kScreencastQualityPeriod;
+    ScreencastQuality quality = controller.Update(kCongested, now);
+    EXPECT_TRUE(IsLowest(quality)) << quality.max_fps << " " << quality.scale
+                                   << " " << quality.quality;
+  }
+  // so a single good period raises it again.
+  now += kScreencastQualityPeriod;
+  EXPECT_GT(controller.Update(kIdle, now).max_fps, 5);
+}
+
+TEST(ScreencastQualityControllerTest, RaisesOnlyUnderHalfTheTarget) {
+  ScreencastQualityController controller;
+  Clock::time_point now = LowerToTheFloor(controller, kStart);
+
+  // between half the target and the target, the level holds.
+  const milliseconds holding[] = {kScreencastTargetLatency / 2,
+                                  kScreencastTargetLatency};
+  for (milliseconds delay : holding) {
+    now += kScreencastQualityPeriod;
+    EXPECT_TRUE(IsLowest(controller.Update(Delayed(delay), now)))
+        << delay.count();
+  }
+
+  now += kScreencastQualityPeriod;
+  ScreencastQuality raised = controller.Update(
+      Delayed(kScreencastTargetLatency / 2 - milliseconds(1)), now);
+  EXPECT_GT(raised.max_fps, 5);
+  // raised by a small step, unlike the drops.
+  EXPECT_EQ(raised.scale, 0.4f);
+  EXPECT_EQ(raised.quality, 40);
+
+  // not again within the period.
+  EXPECT_EQ(controller.Update(kIdle, now + kScreencastQualityPeriod / 2)
+                .max_fps,
+            raised.max_fps);
+
+  for (int i = 0; i < 100 && !IsFull(controller.Update(kIdle, now)); ++i) {
+    now += kScreencastQualityPeriod;
+  }
+  EXPECT_TRUE(IsFull(controller.Update(kIdle, now)));
+}
+
+TEST(ScreencastQualityControllerTest, GivesInQualityThenScaleThenFps) {
+  ScreencastQualityController controller;
+  std::vector<ScreencastQuality> steps;
+  Clock::time_point now = kStart;
+  for (int i = 0; i < 100; ++i) {
+    steps.push_back(controller.Update(kCongested, now));
+    if (IsLowest(steps.back())) {
+      break;
+    }
+    now += kScreencastQualityPeriod;
+  }
+  ASSERT_TRUE(IsLowest(steps.back()));
+
+  bool scale_lowered = false;
+  bool fps_lowered = false;
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const ScreencastQuality &step = steps[i];
+    if (step.scale < 1) {
+      scale_lowered = true;
+      EXPECT_EQ(step.quality, 40) << "step " << i;
+    }
+    if (step.max_fps < 30) {
+      fps_lowered = true;
+      EXPECT_EQ(step.scale, 0.4f) << "step " << i;
+    }
+    // scale moves in steps of 5%.
+    EXPECT_FLOAT_EQ(step.scale * 20, std::round(step.scale * 20));
+    if (i > 0) {
+      EXPECT_LE(step.quality, steps[i - 1].quality);
+      EXPECT_LE(step.scale, steps[i - 1].scale);
+      EXPECT_LE(step.max_fps, steps[i - 1].max_fps);
+    }
+  }
+  EXPECT_TRUE(scale_lowered);
+  EXPECT_TRUE(fps_lowered);
+  // quality alone gives in at first.
+  EXPECT_LT(steps[0].quality, 90);
+  EXPECT_EQ(steps[0].scale, 1);
+  EXPECT_EQ(steps[0].max_fps, 30);
+}
+
+TEST(ScreencastQualityControllerTest, ResetRestoresFullQuality) {
+  ScreencastQualityController controller;
+  Clock::time_point now = LowerToTheFloor(controller, kStart);
+  controller.Reset();
+  EXPECT_TRUE(IsFull(controller.Update(kIdle, now)));
+
+  // and forgets the last change, a new connection may drop right away.
+  EXPECT_LT(controller.Update(kCongested, now).quality, 90);
+}
+
+TEST(ScreencastQualityControllerTest, FillsTheFrameMetadata) {
+  ScreencastQuality quality;
+  quality.max_fps = 12;
+  quality.scale = 0.55f;
+  quality.quality = 61;
+  std::unordered_map<std::string, float> metadata = {{"offsetTop", 3}};
+  quality.FillMetadata(metadata);
+  EXPECT_EQ(metadata[kScreencastMetadataMaxFps], 12);
+  EXPECT_EQ(metadata[kScreencastMetadataScale], 0.55f);
+  EXPECT_EQ(metadata[kScreencastMetadataQuality], 61);
+  EXPECT_EQ(metadata["offsetTop"], 3);
+}
+
+}  // namespace processor
+}  // namespace debugrouter
@@ -0,0 +1,113 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/session_registry.h"
+
+#include <cstdio>
+#include <utility>
+
+#include "debug_router/native/protocol/events.h"
+#include "debug_router/native/protocol/md5.h"
+#include "debug_router/native/protocol/protocol_writer.h"
+
+namespace debugrouter {
+namespace processor {
+
+SessionRegistry::SessionRegistry() : digest_(0) {}
+
+bool SessionRegistry::Add(int session_id, const std::string &type,
+                          const std::string &url) {
+  if (url.compare(protocol::kInvalidTempalteUrl) == 0) {
+    return false;
+  }
+  std::shared_ptr<protocol::SessionInfo> info =
+      std::make_shared<protocol::SessionInfo>();
+  info->session_id_ = session_id;
+  info->type_ = type;
+  info->url_ = url;
+  uint64_t hash = HashEntry(*info);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(session_id);
+  if (it != sessions_.end()) {
+    digest_ -= it->second.hash;
+  }
+  digest_ += hash;
+  sessions_[session_id] = Entry{info, hash};
+  added_[session_id] = std::move(info);
+  return true;
+}
+
+bool SessionRegistry::Remove(int session_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sessions_.find(session_id);
+  if (it == sessions_.end()) {
+    return false;
+  }
+  digest_ -= it->second.hash;
+  sessions_.erase(it);
+  if (added_.erase(session_id) == 0) {
+    removed_.push_back(session_id);
+  }
+  return true;
+}
+
+SessionRegistry::Delta SessionRegistry::TakeDelta() {
+  Delta delta;
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t added_hash = 0;
+  delta.added.reserve(added_.size());
+  for (auto &pair : added_) {
+    added_hash += sessions_[pair.first].hash;
+    delta.added.push_back(std::move(pair.second));
+  }
+  delta.removed.swap(removed_);
+  added_.clear();
+  delta.digest_after_removed = DigestString(digest_ - added_hash);
+  delta.digest = DigestString(digest_);
+  return delta;
+}
+
+std::shared_ptr<protocol::CustomData4SessionList> SessionRegistry::TakeList(
+    std::string &digest) {
+  std::shared_ptr<protocol::CustomData4SessionList> list =
+      std::make_shared<protocol::CustomData4SessionList>();
+  std::lock_guard<std::mutex> lock(mutex_);
+  list->list_.reserve(sessions_.size());
+  for (const auto &pair : sessions_) {
+    list->list_.push_back(pair.second.info);
+  }
+  added_.clear();
+  removed_.clear();
+  digest = DigestString(digest_);
+  return list;
+}
+
+size_t SessionRegistry::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sessions_.size();
+}
+
+uint64_t SessionRegistry::HashEntry(const protocol::SessionInfo &info) {
+  std::string entry;
+  protocol::ProtocolWriter writer(entry);
+  protocol::StringifySessionInfo(info, writer);
+  entry.append(protocol::kSignatureSalt);
+  MD5 md5(entry);
+  uint64_t hash = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    hash = (hash << 8) | md5.digest[i];
+  }
+  return hash;
+}
+
+std::string SessionRegistry::DigestString(uint64_t digest) {
+  char buffer[17];
+  snprintf(buffer, sizeof(buffer), "%016llx",
+           static_cast<unsigned long long>(digest));
+  return std::string(buffer, 16);
+}
+
+}  // namespace processor
+}  // namespace debugrouter
@@ -0,0 +1,81 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROCESSOR_SESSION_REGISTRY_H_
+#define DEBUGROUTER_NATIVE_PROCESSOR_SESSION_REGISTRY_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "debug_router/native/protocol/protocol.h"
+
+namespace debugrouter {
+namespace processor {
+
+/*
+ * Sessions announced to the debug server, and the changes not sent yet.
+ *
+ * Changes between two flushes are coalesced: a session plugged and pulled
+ * before the next flush is never announced. Along with the list, the
+ * registry keeps a digest of it: the sum of the first 8 bytes (big endian)
+ * of md5(entry + salt) over every entry, where entry is the compact form of
+ * the session in SessionList. It is order independent and updated in
+ * constant time on every change, so peers applying deltas can tell they
+ * drifted and ask for the full list again.
+ */
+class SessionRegistry {
+ public:
+  struct Delta {
+    std::vector<std::shared_ptr<protocol::SessionInfo>> added;
+    std::vector<int> removed;
+    // digest once |removed| is applied, and once |added| is applied too.
+    std::string digest_after_removed;
+    std::string digest;
+
+    bool Empty() const { return added.empty() && removed.empty(); }
+    size_t Size() const { return added.size() + removed.size(); }
+  };
+
+  SessionRegistry();
+
+  // Both return false if the list is unchanged: sessions with an invalid
+  // template url are not listed.
+  bool Add(int session_id, const std::string &type, const std::string &url);
+  bool Remove(int session_id);
+
+  // Takes the changes since the last Take*() call.
+  Delta TakeDelta();
+  // Takes the whole list, pending changes are dropped as the list covers
+  // them.
+  std::shared_ptr<protocol::CustomData4SessionList> TakeList(
+      std::string &digest);
+
+  size_t Size();
+
+ private:
+  struct Entry {
+    std::shared_ptr<protocol::SessionInfo> info;
+    uint64_t hash;
+  };
+
+  static uint64_t HashEntry(const protocol::SessionInfo &info);
+  static std::string DigestString(uint64_t digest);
+
+  std::mutex mutex_;
+  std::map<int, Entry> sessions_;
+  // pending changes, session ids are never reused so an id is in at most
+  // one of them.
+  std::map<int, std::shared_ptr<protocol::SessionInfo>> added_;
+  std::vector<int> removed_;
+  uint64_t digest_;
+};
+
+}  // namespace processor
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROCESSOR_SESSION_REGISTRY_H_
@@ -0,0 +1,59 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "debug_router/native/processor/session_registry.h"
+#include "debug_router/native/protocol/protocol_writer.h"
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+// A startup plugging state.range(0) views one after the other. The old code
+// sent the whole list after every plug.
+void BM_SessionListPerPlug(benchmark::State &state) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    SessionRegistry registry;
+    for (int i = 0; i < state.range(0); ++i) {
+      registry.Add(i, "lynx", "https://example.com/page" + std::to_string(i));
+      std::string digest;
+      std::string out;
+      protocol::ProtocolWriter writer(out);
+      registry.TakeList(digest)->Stringify(writer);
+      bytes += out.size();
+    }
+  }
+  state.counters["bytes_sent"] = benchmark::Counter(
+      static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SessionListPerPlug)->Arg(8)->Arg(64);
+
+// The same startup with the plugs coalesced into a single SessionAdded.
+void BM_SessionAddedPerFlush(benchmark::State &state) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    SessionRegistry registry;
+    for (int i = 0; i < state.range(0); ++i) {
+      registry.Add(i, "lynx", "https://example.com/page" + std::to_string(i));
+    }
+    protocol::CustomData4SessionList added;
+    added.list_ = registry.TakeDelta().added;
+    std::string out;
+    protocol::ProtocolWriter writer(out);
+    added.Stringify(writer);
+    bytes += out.size();
+  }
+  state.counters["bytes_sent"] = benchmark::Counter(
+      static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SessionAddedPerFlush)->Arg(8)->Arg(64);
+
+}  // namespace
+
+}  // namespace processor
+}  // namespace debugrouter
@@ -0,0 +1,100 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/processor/session_registry.h"
+
+#include "debug_router/native/protocol/events.h"
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace processor {
+
+namespace {
+
+const char kEmptyDigest[] = "0000000000000000";
+
+std::string ListDigest(SessionRegistry &registry) {
+  std::string digest;
+  registry.TakeList(digest);
+  return digest;
+}
+
+}  // namespace
+
+TEST(SessionRegistryTest, CoalescesChangesBetweenFlushes) {
+  SessionRegistry registry;
+  EXPECT_TRUE(registry.Add(1, "lynx", "a.js"));
+  EXPECT_TRUE(registry.Add(2, "lynx", "b.js"));
+  EXPECT_TRUE(registry.Remove(2));
+  SessionRegistry::Delta delta = registry.TakeDelta();
+  ASSERT_EQ(delta.added.size(), 1u);
+  EXPECT_EQ(delta.added[0]->session_id_, 1);
+  EXPECT_EQ(delta.added[0]->url_, "a.js");
+  EXPECT_TRUE(delta.removed.empty());
+
+  EXPECT_TRUE(registry.Remove(1));
+  EXPECT_FALSE(registry.Remove(1));
+  delta = registry.TakeDelta();
+  EXPECT_TRUE(delta.added.empty());
+  EXPECT_EQ(delta.removed, std::vector<int>{1});
+  EXPECT_EQ(delta.digest, kEmptyDigest);
+  EXPECT_TRUE(registry.TakeDelta().Empty());
+}
+
+TEST(SessionRegistryTest, SkipsInvalidTemplateUrl) {
+  SessionRegistry registry;
+  EXPECT_FALSE(registry.Add(1, "lynx", protocol::kInvalidTempalteUrl));
+  EXPECT_EQ(registry.Size(), 0u);
+  EXPECT_TRUE(registry.TakeDelta().Empty());
+}
+
+TEST(SessionRegistryTest, DigestIsOrderIndependent) {
+  SessionRegistry forward;
+  SessionRegistry backward;
+  for (int i = 0; i < 20; ++i) {
+    forward.Add(i, "lynx", "page" + std::to_string(i));
+    backward.Add(19 - i, "lynx", "page" + std::to_string(19 - i));
+  }
+  EXPECT_EQ(ListDigest(forward), ListDigest(backward));
+  EXPECT_NE(ListDigest(forward), kEmptyDigest);
+
+  // an updated entry replaces its share of the digest.
+  backward.Add(3, "lynx", "other");
+  EXPECT_NE(ListDigest(forward), ListDigest(backward));
+  backward.Add(3, "lynx", "page3");
+  EXPECT_EQ(ListDigest(forward), ListDigest(backward));
+}
+
+TEST(SessionRegistryTest, DeltaDigestsMatchTheListsTheyDescribe) {
+  SessionRegistry registry;
+  registry.Add(1, "lynx", "a.js");
+  registry.Add(2, "lynx", "b.js");
+  registry.TakeDelta();
+  registry.Remove(1);
+  registry.Add(3, "lynx", "c.js");
+  SessionRegistry::Delta delta = registry.TakeDelta();
+
+  SessionRegistry after_removed;
+  after_removed.Add(2, "lynx", "b.js");
+  EXPECT_EQ(delta.digest_after_removed, ListDigest(after_removed));
+  after_removed.Add(3, "lynx", "c.js");
+  EXPECT_EQ(delta.digest, ListDigest(after_removed));
+  EXPECT_EQ(delta.digest, ListDigest(registry));
+}
+
+TEST(SessionRegistryTest, TakeListDropsPendingChanges) {
+  SessionRegistry registry;
+  registry.Add(1, "lynx", "a.js");
+  registry.Add(2, "lynx", "b.js");
+  std::string digest;
+  std::shared_ptr<protocol::CustomData4SessionList> list =
+      registry.TakeList(digest);
+  ASSERT_EQ(list->list_.size(), 2u);
+  EXPECT_EQ(list->list_[0]->session_id_, 1);
+  EXPECT_EQ(list->list_[1]->session_id_, 2);
+  EXPECT_TRUE(registry.TakeDelta().Empty());
+}
+
+}  // namespace processor
+}  // namespace debugrouter
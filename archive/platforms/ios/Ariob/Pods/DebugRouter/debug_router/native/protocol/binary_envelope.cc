@@ -0,0 +1,277 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/binary_envelope.h"
+
+#include <climits>
+#include <cstring>
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+enum MajorType : uint8_t {
+  kUnsigned = 0,
+  kNegative = 1,
+  kBytes = 2,
+  kText = 3,
+  kArray = 4,
+  kMap = 5,
+  kTag = 6,
+  kSimple = 7,
+};
+
+enum EnvelopeKey : uint64_t {
+  kEnvelopeType = 1,
+  kEnvelopeSender = 2,
+  kEnvelopeClientId = 3,
+  kEnvelopeSessionId = 4,
+  kEnvelopeMessage = 5,
+  kEnvelopeMark = 6,
+};
+
+constexpr uint64_t kTypeCDP = 1;
+
+// Writes the head of an item in its shortest form.
+void WriteHead(std::string &out, MajorType major, uint64_t value) {
+  uint8_t initial = static_cast<uint8_t>(major << 5);
+  if (value < 24) {
+    out.push_back(static_cast<char>(initial | value));
+    return;
+  }
+  int bytes;
+  if (value <= 0xff) {
+    out.push_back(static_cast<char>(initial | 24));
+    bytes = 1;
+  } else if (value <= 0xffff) {
+    out.push_back(static_cast<char>(initial | 25));
+    bytes = 2;
+  } else if (value <= 0xffffffff) {
+    out.push_back(static_cast<char>(initial | 26));
+    bytes = 4;
+  } else {
+    out.push_back(static_cast<char>(initial | 27));
+    bytes = 8;
+  }
+  for (int i = bytes - 1; i >= 0; --i) {
+    out.push_back(static_cast<char>(value >> (i * 8)));
+  }
+}
+
+void WriteInt(std::string &out, int64_t value) {
+  if (value >= 0) {
+    WriteHead(out, kUnsigned, static_cast<uint64_t>(value));
+  } else {
+    WriteHead(out, kNegative, static_cast<uint64_t>(-(value + 1)));
+  }
+}
+
+void WriteString(std::string &out, MajorType major, const std::string &value) {
+  WriteHead(out, major, value.size());
+  out.append(value);
+}
+
+// Writes every field but the value of the message, which comes last so it
+// can be written in place.
+void WriteEnvelopeFields(const std::string &type,
+                         RemoteDebugPrococolClientId sender,
+                         RemoteDebugPrococolClientId client_id,
+                         int session_id, int mark, std::string &out) {
+  WriteHead(out, kMap, mark > -1 ? 6 : 5);
+  WriteHead(out, kUnsigned, kEnvelopeType);
+  if (type == kRemoteDebugProtocolBodyData4CDP) {
+    WriteHead(out, kUnsigned, kTypeCDP);
+  } else {
+    WriteString(out, kText, type);
+  }
+  WriteHead(out, kUnsigned, kEnvelopeSender);
+  WriteHead(out, kUnsigned, sender);
+  WriteHead(out, kUnsigned, kEnvelopeClientId);
+  WriteHead(out, kUnsigned, client_id);
+  WriteHead(out, kUnsigned, kEnvelopeSessionId);
+  WriteInt(out, session_id);
+  if (mark > -1) {
+    WriteHead(out, kUnsigned, kEnvelopeMark);
+    WriteHead(out, kUnsigned, static_cast<uint64_t>(mark));
+  }
+  WriteHead(out, kUnsigned, kEnvelopeMessage);
+}
+
+class Decoder {
+ public:
+  Decoder(const char *data, size_t size)
+      : p_(reinterpret_cast<const uint8_t *>(data)), end_(p_ + size) {}
+
+  bool AtEnd() const { return p_ == end_; }
+
+  // Definite length heads only, the encoder never writes the others.
+  bool ReadHead(MajorType &major, uint64_t &value) {
+    if (p_ == end_) {
+      return false;
+    }
+    major = static_cast<MajorType>(*p_ >> 5);
+    uint8_t info = *p_++ & 0x1f;
+    if (info < 24) {
+      value = info;
+      return true;
+    }
+    if (info > 27) {
+      return false;
+    }
+    size_t bytes = size_t(1) << (info - 24);
+    if (static_cast<size_t>(end_ - p_) < bytes) {
+      return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+      value = (value << 8) | *p_++;
+    }
+    return true;
+  }
+
+  bool ReadPayload(uint64_t size, const char *&payload) {
+    if (static_cast<uint64_t>(end_ - p_) < size) {
+      return false;
+    }
+    payload = reinterpret_cast<const char *>(p_);
+    p_ += size;
+    return true;
+  }
+
+  // Skips the value of an unknown key, nested containers are not expected.
+  bool SkipValue(MajorType major, uint64_t value) {
+    const char *ignored;
+    switch (major) {
+      case kUnsigned:
+      case kNegative:
+      case kSimple:
+        return true;
+      case kBytes:
+      case kText:
+        return ReadPayload(value, ignored);
+      default:
+        return false;
+    }
+  }
+
+ private:
+  const uint8_t *p_;
+  const uint8_t *end_;
+};
+
+bool ToInt(MajorType major, uint64_t value, int &out) {
+  if (major == kUnsigned && value <= static_cast<uint64_t>(INT_MAX)) {
+    out = static_cast<int>(value);
+    return true;
+  }
+  if (major == kNegative && value <= static_cast<uint64_t>(INT_MAX)) {
+    out = -1 - static_cast<int>(value);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+void EncodeBinaryEnvelope(const std::string &type,
+                          RemoteDebugPrococolClientId sender,
+                          const CustomData4CDP &data, int mark,
+                          std::string &out) {
+  out.reserve(out.size() + data.message_.size() + type.size() + 32);
+  WriteEnvelopeFields(type, sender, data.client_id_, data.session_id_, mark,
+                      out);
+  WriteString(out, kBytes, data.message_);
+}
+
+size_t StartBinaryEnvelope(const std::string &type,
+                           RemoteDebugPrococolClientId sender,
+                           RemoteDebugPrococolClientId client_id,
+                           int session_id, int mark, std::string &out) {
+  WriteEnvelopeFields(type, sender, client_id, session_id, mark, out);
+  // the size of the message is not known yet, the head always takes 8 bytes
+  // of length, patched by FinishBinaryEnvelope().
+  out.push_back(static_cast<char>((kBytes << 5) | 27));
+  out.append(8, '\0');
+  return out.size();
+}
+
+void FinishBinaryEnvelope(size_t message_begin, std::string &out) {
+  uint64_t size = out.size() - message_begin;
+  for (size_t i = 0; i < 8; ++i) {
+    out[message_begin - 1 - i] = static_cast<char>(size >> (i * 8));
+  }
+}
+
+bool DecodeBinaryEnvelope(const char *data, size_t size,
+                          BinaryEnvelope &envelope) {
+  Decoder decoder(data, size);
+  MajorType major;
+  uint64_t count;
+  if (!decoder.ReadHead(major, count) || major != kMap) {
+    return false;
+  }
+  // one bit per key of EnvelopeKey.
+  unsigned seen = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t key;
+    uint64_t value;
+    if (!decoder.ReadHead(major, key) || major != kUnsigned ||
+        !decoder.ReadHead(major, value)) {
+      return false;
+    }
+    const char *payload;
+    switch (key) {
+      case kEnvelopeType:
+        if (major == kUnsigned && value == kTypeCDP) {
+          envelope.type = kRemoteDebugProtocolBodyData4CDP;
+        } else if (major == kText && decoder.ReadPayload(value, payload)) {
+          envelope.type.assign(payload, value);
+        } else {
+          return false;
+        }
+        break;
+      case kEnvelopeSender:
+      case kEnvelopeClientId:
+        if (major != kUnsigned || value > UINT32_MAX) {
+          return false;
+        }
+        (key == kEnvelopeSender ? envelope.sender : envelope.client_id) =
+            static_cast<RemoteDebugPrococolClientId>(value);
+        break;
+      case kEnvelopeSessionId:
+        if (!ToInt(major, value, envelope.session_id)) {
+          return false;
+        }
+        break;
+      case kEnvelopeMessage:
+        if ((major != kBytes && major != kText) ||
+            !decoder.ReadPayload(value, payload)) {
+          return false;
+        }
+        envelope.message = payload;
+        envelope.message_size = value;
+        break;
+      case kEnvelopeMark:
+        if (major != kUnsigned || !ToInt(major, value, envelope.mark)) {
+          return false;
+        }
+        break;
+      default:
+        if (!decoder.SkipValue(major, value)) {
+          return false;
+        }
+        continue;
+    }
+    seen |= 1u << key;
+  }
+  const unsigned required = (1u << kEnvelopeType) | (1u << kEnvelopeSender) |
+                            (1u << kEnvelopeClientId) |
+                            (1u << kEnvelopeSessionId) |
+                            (1u << kEnvelopeMessage);
+  return decoder.AtEnd() && (seen & required) == required;
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
@@ -0,0 +1,85 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROTOCOL_BINARY_ENVELOPE_H_
+#define DEBUGROUTER_NATIVE_PROTOCOL_BINARY_ENVELOPE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "debug_router/native/protocol/protocol.h"
+
+namespace debugrouter {
+namespace protocol {
+
+// The device offers the encodings it understands in the client info of
+// Register, the server answers the one to use in the data of Registered.
+// Without an answer both sides keep the json envelope.
+constexpr const char *kKeyEnvelopeEncodings = "envelopeEncodings";
+constexpr const char *kKeyEnvelopeEncoding = "envelopeEncoding";
+constexpr const char *kEnvelopeEncodingCbor = "cbor";
+
+/*
+ * Binary form of the Customized envelope of CDP and extension messages, a
+ * CBOR (RFC 8949) map with unsigned integer keys:
+ *
+ *   1: type, unsigned for CDP (1), text for the other types
+ *   2: sender, unsigned
+ *   3: client_id, unsigned
+ *   4: session_id, integer
+ *   5: message, byte string holding the message untouched
+ *   6: mark, unsigned, only present when the message has one
+ *
+ * Its first byte is a map header (0xa0 - 0xbf), which starts neither a json
+ * text nor an UTF-8 sequence, so both encodings can share a connection. It
+ * goes in binary frames over websocket, usb frames are length prefixed and
+ * carry it as is.
+ */
+struct BinaryEnvelope {
+  std::string type;
+  RemoteDebugPrococolClientId sender = 0;
+  RemoteDebugPrococolClientId client_id = 0;
+  int session_id = 0;
+  // points into the decoded buffer.
+  const char *message = nullptr;
+  size_t message_size = 0;
+  int mark = -1;
+};
+
+inline bool IsBinaryEnvelope(const char *data, size_t size) {
+  return size > 0 && (static_cast<uint8_t>(data[0]) & 0xe0) == 0xa0;
+}
+
+inline bool IsBinaryEnvelope(const std::string &data) {
+  return IsBinaryEnvelope(data.data(), data.size());
+}
+
+// Appends the binary envelope of |data| to |out|, |mark| is left out when
+// negative.
+void EncodeBinaryEnvelope(const std::string &type,
+                          RemoteDebugPrococolClientId sender,
+                          const CustomData4CDP &data, int mark,
+                          std::string &out);
+
+// For messages written in place, typically large ones: writes the envelope
+// of a message of |session_id| up to the message bytes, which the caller
+// appends to |out| before calling FinishBinaryEnvelope(). Returns the offset
+// of the message in |out|.
+size_t StartBinaryEnvelope(const std::string &type,
+                           RemoteDebugPrococolClientId sender,
+                           RemoteDebugPrococolClientId client_id,
+                           int session_id, int mark, std::string &out);
+void FinishBinaryEnvelope(size_t message_begin, std::string &out);
+
+// Returns false if |data| is not a well formed envelope with a type, sender,
+// client_id, session_id and message. Unknown keys with scalar values are
+// skipped.
+bool DecodeBinaryEnvelope(const char *data, size_t size,
+                          BinaryEnvelope &envelope);
+
+}  // namespace protocol
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROTOCOL_BINARY_ENVELOPE_H_
@@ -0,0 +1,203 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/binary_envelope.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+CustomData4CDP MakeData(int session_id, const std::string &message) {
+  CustomData4CDP data;
+  data.client_id_ = 7;
+  data.session_id_ = session_id;
+  data.message_ = message;
+  return data;
+}
+
+std::string Encode(const std::string &type, int session_id, int mark,
+                   const std::string &message) {
+  std::string out;
+  EncodeBinaryEnvelope(type, 3, MakeData(session_id, message), mark, out);
+  return out;
+}
+
+bool Decode(const std::string &data, BinaryEnvelope &envelope) {
+  return DecodeBinaryEnvelope(data.data(), data.size(), envelope);
+}
+
+// A map of |count| entries, followed by the entries written by the caller.
+std::string MapHead(uint8_t count) {
+  return std::string(1, static_cast<char>(0xa0 | count));
+}
+
+// The entries of every required key, with a 2 byte message "{}".
+const char kRequiredEntries[] =
+    "\x01\x01"      // type: CDP
+    "\x02\x03"      // sender: 3
+    "\x03\x07"      // client_id: 7
+    "\x04\x20"      // session_id: -1
+    "\x05\x42{}";   // message: "{}"
+
+}  // namespace
+
+TEST(BinaryEnvelopeTest, RoundTrips) {
+  const std::string message = "{\"id\":1,\"method\":\"Page.enable\"}";
+  BinaryEnvelope envelope;
+  std::string data = Encode(kRemoteDebugProtocolBodyData4CDP, 12, -1, message);
+  ASSERT_TRUE(Decode(data, envelope));
+  EXPECT_EQ(envelope.type, kRemoteDebugProtocolBodyData4CDP);
+  EXPECT_EQ(envelope.sender, 3u);
+  EXPECT_EQ(envelope.client_id, 7u);
+  EXPECT_EQ(envelope.session_id, 12);
+  EXPECT_EQ(std::string(envelope.message, envelope.message_size), message);
+  EXPECT_EQ(envelope.mark, -1);
+
+  // other types are written as text, and the mark only when there is one.
+  BinaryEnvelope marked;
+  data = Encode("App.extension", -1, 300, std::string(70000, 'x'));
+  ASSERT_TRUE(Decode(data, marked));
+  EXPECT_EQ(marked.type, "App.extension");
+  EXPECT_EQ(marked.session_id, -1);
+  EXPECT_EQ(marked.mark, 300);
+  EXPECT_EQ(marked.message_size, 70000u);
+
+  BinaryEnvelope negative;
+  data = Encode(kRemoteDebugProtocolBodyData4CDP, -100000, 0, "");
+  ASSERT_TRUE(Decode(data, negative));
+  EXPECT_EQ(negative.session_id, -100000);
+  EXPECT_EQ(negative.mark, 0);
+  EXPECT_EQ(negative.message_size, 0u);
+}
+
+TEST(BinaryEnvelopeTest, FinishPatchesTheMessageLength) {
+  const std::string message = "{\"method\":\"Page.screencastFrame\"}";
+  std::string data = "prefix";
+  size_t begin = StartBinaryEnvelope(kRemoteDebugProtocolBodyData4CDP, 3, 7,
+                                     -2, 5, data);
+  ASSERT_EQ(begin, data.size());
+  data.append(message);
+  FinishBinaryEnvelope(begin, data);
+
+  // the head of the message is 0x5b then its length in 8 big endian bytes.
+  ASSERT_GE(begin, 9u);
+  EXPECT_EQ(static_cast<uint8_t>(data[begin - 9]), 0x5b);
+  uint64_t length = 0;
+  for (size_t i = begin - 8; i < begin; ++i) {
+    length = (length << 8) | static_cast<uint8_t>(data[i]);
+  }
+  EXPECT_EQ(length, message.size());
+
+  BinaryEnvelope envelope;
+  ASSERT_TRUE(DecodeBinaryEnvelope(data.data() + 6, data.size() - 6, envelope));
+  EXPECT_EQ(envelope.session_id, -2);
+  EXPECT_EQ(envelope.mark, 5);
+  EXPECT_EQ(std::string(envelope.message, envelope.message_size), message);
+}
+
+TEST(BinaryEnvelopeTest, RejectsTruncatedInputAtEveryOffset) {
+  std::string data =
+      Encode("App.extension", -3, 9, "{\"id\":1,\"params\":{}}");
+  BinaryEnvelope envelope;
+  ASSERT_TRUE(Decode(data, envelope));
+  for (size_t size = 0; size < data.size(); ++size) {
+    EXPECT_FALSE(DecodeBinaryEnvelope(data.data(), size, envelope))
+        << "size " << size;
+  }
+  // nor is anything accepted after the map.
+  EXPECT_FALSE(Decode(data + '\0', envelope));
+}
+
+TEST(BinaryEnvelopeTest, RequiresEveryKey) {
+  BinaryEnvelope envelope;
+  const std::string entries(kRequiredEntries, sizeof(kRequiredEntries) - 1);
+  ASSERT_TRUE(Decode(MapHead(5) + entries, envelope));
+  EXPECT_EQ(envelope.session_id, -1);
+  EXPECT_EQ(std::string(envelope.message, envelope.message_size), "{}");
+
+  // drops the entry of each key in turn, entries are 2 bytes but the
+  // message.
+  for (size_t begin = 0; begin < 8; begin += 2) {
+    std::string missing = entries;
+    missing.erase(begin, 2);
+    EXPECT_FALSE(Decode(MapHead(4) + missing, envelope)) << begin;
+  }
+  EXPECT_FALSE(
+      Decode(MapHead(4) + entries.substr(0, entries.size() - 4), envelope));
+}
+
+TEST(BinaryEnvelopeTest, SkipsUnknownScalarKeys) {
+  BinaryEnvelope envelope;
+  const std::string entries(kRequiredEntries, sizeof(kRequiredEntries) - 1);
+  const std::string unknown[] = {
+      std::string("\x18\x20\x19\x01\x00", 5),  // 32: 256
+      std::string("\x09\x38\x63", 3),          // 9: -100
+      std::string("\x0a\x63" "abc", 5),        // 10: "abc"
+      std::string("\x0b\x43" "abc", 5),        // 11: h'616263'
+      std::string("\x0c\xf5", 2),              // 12: true
+      std::string("\x0d\xfb\x3f\xf0\x00\x00\x00\x00\x00\x00", 10),  // 1.0
+  };
+  for (const std::string &entry : unknown) {
+    EXPECT_TRUE(Decode(MapHead(6) + entry + entries, envelope));
+    EXPECT_TRUE(Decode(MapHead(6) + entries + entry, envelope));
+    // a truncated unknown value is still an error.
+    EXPECT_FALSE(Decode(
+        MapHead(6) + entries + entry.substr(0, entry.size() - 1), envelope))
+        << static_cast<int>(entry[0]);
+  }
+}
+
+TEST(BinaryEnvelopeTest, RejectsNestedContainersAndBadValues) {
+  BinaryEnvelope envelope;
+  const std::string entries(kRequiredEntries, sizeof(kRequiredEntries) - 1);
+  // unknown keys holding an array, a map or a tag.
+  EXPECT_FALSE(Decode(MapHead(6) + entries + "\x09\x81\x01", envelope));
+  EXPECT_FALSE(Decode(MapHead(6) + entries + "\x09\xa1\x01\x01", envelope));
+  EXPECT_FALSE(Decode(MapHead(6) + entries + "\x09\xc1\x01", envelope));
+  // keys must be unsigned integers.
+  EXPECT_FALSE(Decode(MapHead(6) + entries + "\x61k\x01", envelope));
+  // indefinite lengths are never written.
+  EXPECT_FALSE(Decode(std::string("\xbf", 1) + entries + "\xff", envelope));
+  // the root must be a map.
+  EXPECT_FALSE(Decode("\x85" + entries, envelope));
+  // an unsigned type other than CDP, a negative client id, a session id
+  // beyond int and a message that is neither bytes nor text.
+  std::string bad = entries;
+  bad[1] = 0x02;
+  EXPECT_FALSE(Decode(MapHead(5) + bad, envelope));
+  bad = entries;
+  bad[5] = 0x20;
+  EXPECT_FALSE(Decode(MapHead(5) + bad, envelope));
+  EXPECT_FALSE(Decode(MapHead(5) + entries.substr(0, 6) +
+                          std::string("\x04\x1a\x80\x00\x00\x00", 6) +
+                          entries.substr(8),
+                      envelope));
+  EXPECT_FALSE(Decode(MapHead(5) + entries.substr(0, 8) + "\x05\x02",
+                      envelope));
+}
+
+TEST(BinaryEnvelopeTest, NeverMatchesJsonText) {
+  // every byte a json text, UTF-8 encoded, may start with.
+  const std::string starts = " \t\r\n{[\"-0123456789tfn\xef";
+  for (char c : starts) {
+    EXPECT_FALSE(IsBinaryEnvelope(std::string(1, c))) << static_cast<int>(c);
+  }
+  EXPECT_FALSE(IsBinaryEnvelope(""));
+  EXPECT_FALSE(IsBinaryEnvelope("{\"event\":\"Customized\"}"));
+  for (int byte = 0; byte < 256; ++byte) {
+    EXPECT_EQ(IsBinaryEnvelope(std::string(1, static_cast<char>(byte))),
+              byte >= 0xa0 && byte <= 0xbf)
+        << byte;
+  }
+  EXPECT_TRUE(IsBinaryEnvelope(Encode(kRemoteDebugProtocolBodyData4CDP, 1,
+                                      -1, "{}")));
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
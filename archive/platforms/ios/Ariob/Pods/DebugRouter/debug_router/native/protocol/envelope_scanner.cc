@@ -0,0 +1,537 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/envelope_scanner.h"
+
+#include <cstring>
+
+#include "debug_router/native/protocol/protocol.h"
+#include "json/scan.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+inline bool IsDelimiter(char c) {
+  return c == ',' || c == '}' || c == ']' || Json::isJsonSpace(c);
+}
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+bool DecodeHex4(const char *&p, const char *end, unsigned int &value) {
+  if (end - p < 4) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < 4; ++i) {
+    int digit = HexValue(*p++);
+    if (digit < 0) {
+      return false;
+    }
+    value = value * 16 + digit;
+  }
+  return true;
+}
+
+// Parses the "XXXX" of a "\\uXXXX" sequence at |p|, including the second
+// half of a surrogate pair.
+const char *ParseUnicodeEscape(const char *p, const char *end,
+                               unsigned int &code) {
+  if (!DecodeHex4(p, end, code)) {
+    return nullptr;
+  }
+  if (code < 0xD800 || code > 0xDBFF) {
+    return p;
+  }
+  // surrogate pairs, combined the same way as Json::Reader.
+  unsigned int low;
+  if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+    return nullptr;
+  }
+  p += 2;
+  if (!DecodeHex4(p, end, low)) {
+    return nullptr;
+  }
+  code = 0x10000 + ((code & 0x3FF) << 10) + (low & 0x3FF);
+  return p;
+}
+
+// Parses the escape sequence starting at the backslash |p| into a code
+// point. Returns the end of the sequence, or nullptr for anything that
+// Json::Reader would reject.
+inline const char *ParseEscape(const char *p, const char *end,
+                               unsigned int &code) {
+  if (end - p < 2) {
+    return nullptr;
+  }
+  switch (p[1]) {
+    case '"':
+    case '/':
+    case '\\':
+      code = p[1];
+      return p + 2;
+    case 'b':
+      code = '\b';
+      return p + 2;
+    case 'f':
+      code = '\f';
+      return p + 2;
+    case 'n':
+      code = '\n';
+      return p + 2;
+    case 'r':
+      code = '\r';
+      return p + 2;
+    case 't':
+      code = '\t';
+      return p + 2;
+    case 'u':
+      return ParseUnicodeEscape(p + 2, end, code);
+    default:
+      return nullptr;
+  }
+}
+
+// Walks the body of a string from |p| to its closing quote. |on_run| gets
+// every run of plain characters and |on_escape| every backslash, it returns
+// the end of the escape sequence or nullptr to stop. Returns the closing
+// quote, or nullptr.
+template <typename OnRun, typename OnEscape>
+const char *WalkString(const char *p, const char *end, OnRun on_run,
+                       OnEscape on_escape) {
+  while (true) {
+    // same vectorized search as Json::Reader.
+    const char *hit = Json::findQuoteOrEscape(p, end, '"');
+    if (hit == end) {
+      return nullptr;
+    }
+    on_run(p, hit);
+    if (*hit == '"') {
+      return hit;
+    }
+    p = on_escape(hit);
+    if (p == nullptr) {
+      return nullptr;
+    }
+  }
+}
+
+// Same encoding as Json::Reader, returns the end of the written bytes.
+char *WriteUTF8(char *out, unsigned int cp) {
+  if (cp <= 0x7F) {
+    *out++ = static_cast<char>(cp);
+  } else if (cp <= 0x7FF) {
+    *out++ = static_cast<char>(0xC0 | (0x1F & (cp >> 6)));
+    *out++ = static_cast<char>(0x80 | (0x3F & cp));
+  } else if (cp <= 0xFFFF) {
+    *out++ = static_cast<char>(0xE0 | (0xF & (cp >> 12)));
+    *out++ = static_cast<char>(0x80 | (0x3F & (cp >> 6)));
+    *out++ = static_cast<char>(0x80 | (0x3F & cp));
+  } else if (cp <= 0x10FFFF) {
+    *out++ = static_cast<char>(0xF0 | (0x7 & (cp >> 18)));
+    *out++ = static_cast<char>(0x80 | (0x3F & (cp >> 12)));
+    *out++ = static_cast<char>(0x80 | (0x3F & (cp >> 6)));
+    *out++ = static_cast<char>(0x80 | (0x3F & cp));
+  }
+  return out;
+}
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+// true, false, null and numbers. Numbers are checked against the json
+// grammar, which is stricter than Json::Reader, the remaining cases are left
+// to it.
+bool IsLiteral(const char *begin, const char *end) {
+  size_t length = end - begin;
+  if ((length == 4 && memcmp(begin, "true", 4) == 0) ||
+      (length == 4 && memcmp(begin, "null", 4) == 0) ||
+      (length == 5 && memcmp(begin, "false", 5) == 0)) {
+    return true;
+  }
+  const char *c = begin;
+  if (c != end && *c == '-') {
+    ++c;
+  }
+  if (c == end || !IsDigit(*c)) {
+    return false;
+  }
+  while (c != end && IsDigit(*c)) {
+    ++c;
+  }
+  if (c != end && *c == '.') {
+    if (++c == end || !IsDigit(*c)) {
+      return false;
+    }
+    while (c != end && IsDigit(*c)) {
+      ++c;
+    }
+  }
+  if (c != end && (*c == 'e' || *c == 'E')) {
+    ++c;
+    if (c != end && (*c == '+' || *c == '-')) {
+      ++c;
+    }
+    if (c == end || !IsDigit(*c)) {
+      return false;
+    }
+    while (c != end && IsDigit(*c)) {
+      ++c;
+    }
+  }
+  return c == end;
+}
+
+// Unescapes the body of a string from |p| into |out| in the same pass that
+// looks for its closing quote. Returns the closing quote, or nullptr.
+const char *DecodeStringBody(const char *p, const char *end,
+                             std::string &out) {
+  // an escape sequence never decodes to more bytes than it takes.
+  out.resize(end - p);
+  char *dst = &out[0];
+  const char *quote = WalkString(
+      p, end,
+      [&dst](const char *run, const char *run_end) {
+        memcpy(dst, run, run_end - run);
+        dst += run_end - run;
+      },
+      [&dst, end](const char *escape) {
+        unsigned int code;
+        const char *next = ParseEscape(escape, end, code);
+        if (next == nullptr) {
+          return next;
+        }
+        if (code < 0x80) {
+          *dst++ = static_cast<char>(code);
+        } else {
+          dst = WriteUTF8(dst, code);
+        }
+        return next;
+      });
+  out.resize(quote != nullptr ? dst - out.data() : 0);
+  return quote;
+}
+
+class Cursor {
+ public:
+  Cursor(const char *begin, const char *end) : p_(begin), end_(end) {}
+
+  // deeper payloads are left to Json::Reader.
+  static constexpr int kMaxDepth = 64;
+
+  void SkipWhitespace() { p_ = Json::skipWhitespace(p_, end_); }
+
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (p_ == end_ || *p_ != c) {
+      return false;
+    }
+    ++p_;
+    return true;
+  }
+
+  // Same as ScanString() but also unescapes the value into |decoded|, so
+  // that a forwarded message is only walked once.
+  bool DecodeString(JsonSlice &slice, std::string &decoded) {
+    SkipWhitespace();
+    if (p_ == end_ || *p_ != '"') {
+      return ScanValue(slice);
+    }
+    slice = JsonSlice();
+    slice.begin = p_ + 1;
+    const char *quote = DecodeStringBody(slice.begin, end_, decoded);
+    if (quote == nullptr) {
+      return false;
+    }
+    slice.end = quote;
+    slice.kind = JsonSlice::kString;
+    // every escape sequence is longer than what it decodes to.
+    slice.has_escape =
+        decoded.size() != static_cast<size_t>(quote - slice.begin);
+    p_ = quote + 1;
+    return true;
+  }
+
+  // Expects the cursor on the opening quote.
+  bool ScanString(JsonSlice &slice) {
+    slice.begin = p_ + 1;
+    slice.has_escape = false;
+    const char *end = end_;
+    bool &has_escape = slice.has_escape;
+    const char *quote = WalkString(
+        slice.begin, end_, [](const char *, const char *) {},
+        [end, &has_escape](const char *escape) {
+          unsigned int code;
+          has_escape = true;
+          return ParseEscape(escape, end, code);
+        });
+    if (quote == nullptr) {
+      return false;
+    }
+    slice.end = quote;
+    slice.kind = JsonSlice::kString;
+    p_ = quote + 1;
+    return true;
+  }
+
+  // Skips an object or an array. Nested values are checked against the
+  // same grammar as Json::Reader, so a malformed payload is never forwarded.
+  bool SkipContainer(int depth) {
+    if (depth > kMaxDepth) {
+      return false;
+    }
+    bool is_object = *p_ == '{';
+    char close = is_object ? '}' : ']';
+    ++p_;
+    if (Consume(close)) {
+      return true;
+    }
+    while (true) {
+      if (is_object) {
+        SkipWhitespace();
+        JsonSlice key;
+        if (p_ == end_ || *p_ != '"' || !ScanString(key) || !Consume(':')) {
+          return false;
+        }
+      }
+      JsonSlice ignored;
+      if (!ScanValue(ignored, depth + 1)) {
+        return false;
+      }
+      if (Consume(',')) {
+        continue;
+      }
+      return Consume(close);
+    }
+  }
+
+  // Numbers, true, false and null. Only plain integers are kept, anything
+  // else is reported as kOther so that the caller falls back.
+  bool ScanLiteral(JsonSlice &slice) {
+    const char *begin = p_;
+    while (p_ != end_ && !IsDelimiter(*p_)) {
+      ++p_;
+    }
+    if (!IsLiteral(begin, p_)) {
+      return false;
+    }
+    slice.begin = begin;
+    slice.end = p_;
+    slice.kind = JsonSlice::kOther;
+
+    const char *digit = begin;
+    bool negative = *digit == '-';
+    if (negative) {
+      ++digit;
+    }
+    // 10 digits is enough for any int32, longer values are not routing ids.
+    if (digit == p_ || p_ - digit > 10) {
+      return true;
+    }
+    int64_t value = 0;
+    for (; digit != p_; ++digit) {
+      if (*digit < '0' || *digit > '9') {
+        return true;
+      }
+      value = value * 10 + (*digit - '0');
+    }
+    slice.integer = negative ? -value : value;
+    slice.kind = JsonSlice::kInteger;
+    return true;
+  }
+
+  bool ScanValue(JsonSlice &slice, int depth = 0) {
+    SkipWhitespace();
+    if (p_ == end_) {
+      return false;
+    }
+    slice = JsonSlice();
+    switch (*p_) {
+      case '"':
+        return ScanString(slice);
+      case '{':
+      case '[': {
+        bool is_object = *p_ == '{';
+        slice.begin = p_;
+        if (!SkipContainer(depth)) {
+          return false;
+        }
+        slice.end = p_;
+        slice.kind = is_object ? JsonSlice::kObject : JsonSlice::kOther;
+        return true;
+      }
+      default:
+        return ScanLiteral(slice);
+    }
+  }
+
+  // Walks the members of an object, |on_member| is called with the cursor
+  // on each value and must consume it. |slice| receives the object range.
+  template <typename OnMember>
+  bool ScanObject(JsonSlice &slice, OnMember on_member) {
+    SkipWhitespace();
+    if (p_ == end_ || *p_ != '{') {
+      return false;
+    }
+    slice = JsonSlice();
+    slice.begin = p_++;
+    if (Consume('}')) {
+      slice.end = p_;
+      slice.kind = JsonSlice::kObject;
+      return true;
+    }
+    while (true) {
+      SkipWhitespace();
+      if (p_ == end_ || *p_ != '"') {
+        return false;
+      }
+      JsonSlice key;
+      if (!ScanString(key) || key.has_escape || !Consume(':')) {
+        return false;
+      }
+      if (!on_member(key)) {
+        return false;
+      }
+      if (Consume(',')) {
+        continue;
+      }
+      if (Consume('}')) {
+        break;
+      }
+      return false;
+    }
+    slice.end = p_;
+    slice.kind = JsonSlice::kObject;
+    return true;
+  }
+
+  bool AtEnd() {
+    SkipWhitespace();
+    return p_ == end_;
+  }
+
+  bool IsObjectNext() {
+    SkipWhitespace();
+    return p_ != end_ && *p_ == '{';
+  }
+
+ private:
+  const char *p_;
+  const char *end_;
+};
+
+}  // namespace
+
+bool JsonSlice::DecodeString(std::string &out) const {
+  out.clear();
+  if (kind != kString) {
+    return false;
+  }
+  if (!has_escape) {
+    out.assign(begin, end);
+    return true;
+  }
+  // the closing quote is still in the scanned buffer and ends the walk.
+  if (DecodeStringBody(begin, end + 1, out) != end) {
+    out.clear();
+    return false;
+  }
+  return true;
+}
+
+bool JsonSlice::Equals(const char *literal) const {
+  if (kind != kString) {
+    return false;
+  }
+  size_t length = strlen(literal);
+  if (!has_escape) {
+    return static_cast<size_t>(end - begin) == length &&
+           memcmp(begin, literal, length) == 0;
+  }
+  std::string decoded;
+  return DecodeString(decoded) && decoded == literal;
+}
+
+bool EnvelopeScanner::Scan(const std::string &source, Envelope &envelope) {
+  envelope = Envelope();
+  Cursor cursor(source.data(), source.data() + source.size());
+  JsonSlice root;
+
+  auto on_payload_member = [&cursor, &envelope](const JsonSlice &key) {
+    if (key.Equals(kKeyClientId)) {
+      return cursor.ScanValue(envelope.client_id);
+    }
+    if (key.Equals(kKeySessionId)) {
+      return cursor.ScanValue(envelope.session_id);
+    }
+    if (key.Equals(kKeyMessage)) {
+      return cursor.DecodeString(envelope.message, envelope.decoded_message);
+    }
+    JsonSlice ignored;
+    return cursor.ScanValue(ignored);
+  };
+
+  auto on_data_member = [&cursor, &envelope,
+                         &on_payload_member](const JsonSlice &key) {
+    if (key.Equals(kKeyType)) {
+      return cursor.ScanValue(envelope.type);
+    }
+    if (key.Equals(kKeySender)) {
+      return cursor.ScanValue(envelope.sender);
+    }
+    if (key.Equals(kKeyData)) {
+      // a repeated key replaces the previous value, as in Json::Reader.
+      envelope.client_id = JsonSlice();
+      envelope.session_id = JsonSlice();
+      envelope.message = JsonSlice();
+      envelope.decoded_message.clear();
+      if (cursor.IsObjectNext()) {
+        return cursor.ScanObject(envelope.payload, on_payload_member);
+      }
+      return cursor.ScanValue(envelope.payload);
+    }
+    JsonSlice ignored;
+    return cursor.ScanValue(ignored);
+  };
+
+  auto on_root_member = [&cursor, &envelope,
+                         &on_data_member](const JsonSlice &key) {
+    if (key.Equals(kKeyEvent)) {
+      return cursor.ScanValue(envelope.event);
+    }
+    if (key.Equals(kKeyData)) {
+      Envelope reset;
+      reset.event = envelope.event;
+      envelope = reset;
+      if (cursor.IsObjectNext()) {
+        return cursor.ScanObject(envelope.data, on_data_member);
+      }
+      return cursor.ScanValue(envelope.data);
+    }
+    JsonSlice ignored;
+    return cursor.ScanValue(ignored);
+  };
+
+  return cursor.ScanObject(root, on_root_member);
+}
+
+bool EnvelopeScanner::Validate(const char *data, size_t size) {
+  Cursor cursor(data, data + size);
+  JsonSlice value;
+  return cursor.ScanValue(value) && cursor.AtEnd();
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
@@ -0,0 +1,78 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROTOCOL_ENVELOPE_SCANNER_H_
+#define DEBUGROUTER_NATIVE_PROTOCOL_ENVELOPE_SCANNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace debugrouter {
+namespace protocol {
+
+// A json value located in the scanned buffer. For strings the range excludes
+// the quotes and is still escaped, for objects it spans from '{' to just
+// after '}'.
+struct JsonSlice {
+  enum Kind { kMissing, kString, kObject, kInteger, kOther };
+
+  bool IsString() const { return kind == kString; }
+  bool IsObject() const { return kind == kObject; }
+  // Same range as Json::Value::isInt().
+  bool IsInt() const {
+    return kind == kInteger && integer >= INT32_MIN && integer <= INT32_MAX;
+  }
+  int32_t AsInt() const { return static_cast<int32_t>(integer); }
+
+  // Unescapes a string slice into |out|, same rules as Json::Reader.
+  bool DecodeString(std::string &out) const;
+  bool Equals(const char *literal) const;
+
+  Kind kind = kMissing;
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  bool has_escape = false;
+  int64_t integer = 0;
+};
+
+// Routing fields of a protocol envelope:
+// {"event": ..., "data": {"type": ..., "sender": ...,
+//                         "data": {"client_id": ..., "session_id": ...,
+//                                  "message": ...}}}
+struct Envelope {
+  JsonSlice event;
+  JsonSlice data;
+  JsonSlice type;
+  JsonSlice sender;
+  JsonSlice payload;
+  JsonSlice client_id;
+  JsonSlice session_id;
+  JsonSlice message;
+  // "message" unescaped while scanning, valid if message is a string.
+  std::string decoded_message;
+};
+
+/*
+ * Extracts the routing fields of an envelope without building a
+ * Json::Value tree, every other member is validated and skipped.
+ *
+ * Scan() returns false for anything it does not handle (comments, escaped
+ * keys, a root that is not an object, truncated input), the caller is
+ * expected to fall back to Json::Reader then. The slices point into
+ * |source|, which must outlive |envelope|.
+ */
+class EnvelopeScanner {
+ public:
+  static bool Scan(const std::string &source, Envelope &envelope);
+
+  // True if |data| holds exactly one json value, checked with the grammar
+  // of Scan(). False does not mean that Json::Reader would reject it.
+  static bool Validate(const char *data, size_t size);
+};
+
+}  // namespace protocol
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROTOCOL_ENVELOPE_SCANNER_H_
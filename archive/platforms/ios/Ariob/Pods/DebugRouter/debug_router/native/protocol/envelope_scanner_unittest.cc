@@ -0,0 +1,86 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/envelope_scanner.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+std::string MakeEnvelope(const std::string &message) {
+  Json::Value root(Json::objectValue);
+  root["event"] = "Customized";
+  root["data"]["type"] = "CDP";
+  root["data"]["data"]["client_id"] = 7;
+  root["data"]["data"]["session_id"] = 3;
+  root["data"]["data"]["message"] = message;
+  return Json::FastWriter().write(root);
+}
+
+}  // namespace
+
+TEST(EnvelopeScannerTest, ScansRoutingFields) {
+  Envelope envelope;
+  std::string source = MakeEnvelope("{\"id\":1}");
+  ASSERT_TRUE(EnvelopeScanner::Scan(source, envelope));
+  EXPECT_TRUE(envelope.event.Equals("Customized"));
+  EXPECT_TRUE(envelope.type.Equals("CDP"));
+  EXPECT_EQ(envelope.client_id.AsInt(), 7);
+  EXPECT_EQ(envelope.session_id.AsInt(), 3);
+  EXPECT_TRUE(envelope.message.IsString());
+  EXPECT_EQ(envelope.decoded_message, "{\"id\":1}");
+}
+
+// Strings crossing block boundaries with escapes at every offset must decode
+// the same way as with Json::Reader.
+TEST(EnvelopeScannerTest, DecodesLikeJsonReader) {
+  std::mt19937 random(42);
+  const char alphabet[] = "ab\"\\/\n\t\x01\xc3\xa9{}";
+  for (int round = 0; round < 2000; ++round) {
+    std::string message;
+    size_t size = random() % 80;
+    for (size_t i = 0; i < size; ++i) {
+      message.push_back(alphabet[random() % (sizeof(alphabet) - 1)]);
+    }
+    std::string source = MakeEnvelope(message);
+    Envelope envelope;
+    ASSERT_TRUE(EnvelopeScanner::Scan(source, envelope)) << source;
+    Json::Value root;
+    ASSERT_TRUE(Json::Reader().parse(source, root, false));
+    EXPECT_EQ(envelope.decoded_message,
+              root["data"]["data"]["message"].asString());
+  }
+}
+
+TEST(EnvelopeScannerTest, RejectsTruncatedInput) {
+  std::string source = MakeEnvelope("a \\\"quoted\\\" message");
+  for (size_t size = 0; size + 1 < source.size(); ++size) {
+    Envelope envelope;
+    EXPECT_FALSE(EnvelopeScanner::Scan(source.substr(0, size), envelope))
+        << size;
+  }
+}
+
+TEST(EnvelopeScannerTest, Validate) {
+  const char *valid[] = {"{}", " [1,2.5e3,-0] ", "\"\\u00e9\"", "null",
+                         "{\"a\":{\"b\":[true,false]}}"};
+  for (const char *json : valid) {
+    EXPECT_TRUE(EnvelopeScanner::Validate(json, strlen(json))) << json;
+  }
+  const char *invalid[] = {"", "{", "{\"a\":1,}", "[1] [2]", "\"\\x\"",
+                           "01x", "{\"a\" 1}"};
+  for (const char *json : invalid) {
+    EXPECT_FALSE(EnvelopeScanner::Validate(json, strlen(json))) << json;
+  }
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
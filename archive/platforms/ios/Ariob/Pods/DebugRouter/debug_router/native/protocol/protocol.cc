@@ -5,12 +5,13 @@
 #include "debug_router/native/protocol/protocol.h"
 
 #include "debug_router/native/log/logging.h"
+#include "debug_router/native/protocol/binary_envelope.h"
 
 namespace debugrouter {
 namespace protocol {
 
 bool RemoteDebugProtocolBody::IsProtocolBody4Init() {
-  return event_.compare(kRemoteDebugServerEvent4Init) == 0;
+  return kind_ == EventKind::kInit;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4Init>
@@ -19,11 +20,11 @@ RemoteDebugProtocolBody::AsInit() {
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4Custom() {
-  return event_.compare(kRemoteDebugServerEvent4Custom) == 0;
+  return kind_ == EventKind::kCustom;
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4Register() {
-  return event_.compare(kRemoteDebugServerEvent4Register) == 0;
+  return kind_ == EventKind::kRegister;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4Register>
@@ -32,7 +33,7 @@ RemoteDebugProtocolBody::AsRegister() {
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4Registered() {
-  return event_.compare(kRemoteDebugServerEvent4Registered) == 0;
+  return kind_ == EventKind::kRegistered;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4Registered>
@@ -41,7 +42,7 @@ RemoteDebugProtocolBody::AsRegistered() {
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4JoinRoom() {
-  return event_.compare(kRemoteDebugServerEvent4JoinRoom) == 0;
+  return kind_ == EventKind::kJoinRoom;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4JoinRoom>
@@ -50,7 +51,7 @@ RemoteDebugProtocolBody::AsJoinRoom() {
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4RoomJoined() {
-  return event_.compare(kRemoteDebugServerEvent4RoomJoined) == 0;
+  return kind_ == EventKind::kRoomJoined;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4RoomJoined>
@@ -59,7 +60,7 @@ RemoteDebugProtocolBody::AsRoomJoined() {
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4ChangeRoomServer() {
-  return event_.compare(kRemoteDebugServerEvent4ChangeRoomServer) == 0;
+  return kind_ == EventKind::kChangeRoomServer;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4ChangeRoomServer>
@@ -68,7 +69,7 @@ RemoteDebugProtocolBody::AsChangeRoomServer() {
 }
 
 bool RemoteDebugProtocolBody::IsProtocolBody4ChangeRoomServerAck() {
-  return event_.compare(kRemoteDebugServerEvent4ChangeRoomServerAck) == 0;
+  return kind_ == EventKind::kChangeRoomServerAck;
 }
 
 std::shared_ptr<RemoteDebugProtocolBodyData4ChangeRoomServerAck>
@@ -132,8 +133,14 @@ std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4RoomJoined(
 }
 
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Registerd() {
+  return CreateProtocolBody4Registerd(std::string());
+}
+
+std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Registerd(
+    const std::string &envelope_encoding) {
   std::shared_ptr<RemoteDebugProtocolBodyData4Registered> registered_data =
       std::make_shared<RemoteDebugProtocolBodyData4Registered>();
+  registered_data->envelope_encoding_ = envelope_encoding;
   std::shared_ptr<RemoteDebugProtocolBody> registered_body =
       std::make_shared<RemoteDebugProtocolBody>(
           kRemoteDebugServerEvent4Registered, registered_data);
@@ -210,6 +217,20 @@ std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
   return custom_body;
 }
 
+std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
+    std::string type, RemoteDebugPrococolClientId client_id,
+    std::shared_ptr<CustomData4SessionRemoved> session_removed) {
+  std::shared_ptr<RemoteDebugProtocolBodyData4Custom> custom_content =
+      std::make_shared<RemoteDebugProtocolBodyData4Custom>();
+  custom_content->type_ = type;
+  custom_content->client_id_ = client_id;
+  custom_content->session_removed_data_ = session_removed;
+  std::shared_ptr<RemoteDebugProtocolBody> custom_body =
+      std::make_shared<RemoteDebugProtocolBody>(kRemoteDebugServerEvent4Custom,
+                                                custom_content);
+  return custom_body;
+}
+
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
     std::string type, RemoteDebugPrococolClientId client_id,
     bool should_stop_at_entry) {
@@ -247,22 +268,160 @@ std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
   return custom_body;
 }
 
+void InternKeys() {
+  static const char *const kKeys[] = {
+      kKeyId, kKeyRoom, kKeyType, kKeyInfo, kKeyClientId, kKeySessionId,
+      kKeyUrl, kKeyCode, kKeyMessage, kKeyMethod, kKeyResult, kKeyParams,
+      kKeyError, kKeySender, kKeyData, kKeyEvent, kKeyStopAtEntry,
+      kKeySignature, kKeyMark, kKeyReconnect, kKeyDelta, kKeyDigest,
+      // CDP messages carried in "message".
+      "sessionId"};
+  for (const char *key : kKeys) {
+    Json::Value::internKey(Json::StaticString(key));
+  }
+}
+
 std::shared_ptr<RemoteDebugProtocolBody> Parse(const Json::Value &value) {
+  return Parse(value, std::string());
+}
+
+namespace {
+
+std::shared_ptr<RemoteDebugProtocolBody> ParseCustom(
+    const std::string &event, const Json::Value &data,
+    const std::string &source) {
+  const Json::Value &message_type = data[kKeyType];
+  const Json::Value &sender = data[kKeySender];
+  const Json::Value &payload = data[kKeyData];
+  if (!message_type.isString() || !sender.isInt()) {
+    return nullptr;
+  }
+  std::string type = message_type.asString();
+  // the known types fall back to the generic parsing below when their
+  // payload does not have the expected shape.
+  switch (CustomKindOf(type)) {
+    // parsing custom data 4 stop at entry & stop lepus at entry
+    case CustomKind::kD2RStopAtEntry:
+    case CustomKind::kD2RStopLepusAtEntry:
+      if (payload.isObject()) {
+        const Json::Value &client_id = payload[kKeyClientId];
+        const Json::Value &stop_at_entry = payload[kKeyStopAtEntry];
+        if (client_id.isInt() && stop_at_entry.isBool()) {
+          return CreateProtocolBody4Custom(type, client_id.asInt(),
+                                           stop_at_entry.asBool());
+        }
+      }
+      break;
+
+    // parsing custom data 4 open card
+    case CustomKind::kOpenCard:
+      if (payload.isObject()) {
+        const Json::Value &open_type = payload[kKeyType];
+        const Json::Value &open_url = payload[kKeyUrl];
+        if (open_url.isString() && open_url.isString()) {
+          return CreateProtocolBody4Custom(
+              kRemoteDebugProtocolBodyData4Custom4OpenCard,
+              open_type.asString(), open_url.asString());
+        }
+      }
+      break;
+
+    case CustomKind::kListSession: {
+      auto custom_data = std::make_shared<RemoteDebugProtocolBodyData4Custom>();
+      auto list_session = std::make_shared<CustomData4ListSession>();
+      if (payload.isObject()) {
+        const Json::Value client_id = payload[kKeyClientId];
+        if (client_id.isInt()) {
+          list_session->client_id_ = client_id.asInt();
+        }
+        const Json::Value &delta = payload[kKeyDelta];
+        list_session->delta_ = delta.isBool() && delta.asBool();
+      }
+      custom_data->list_session_data_ = list_session;
+      custom_data->type_ = kRemoteDebugProtocolBodyData4Custom4ListSession;
+      return std::make_shared<RemoteDebugProtocolBody>(event, custom_data);
+    }
+
+    case CustomKind::kMessageHandler:
+      if (payload.isObject()) {
+        const Json::Value &client_id = payload[kKeyClientId];
+        const Json::Value &message = payload[kKeyMessage];
+        const Json::Value &method = message[kKeyMethod];
+        const Json::Value &params = message[kKeyParams];
+        const Json::Value &message_id = message[kKeyId];
+        if ((!method.isString()) || (!params.isObject()) ||
+            (!client_id.isInt()) || (!message_id.isInt())) {
+          LOGW("App protocol: method, params or message_id is not valid");
+          return nullptr;
+        }
+        std::string params_string = Json::toCompactString(params);
+        std::shared_ptr<AppMessageData> app_message_data =
+            std::make_shared<AppMessageData>(
+                method.asString(), message_id.asInt(), params_string, kParams);
+        auto app_protocol_data = std::make_shared<AppProtocolData>(
+            client_id.asInt(), app_message_data);
+        return CreateProtocolBody4AppMessage(type, sender.asInt(),
+                                             app_protocol_data);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  // parsing custom data 4 cdp & other
+  if (payload.isObject()) {
+    const Json::Value &session_id = payload[kKeySessionId];
+    const Json::Value &client_id = payload[kKeyClientId];
+    const Json::Value &message = payload[kKeyMessage];
+    std::shared_ptr<CustomData4CDP> cdp = std::make_shared<CustomData4CDP>();
+    if (client_id.isInt() && session_id.isInt() &&
+        (message.isString() || message.isObject())) {
+      cdp->client_id_ = client_id.asInt();
+      cdp->session_id_ = session_id.asInt();
+      if (message.isString()) {
+        cdp->message_ = message.asString();
+      } else if (message.getOffsetLimit() > message.getOffsetStart() &&
+                 static_cast<size_t>(message.getOffsetLimit()) <=
+                     source.size()) {
+        cdp->message_.assign(
+            source, message.getOffsetStart(),
+            message.getOffsetLimit() - message.getOffsetStart());
+      } else {
+        Json::writeCompact(message, cdp->message_);
+      }
+      return CreateProtocolBody4Custom(type, sender.asInt(), cdp);
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+std::shared_ptr<RemoteDebugProtocolBody> Parse(const Json::Value &value,
+                                               const std::string &source) {
   const Json::Value &event = value[kKeyEvent];
-  if (event.isString()) {
-    std::string eventStr = event.asString();
-    if (eventStr.compare(kRemoteDebugServerEvent4Init) == 0) {
-      const Json::Value &data = value[kKeyData];
+  if (!event.isString()) {
+    return nullptr;
+  }
+  std::string eventStr = event.asString();
+  const Json::Value &data = value[kKeyData];
+  switch (EventKindOf(eventStr)) {
+    case EventKind::kInit:
       if (data.isInt()) {
         int client_id = data.asInt();
         return CreateProtocolBody4Init(client_id);
       }
-    }
-    if (eventStr.compare(kRemoteDebugServerEvent4Registered) == 0) {
+      break;
+    case EventKind::kRegistered:
+      if (data.isObject()) {
+        const Json::Value &encoding = data[kKeyEnvelopeEncoding];
+        if (encoding.isString()) {
+          return CreateProtocolBody4Registerd(encoding.asString());
+        }
+      }
       return CreateProtocolBody4Registerd();
-    }
-    if (eventStr.compare(kRemoteDebugServerEvent4RoomJoined) == 0) {
-      const Json::Value &data = value[kKeyData];
+    case EventKind::kRoomJoined:
       if (data.isObject()) {
         const Json::Value &join_client_id = data[kKeyId];
         const Json::Value &join_room_id = data[kKeyRoom];
@@ -271,9 +430,8 @@ std::shared_ptr<RemoteDebugProtocolBody> Parse(const Json::Value &value) {
                                                join_client_id.asInt());
         }
       }
-    }
-    if (eventStr.compare(kRemoteDebugServerEvent4ChangeRoomServer) == 0) {
-      const Json::Value &data = value[kKeyData];
+      break;
+    case EventKind::kChangeRoomServer:
       if (data.isObject()) {
         const Json::Value &client_id = data[kKeyId];
         const Json::Value &room_id = data[kKeyRoom];
@@ -283,113 +441,14 @@ std::shared_ptr<RemoteDebugProtocolBody> Parse(const Json::Value &value) {
               client_id.asInt(), room_id.asString(), url.asString());
         }
       }
-    }
-    if (eventStr.compare(kRemoteDebugServerEvent4Custom) == 0) {
-      const Json::Value &data = value[kKeyData];
+      break;
+    case EventKind::kCustom:
       if (data.isObject()) {
-        const Json::Value &message_type = data[kKeyType];
-        const Json::Value &sender = data[kKeySender];
-        const Json::Value &payload = data[kKeyData];
-        if (message_type.isString() && sender.isInt()) {
-          // parsing custom data 4 stop at entry & stop lepus at entry
-          if (message_type.asString().compare(
-                  kRemoteDebugProtocolBodyData4Custom4D2RStopAtEntry) == 0 ||
-              message_type.asString().compare(
-                  kRemoteDebugProtocolBodyData4Custom4D2RStopLepusAtEntry) ==
-                  0) {
-            if (payload.isObject()) {
-              const Json::Value &client_id = payload[kKeyClientId];
-              const Json::Value &stop_at_entry = payload[kKeyStopAtEntry];
-              if (client_id.isInt() && stop_at_entry.isBool()) {
-                return CreateProtocolBody4Custom(message_type.asString(),
-                                                 client_id.asInt(),
-                                                 stop_at_entry.asBool());
-              }
-            }
-          }
-
-          // parsing custom data 4 open card
-          if (message_type.asString().compare(
-                  kRemoteDebugProtocolBodyData4Custom4OpenCard) == 0) {
-            if (payload.isObject()) {
-              const Json::Value &open_type = payload[kKeyType];
-              const Json::Value &open_url = payload[kKeyUrl];
-              if (open_url.isString() && open_url.isString()) {
-                return CreateProtocolBody4Custom(
-                    kRemoteDebugProtocolBodyData4Custom4OpenCard,
-                    open_type.asString(), open_url.asString());
-              }
-            }
-          }
-
-          if (message_type.asString().compare(
-                  kRemoteDebugProtocolBodyData4Custom4ListSession) == 0) {
-            auto custom_data =
-                std::make_shared<RemoteDebugProtocolBodyData4Custom>();
-            auto list_session = std::make_shared<CustomData4ListSession>();
-            if (payload.isObject()) {
-              const Json::Value client_id = payload[kKeyClientId];
-              if (client_id.isInt()) {
-                list_session->client_id_ = client_id.asInt();
-              }
-            }
-            custom_data->list_session_data_ = list_session;
-            custom_data->type_ =
-                kRemoteDebugProtocolBodyData4Custom4ListSession;
-            auto body = std::make_shared<RemoteDebugProtocolBody>(eventStr,
-                                                                  custom_data);
-            return body;
-          }
-
-          if (message_type.asString().compare(
-                  kRemoteDebugProtocolBodyData4Custom4MessageHandler) == 0) {
-            if (payload.isObject()) {
-              const Json::Value &client_id = payload[kKeyClientId];
-              const Json::Value &message = payload[kKeyMessage];
-              const Json::Value &method = message[kKeyMethod];
-              const Json::Value &params = message[kKeyParams];
-              const Json::Value &message_id = message[kKeyId];
-              if ((!method.isString()) || (!params.isObject()) ||
-                  (!client_id.isInt()) || (!message_id.isInt())) {
-                LOGW("App protocol: method, params or message_id is not valid");
-                return nullptr;
-              }
-              std::string params_string = params.toStyledString();
-              std::shared_ptr<AppMessageData> app_message_data =
-                  std::make_shared<AppMessageData>(method.asString(),
-                                                   message_id.asInt(),
-                                                   params_string, kParams);
-              auto app_protocol_data = std::make_shared<AppProtocolData>(
-                  client_id.asInt(), app_message_data);
-              return CreateProtocolBody4AppMessage(
-                  message_type.asString(), sender.asInt(), app_protocol_data);
-            }
-          }
-
-          // parsing custom data 4 cdp & other
-          if (payload.isObject()) {
-            const Json::Value &session_id = payload[kKeySessionId];
-            const Json::Value &client_id = payload[kKeyClientId];
-            const Json::Value &message = payload[kKeyMessage];
-            std::shared_ptr<CustomData4CDP> cdp =
-                std::make_shared<CustomData4CDP>();
-            if (client_id.isInt() && session_id.isInt() &&
-                (message.isString() || message.isObject())) {
-              cdp->client_id_ = client_id.asInt();
-              cdp->session_id_ = session_id.asInt();
-              if (message.isString()) {
-                cdp->message_ = message.asString();
-              } else {
-                Json::FastWriter fastWriter;
-                cdp->message_ = fastWriter.write(message);
-              }
-              return CreateProtocolBody4Custom(message_type.asString(),
-                                               sender.asInt(), cdp);
-            }
-          }
-        }
+        return ParseCustom(eventStr, data, source);
       }
-    }
+      break;
+    default:
+      break;
   }
   return nullptr;
 }
@@ -400,37 +459,60 @@ std::string Stringify(const std::shared_ptr<RemoteDebugProtocolBody> body) {
 
 std::string Stringify(const std::shared_ptr<RemoteDebugProtocolBody> body,
                       int mark) {
-  Json::Value root;
-  if (mark > -1) {
-    root[kKeyMark] = mark;
-  }
-  root[kKeyEvent] = body->event_;
-  if (body->IsProtocolBody4Init()) {
-    body->AsInit()->Stringify(root[kKeyData]);
-  }
-  if (body->IsProtocolBody4Register()) {
-    body->AsRegister()->Stringify(root[kKeyData]);
-  }
-  if (body->IsProtocolBody4Registered()) {
-    body->AsRegistered()->Stringify(root[kKeyData]);
-  }
-  if (body->IsProtocolBody4RoomJoined()) {
-    body->AsRoomJoined()->Stringify(root[kKeyData]);
-  }
-  if (body->IsProtocolBody4JoinRoom()) {
-    body->AsJoinRoom()->Stringify(root[kKeyData]);
-  }
-  if (body->IsProtocolBody4ChangeRoomServer()) {
-    body->AsChangeRoomServer()->Stringify(root[kKeyData]);
+  // size of the last envelope built on this thread, messages of a session
+  // tend to have similar sizes.
+  static thread_local size_t last_size = 256;
+  std::string str;
+  str.reserve(last_size);
+  StringifyTo(body, mark, str);
+  last_size = str.size();
+  return str;
+}
+
+namespace {
+
+Stringifiable *GetBodyData(const std::shared_ptr<RemoteDebugProtocolBody> &body) {
+  switch (body->Kind()) {
+    case EventKind::kInit:
+      return body->AsInit().get();
+    case EventKind::kRegister:
+      return body->AsRegister().get();
+    case EventKind::kRegistered:
+      return body->AsRegistered().get();
+    case EventKind::kRoomJoined:
+      return body->AsRoomJoined().get();
+    case EventKind::kJoinRoom:
+      return body->AsJoinRoom().get();
+    case EventKind::kChangeRoomServer:
+      return body->AsChangeRoomServer().get();
+    case EventKind::kChangeRoomServerAck:
+      return body->AsChangeRoomServerAck().get();
+    case EventKind::kCustom:
+      return body->AsCustom().get();
+    case EventKind::kUnknown:
+      break;
   }
-  if (body->IsProtocolBody4ChangeRoomServerAck()) {
-    body->AsChangeRoomServerAck()->Stringify(root[kKeyData]);
+  return nullptr;
+}
+
+}  // namespace
+
+void StringifyTo(const std::shared_ptr<RemoteDebugProtocolBody> &body,
+                 int mark, std::string &out) {
+  ProtocolWriter writer(out);
+  writer.StartObject();
+  Stringifiable *data = GetBodyData(body);
+  if (data) {
+    writer.Key(kKeyData);
+    data->Stringify(writer);
   }
-  if (body->IsProtocolBody4Custom()) {
-    body->AsCustom()->Stringify(root[kKeyData]);
+  writer.Key(kKeyEvent);
+  writer.String(body->event_);
+  if (mark > -1) {
+    writer.Key(kKeyMark);
+    writer.Int(mark);
   }
-  std::string str = root.toStyledString();
-  return str;
+  writer.EndObject();
 }
 
 }  // namespace RemoteDebugProtocol
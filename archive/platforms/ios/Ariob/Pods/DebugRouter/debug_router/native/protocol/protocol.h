@@ -5,12 +5,17 @@
 #ifndef DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_H_
 #define DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "debug_router/native/log/logging.h"
 #include "debug_router/native/protocol/md5.h"
+#include "debug_router/native/protocol/protocol_kind.h"
+#include "debug_router/native/protocol/protocol_writer.h"
 #include "json/json.h"
 
 namespace debugrouter {
@@ -35,6 +40,12 @@ constexpr const char *kRemoteDebugProtocolBodyData4Custom4MessageHandler =
     "App";
 constexpr const char *kRemoteDebugProtocolBodyData4Custom4SessionList =
     "SessionList";
+// sent instead of SessionList to peers that asked for deltas, see
+// CustomData4ListSession.
+constexpr const char *kRemoteDebugProtocolBodyData4Custom4SessionAdded =
+    "SessionAdded";
+constexpr const char *kRemoteDebugProtocolBodyData4Custom4SessionRemoved =
+    "SessionRemoved";
 constexpr const char *kRemoteDebugProtocolBodyData4Custom4OpenSession =
     "OpenSession";
 constexpr const char *kRemoteDebugProtocolBodyData4Custom4CloseSession =
@@ -70,6 +81,8 @@ constexpr const char *kKeyStopAtEntry = "stop_at_entry";
 constexpr const char *kKeySignature = "signature";
 constexpr const char *kKeyMark = "mark";
 constexpr const char *kKeyReconnect = "reconnect";
+constexpr const char *kKeyDelta = "delta";
+constexpr const char *kKeyDigest = "digest";
 
 constexpr const char *kRuntimeType = "runtime";
 
@@ -79,11 +92,14 @@ constexpr const char *kSignatureSalt =
 using RemoteDebugPrococolClientId = uint32_t;
 using RemoteDebugProtocolRoomId = std::string;
 
+// Object keys are written in sorted order, the order Json::Value used to
+// serialize them in.
 struct Stringifiable {
   virtual ~Stringifiable() = default;
 
-  virtual void Stringify(Json::Value &v) {
-    v = Json::Value(Json::objectValue);
+  virtual void Stringify(ProtocolWriter &writer) {
+    writer.StartObject();
+    writer.EndObject();
   };
 };
 
@@ -92,7 +108,7 @@ struct RemoteDebugProtocolBodyData4Init : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4Init() override = default;
 
-  void Stringify(Json::Value &data) override { data = client_id_; };
+  void Stringify(ProtocolWriter &writer) override { writer.Uint(client_id_); };
 };
 
 struct RemoteDebugProtocolBodyData4JoinRoom : public Stringifiable {
@@ -100,7 +116,7 @@ struct RemoteDebugProtocolBodyData4JoinRoom : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4JoinRoom() override = default;
 
-  void Stringify(Json::Value &data) override { data = room_id_; };
+  void Stringify(ProtocolWriter &writer) override { writer.String(room_id_); };
 };
 
 struct RemoteDebugProtocolBodyData4RoomJoined : public Stringifiable {
@@ -109,12 +125,15 @@ struct RemoteDebugProtocolBodyData4RoomJoined : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4RoomJoined() override = default;
 
-  void Stringify(Json::Value &data) override {
-    Json::Value v(Json::objectValue);
-    v[kKeyId] = client_id_;
-    v[kKeyRoom] = room_id_;
-    v[kKeyType] = kRuntimeType;
-    data = v;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyId);
+    writer.Uint(client_id_);
+    writer.Key(kKeyRoom);
+    writer.String(room_id_);
+    writer.Key(kKeyType);
+    writer.String(kRuntimeType);
+    writer.EndObject();
   };
 };
 
@@ -125,26 +144,45 @@ struct RemoteDebugProtocolBodyData4Register : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4Register() override = default;
 
-  void Stringify(Json::Value &data) override {
-    Json::Value v(Json::objectValue);
-    v[kKeyId] = client_id_;
-    v[kKeyType] = std::string(kRuntimeType);
-    v[kKeyReconnect] = is_reconnect_;
-    Json::Value info(Json::objectValue);
-    for (auto item : client_info_) {
-      info[item.first] = item.second;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyId);
+    writer.Uint(client_id_);
+    writer.Key(kKeyInfo);
+    std::vector<const std::pair<const std::string, std::string> *> info;
+    info.reserve(client_info_.size());
+    for (const auto &item : client_info_) {
+      info.push_back(&item);
     }
-    v[kKeyInfo] = info;
-    data = v;
+    std::sort(info.begin(), info.end(),
+              [](const std::pair<const std::string, std::string> *lhs,
+                 const std::pair<const std::string, std::string> *rhs) {
+                return lhs->first < rhs->first;
+              });
+    writer.StartObject();
+    for (const auto *item : info) {
+      writer.Key(item->first);
+      writer.String(item->second);
+    }
+    writer.EndObject();
+    writer.Key(kKeyReconnect);
+    writer.Bool(is_reconnect_);
+    writer.Key(kKeyType);
+    writer.String(kRuntimeType);
+    writer.EndObject();
   };
 };
 
 struct RemoteDebugProtocolBodyData4Registered : public Stringifiable {
+  // envelope encoding chosen by the server, empty for json. See
+  // binary_envelope.h.
+  std::string envelope_encoding_;
+
   ~RemoteDebugProtocolBodyData4Registered() override = default;
 
-  void Stringify(Json::Value &data) override {
-    Json::Value v(Json::objectValue);
-    data = v;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.EndObject();
   }
 };
 
@@ -155,12 +193,15 @@ struct RemoteDebugProtocolBodyData4ChangeRoomServer : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4ChangeRoomServer() override = default;
 
-  void Stringify(Json::Value &data) override {
-    Json::Value v(Json::objectValue);
-    v[kKeyId] = client_id_;
-    v[kKeyRoom] = room_id_;
-    v[kKeyUrl] = url_;
-    data = v;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyId);
+    writer.Uint(client_id_);
+    writer.Key(kKeyRoom);
+    writer.String(room_id_);
+    writer.Key(kKeyUrl);
+    writer.String(url_);
+    writer.EndObject();
   };
 };
 
@@ -169,7 +210,7 @@ struct RemoteDebugProtocolBodyData4ChangeRoomServerAck : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4ChangeRoomServerAck() override = default;
 
-  void Stringify(Json::Value &data) override { data = client_id_; };
+  void Stringify(ProtocolWriter &writer) override { writer.Uint(client_id_); };
 };
 
 struct SessionInfo {
@@ -178,21 +219,45 @@ struct SessionInfo {
   std::string type_;
 };
 
+inline void StringifySessionInfo(const SessionInfo &info,
+                                 ProtocolWriter &writer) {
+  writer.StartObject();
+  writer.Key(kKeySessionId);
+  writer.Int(info.session_id_);
+  writer.Key(kKeyType);
+  writer.String(info.type_);
+  writer.Key(kKeyUrl);
+  writer.String(info.url_);
+  writer.EndObject();
+}
+
+// data of SessionList and SessionAdded.
 struct CustomData4SessionList : public Stringifiable {
   std::vector<std::shared_ptr<SessionInfo>> list_;
 
   ~CustomData4SessionList() override = default;
 
-  void Stringify(Json::Value &ref) override {
-    Json::Value v(Json::arrayValue);
-    for (std::shared_ptr<SessionInfo> it : list_) {
-      Json::Value sessionItem(Json::objectValue);
-      sessionItem[kKeySessionId] = it->session_id_;
-      sessionItem[kKeyUrl] = it->url_;
-      sessionItem[kKeyType] = it->type_;
-      v[v.size()] = sessionItem;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartArray();
+    for (const std::shared_ptr<SessionInfo> &it : list_) {
+      StringifySessionInfo(*it, writer);
+    }
+    writer.EndArray();
+  }
+};
+
+// data of SessionRemoved.
+struct CustomData4SessionRemoved : public Stringifiable {
+  std::vector<int> session_ids_;
+
+  ~CustomData4SessionRemoved() override = default;
+
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartArray();
+    for (int session_id : session_ids_) {
+      writer.Int(session_id);
     }
-    ref = v;
+    writer.EndArray();
   }
 };
 
@@ -213,23 +278,42 @@ struct AppMessageData : public Stringifiable {
   // is not part of message
   AppMessageDataUnionType union_type_;
 
-  void Stringify(Json::Value &ref) override {
-    Json::Value value(Json::objectValue);
-    value[kKeyMethod] = method_;
-    value[kKeyId] = id_;
+  // Writes the "message" member of the enclosing object, the message itself
+  // is carried as a json string.
+  void Stringify(ProtocolWriter &writer) override {
+    std::string message;
+    ProtocolWriter message_writer(message);
+    message_writer.StartObject();
     switch (union_type_) {
       case kParams:
-        value[kKeyParams] = params_;
+        message_writer.Key(kKeyId);
+        message_writer.Int(id_);
+        message_writer.Key(kKeyMethod);
+        message_writer.String(method_);
+        message_writer.Key(kKeyParams);
+        message_writer.String(params_);
         break;
       case kResult:
-        value[kKeyResult] = result_;
+        message_writer.Key(kKeyId);
+        message_writer.Int(id_);
+        message_writer.Key(kKeyMethod);
+        message_writer.String(method_);
+        message_writer.Key(kKeyResult);
+        message_writer.String(result_);
         break;
       case kError:
-        value[kKeyError] = error_;
+        message_writer.Key(kKeyError);
+        message_writer.String(error_);
       default:
         LOGE("AppMessageData Stringify: unknown type");
+        message_writer.Key(kKeyId);
+        message_writer.Int(id_);
+        message_writer.Key(kKeyMethod);
+        message_writer.String(method_);
     }
-    ref[kKeyMessage] = value.toStyledString();
+    message_writer.EndObject();
+    writer.Key(kKeyMessage);
+    writer.String(message);
   }
 
   ~AppMessageData() {}
@@ -256,23 +340,25 @@ struct CustomData4CDP : public Stringifiable {
   int session_id_;
   RemoteDebugPrococolClientId client_id_;
   std::string message_;
+  // message_ is a serialized json object and is spliced into the envelope
+  // as is, instead of being carried as a json string.
   bool is_object_ = false;
 
   ~CustomData4CDP() override = default;
 
-  void Stringify(Json::Value &ref) override {
-    Json::Value v(Json::objectValue);
-    v[kKeySessionId] = session_id_;
-    v[kKeyClientId] = client_id_;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyClientId);
+    writer.Uint(client_id_);
+    writer.Key(kKeyMessage);
     if (is_object_) {
-      Json::Reader reader;
-      Json::Value object;
-      reader.parse(message_, object);
-      v[kKeyMessage] = object;
+      writer.Raw(message_);
     } else {
-      v[kKeyMessage] = message_;
+      writer.String(message_);
     }
-    ref = v;
+    writer.Key(kKeySessionId);
+    writer.Int(session_id_);
+    writer.EndObject();
   }
 };
 
@@ -281,20 +367,26 @@ typedef CustomData4CDP CustomData4Extension;
 struct CustomData4OpenCard : public Stringifiable {
   std::string type;
   std::string url;
-  void Stringify(Json::Value &ref) override {
-    Json::Value v(Json::objectValue);
-    v[kKeyType] = type;
-    v[kKeyUrl] = url;
-    ref = v;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyType);
+    writer.String(type);
+    writer.Key(kKeyUrl);
+    writer.String(url);
+    writer.EndObject();
   }
 };
 
 struct CustomData4ListSession : public Stringifiable {
   RemoteDebugPrococolClientId client_id_;
-  void Stringify(Json::Value &ref) override {
-    Json::Value v(Json::objectValue);
-    v[kKeyClientId] = client_id_;
-    ref = v;
+  // the peer understands SessionAdded/SessionRemoved, the following changes
+  // of the session list are sent as deltas on top of the full list.
+  bool delta_ = false;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyClientId);
+    writer.Uint(client_id_);
+    writer.EndObject();
   }
 };
 
@@ -302,13 +394,14 @@ struct AppProtocolData : public Stringifiable {
   RemoteDebugPrococolClientId client_id_;
   std::shared_ptr<AppMessageData> app_message_data_;
   ~AppProtocolData() = default;
-  void Stringify(Json::Value &ref) override {
-    Json::Value value(Json::objectValue);
-    value[kKeyClientId] = client_id_;
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyClientId);
+    writer.Uint(client_id_);
     if (app_message_data_) {
-      app_message_data_->Stringify(value);
+      app_message_data_->Stringify(writer);
     }
-    ref = value;
+    writer.EndObject();
   }
 
   AppProtocolData(RemoteDebugPrococolClientId clientId,
@@ -321,6 +414,10 @@ struct RemoteDebugProtocolBodyData4Custom : public Stringifiable {
   // TODO(zhanglei): change to union
   std::shared_ptr<CustomData4CDP> cdp_data_;
   std::shared_ptr<CustomData4SessionList> session_data_list_;
+  std::shared_ptr<CustomData4SessionRemoved> session_removed_data_;
+  // digest of the whole session list once this message is applied, see
+  // processor::SessionRegistry. Only written when not empty.
+  std::string session_digest_;
   std::shared_ptr<CustomData4OpenCard> open_card_data_;
   std::shared_ptr<CustomData4ListSession>
       list_session_data_;  // is diffent from CustomData4SessionList !!
@@ -331,72 +428,79 @@ struct RemoteDebugProtocolBodyData4Custom : public Stringifiable {
 
   ~RemoteDebugProtocolBodyData4Custom() = default;
 
-  void Stringify(Json::Value &ref) override {
-    Json::Value v(Json::objectValue);
-    v[kKeyType] = type_;
-    v[kKeySender] = client_id_;
-
-    if (Is4SessionList()) {
-      this->session_data_list_->Stringify(v[kKeyData]);
-      // concatenate signature data
-      Json::FastWriter writer;
-      std::string sig_data = writer.write(v[kKeyData]) + kSignatureSalt;
-      // eliminate '\n'
-      std::string::size_type pos = 0;
-      std::string sig_data_tight = sig_data;
-      while ((pos = sig_data_tight.find("\n", pos)) != std::string::npos) {
-        sig_data_tight = sig_data_tight.replace(pos, 1, "");
+  void Stringify(ProtocolWriter &writer) override {
+    writer.StartObject();
+    writer.Key(kKeyData);
+    CustomKind kind = Kind();
+    if (kind == CustomKind::kSessionList || kind == CustomKind::kSessionAdded ||
+        kind == CustomKind::kSessionRemoved) {
+      // the signature covers the compact form of data, which is exactly
+      // what the writer just produced.
+      size_t data_begin = writer.Size();
+      if (kind == CustomKind::kSessionRemoved) {
+        this->session_removed_data_->Stringify(writer);
+      } else {
+        this->session_data_list_->Stringify(writer);
       }
-      // generate signature
-      v[kKeySignature] = md5(sig_data_tight);
-    } else if (Is4R2DStopAtEntry()) {
-      v[kKeyData] = should_stop_at_entry_;
-    } else if (Is4R2DStopLepusAtEntry()) {
-      v[kKeyData] = should_stop_lepus_at_entry_;
-    } else if (Is4MessageHandler()) {
-      app_protocol_data_->Stringify(v[kKeyData]);
+      std::string sig_data =
+          writer.Output().substr(data_begin, writer.Size() - data_begin);
+      sig_data.append(kSignatureSalt);
+      if (!session_digest_.empty()) {
+        writer.Key(kKeyDigest);
+        writer.String(session_digest_);
+      }
+      writer.Key(kKeySender);
+      writer.Uint(client_id_);
+      writer.Key(kKeySignature);
+      writer.String(md5(sig_data));
+      writer.Key(kKeyType);
+      writer.String(type_);
+      writer.EndObject();
+      return;
+    } else if (kind == CustomKind::kR2DStopAtEntry) {
+      writer.Bool(should_stop_at_entry_);
+    } else if (kind == CustomKind::kR2DStopLepusAtEntry) {
+      writer.Bool(should_stop_lepus_at_entry_);
+    } else if (kind == CustomKind::kMessageHandler) {
+      app_protocol_data_->Stringify(writer);
     } else {
-      this->cdp_data_->Stringify(v[kKeyData]);
+      this->cdp_data_->Stringify(writer);
     }
-    ref = v;
+    writer.Key(kKeySender);
+    writer.Uint(client_id_);
+    writer.Key(kKeyType);
+    writer.String(type_);
+    writer.EndObject();
   }
-  bool Is4CDP() { return type_.compare(kRemoteDebugProtocolBodyData4CDP) == 0; }
+  // |type_| is public and may change, so it is classified on each call.
+  CustomKind Kind() const { return CustomKindOf(type_); }
+  bool Is4CDP() const { return Kind() == CustomKind::kCDP; }
   std::shared_ptr<CustomData4CDP> AsCDP() { return cdp_data_; }
   std::shared_ptr<CustomData4Extension> AsExtension() { return cdp_data_; }
-  bool Is4SessionList() {
-    return type_.compare(kRemoteDebugProtocolBodyData4Custom4SessionList) == 0;
-  }
+  bool Is4SessionList() const { return Kind() == CustomKind::kSessionList; }
   std::shared_ptr<CustomData4SessionList> AsSessionList() {
     return session_data_list_;
   }
-  bool Is4R2DStopAtEntry() {
-    return type_.compare(kRemoteDebugProtocolBodyData4Custom4R2DStopAtEntry) ==
-           0;
+  bool Is4R2DStopAtEntry() const {
+    return Kind() == CustomKind::kR2DStopAtEntry;
   }
   bool AsR2DStopAtEntry() { return should_stop_at_entry_; }
-  bool Is4D2RStopAtEntry() {
-    return type_.compare(kRemoteDebugProtocolBodyData4Custom4D2RStopAtEntry) ==
-           0;
+  bool Is4D2RStopAtEntry() const {
+    return Kind() == CustomKind::kD2RStopAtEntry;
   }
   bool AsD2RStopAtEntry() { return should_stop_at_entry_; }
-  bool Is4R2DStopLepusAtEntry() {
-    return type_.compare(
-               kRemoteDebugProtocolBodyData4Custom4R2DStopLepusAtEntry) == 0;
+  bool Is4R2DStopLepusAtEntry() const {
+    return Kind() == CustomKind::kR2DStopLepusAtEntry;
   }
   bool AsR2DStopLepusAtEntry() { return should_stop_lepus_at_entry_; }
-  bool Is4D2RStopLepusAtEntry() {
-    return type_.compare(
-               kRemoteDebugProtocolBodyData4Custom4D2RStopLepusAtEntry) == 0;
+  bool Is4D2RStopLepusAtEntry() const {
+    return Kind() == CustomKind::kD2RStopLepusAtEntry;
   }
   bool AsD2RStopLepusAtEntry() { return should_stop_lepus_at_entry_; }
-  bool Is4OpenCard() {
-    return !type_.compare(kRemoteDebugProtocolBodyData4Custom4OpenCard);
-  }
-  bool Is4ListSession() {
-    return !type_.compare(kRemoteDebugProtocolBodyData4Custom4ListSession);
-  }
-  bool Is4MessageHandler() {
-    return !type_.compare(kRemoteDebugProtocolBodyData4Custom4MessageHandler);
+  bool Is4OpenCard() const { return Kind() == CustomKind::kOpenCard; }
+  bool Is4ListSession() const { return Kind() == CustomKind::kListSession; }
+  bool Is4MessageHandler() const {
+    return Kind() == CustomKind::kMessageHandler;
   }
   std::shared_ptr<CustomData4OpenCard> AsOpenCardData() {
     return open_card_data_;
@@ -405,6 +509,8 @@ struct RemoteDebugProtocolBodyData4Custom : public Stringifiable {
 
 struct RemoteDebugProtocolBody {
   std::string event_;
+  // classified once from |event_|, selects the live member of the union.
+  EventKind kind_;
   union {
     std::shared_ptr<RemoteDebugProtocolBodyData4Init> init_data_;
     std::shared_ptr<RemoteDebugProtocolBodyData4Register> register_data_;
@@ -421,45 +527,60 @@ struct RemoteDebugProtocolBody {
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4Init> init_data)
-      : event_(event), init_data_(init_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        init_data_(init_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4Register> register_data)
-      : event_(event), register_data_(register_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        register_data_(register_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4Registered> registered_data)
-      : event_(event), registered_data_(registered_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        registered_data_(registered_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4JoinRoom> join_room_data)
-      : event_(event), join_room_data_(join_room_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        join_room_data_(join_room_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4RoomJoined> room_joined_data)
-      : event_(event), room_joined_data_(room_joined_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        room_joined_data_(room_joined_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4ChangeRoomServer>
           change_room_server_data)
-      : event_(event), change_room_server_data_(change_room_server_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        change_room_server_data_(change_room_server_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4ChangeRoomServerAck>
           change_room_server_ack_data)
       : event_(event),
+        kind_(EventKindOf(event)),
         change_room_server_ack_data_(change_room_server_ack_data) {}
 
   RemoteDebugProtocolBody(
       const std::string event,
       std::shared_ptr<RemoteDebugProtocolBodyData4Custom> custom_data)
-      : event_(event), custom_data_(custom_data) {}
+      : event_(event),
+        kind_(EventKindOf(event)),
+        custom_data_(custom_data) {}
 
   bool IsProtocolBody4Init();
   std::shared_ptr<RemoteDebugProtocolBodyData4Init> AsInit();
@@ -487,40 +608,56 @@ struct RemoteDebugProtocolBody {
   bool IsProtocolBody4Custom();
   std::shared_ptr<RemoteDebugProtocolBodyData4Custom> AsCustom();
 
+  EventKind Kind() const { return kind_; }
+
   ~RemoteDebugProtocolBody() {
-    if (IsProtocolBody4Init()) {
-      init_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4Register()) {
-      register_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4Registered()) {
-      registered_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4JoinRoom()) {
-      join_room_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4RoomJoined()) {
-      room_joined_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4ChangeRoomServer()) {
-      change_room_server_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4ChangeRoomServerAck()) {
-      change_room_server_ack_data_.~shared_ptr();
-    }
-    if (IsProtocolBody4Custom()) {
-      custom_data_.~shared_ptr();
+    switch (kind_) {
+      case EventKind::kInit:
+        init_data_.~shared_ptr();
+        break;
+      case EventKind::kRegister:
+        register_data_.~shared_ptr();
+        break;
+      case EventKind::kRegistered:
+        registered_data_.~shared_ptr();
+        break;
+      case EventKind::kJoinRoom:
+        join_room_data_.~shared_ptr();
+        break;
+      case EventKind::kRoomJoined:
+        room_joined_data_.~shared_ptr();
+        break;
+      case EventKind::kChangeRoomServer:
+        change_room_server_data_.~shared_ptr();
+        break;
+      case EventKind::kChangeRoomServerAck:
+        change_room_server_ack_data_.~shared_ptr();
+        break;
+      case EventKind::kCustom:
+        custom_data_.~shared_ptr();
+        break;
+      case EventKind::kUnknown:
+        break;
     }
   }
 };
 
 namespace RemoteDebugProtocol {
 
+// Registers the envelope and CDP member names with Json::Value::internKey(),
+// so parsed messages do not copy them. Safe to call more than once.
+void InternKeys();
 std::shared_ptr<RemoteDebugProtocolBody> Parse(const Json::Value &value);
+// |source| is the text |value| was parsed from. Object messages are sliced
+// out of it instead of being serialized again.
+std::shared_ptr<RemoteDebugProtocolBody> Parse(const Json::Value &value,
+                                               const std::string &source);
 std::string Stringify(const std::shared_ptr<RemoteDebugProtocolBody> body);
 std::string Stringify(const std::shared_ptr<RemoteDebugProtocolBody> body,
                       int mark);
+// Appends the envelope to |out|, so a buffer can be reused across messages.
+void StringifyTo(const std::shared_ptr<RemoteDebugProtocolBody> &body,
+                 int mark, std::string &out);
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Register(
     RemoteDebugPrococolClientId client_id,
     std::unordered_map<std::string, std::string> client_info,
@@ -532,6 +669,8 @@ std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Init(
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4RoomJoined(
     const char *room_id, RemoteDebugPrococolClientId client_id);
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Registerd();
+std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Registerd(
+    const std::string &envelope_encoding);
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4ChangeRoomServer(
     RemoteDebugPrococolClientId client_id, RemoteDebugProtocolRoomId room_id,
     const std::string &url);
@@ -548,6 +687,9 @@ std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4AppMessage(
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
     std::string type, RemoteDebugPrococolClientId client_id,
     std::shared_ptr<CustomData4SessionList> session_list);
+std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
+    std::string type, RemoteDebugPrococolClientId client_id,
+    std::shared_ptr<CustomData4SessionRemoved> session_removed);
 std::shared_ptr<RemoteDebugProtocolBody> CreateProtocolBody4Custom(
     std::string type, RemoteDebugPrococolClientId client_id,
     bool should_stop_at_entry);
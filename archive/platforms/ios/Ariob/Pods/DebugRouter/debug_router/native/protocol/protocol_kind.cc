@@ -0,0 +1,71 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/protocol_kind.h"
+
+#include "debug_router/native/protocol/protocol.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+// A new event or custom type only needs a line here, the tables check at
+// compile time that the names still hash without collision.
+constexpr internal::NameKind<EventKind> kEventKinds[] = {
+    {kRemoteDebugServerEvent4Init, EventKind::kInit},
+    {kRemoteDebugServerEvent4Registered, EventKind::kRegistered},
+    {kRemoteDebugServerEvent4Register, EventKind::kRegister},
+    {kRemoteDebugServerEvent4JoinRoom, EventKind::kJoinRoom},
+    {kRemoteDebugServerEvent4RoomJoined, EventKind::kRoomJoined},
+    {kRemoteDebugServerEvent4ChangeRoomServer, EventKind::kChangeRoomServer},
+    {kRemoteDebugServerEvent4ChangeRoomServerAck,
+     EventKind::kChangeRoomServerAck},
+    {kRemoteDebugServerEvent4Custom, EventKind::kCustom},
+};
+
+constexpr internal::NameKind<CustomKind> kCustomKinds[] = {
+    {kRemoteDebugProtocolBodyData4CDP, CustomKind::kCDP},
+    {kRemoteDebugProtocolBodyData4Custom4ListSession, CustomKind::kListSession},
+    {kRemoteDebugProtocolBodyData4Custom4MessageHandler,
+     CustomKind::kMessageHandler},
+    {kRemoteDebugProtocolBodyData4Custom4SessionList, CustomKind::kSessionList},
+    {kRemoteDebugProtocolBodyData4Custom4SessionAdded,
+     CustomKind::kSessionAdded},
+    {kRemoteDebugProtocolBodyData4Custom4SessionRemoved,
+     CustomKind::kSessionRemoved},
+    {kRemoteDebugProtocolBodyData4Custom4OpenSession, CustomKind::kOpenSession},
+    {kRemoteDebugProtocolBodyData4Custom4CloseSession,
+     CustomKind::kCloseSession},
+    {kRemoteDebugProtocolBodyData4Custom4D2RStopAtEntry,
+     CustomKind::kD2RStopAtEntry},
+    {kRemoteDebugProtocolBodyData4Custom4R2DStopAtEntry,
+     CustomKind::kR2DStopAtEntry},
+    {kRemoteDebugProtocolBodyData4Custom4D2RStopLepusAtEntry,
+     CustomKind::kD2RStopLepusAtEntry},
+    {kRemoteDebugProtocolBodyData4Custom4R2DStopLepusAtEntry,
+     CustomKind::kR2DStopLepusAtEntry},
+    {kRemoteDebugProtocolBodyData4Custom4OpenCard, CustomKind::kOpenCard},
+};
+
+constexpr internal::KindTable<EventKind, 16> kEventTable(kEventKinds);
+static_assert(kEventTable.IsPerfect(),
+              "event names collide, grow the event table");
+
+constexpr internal::KindTable<CustomKind, 32> kCustomTable(kCustomKinds);
+static_assert(kCustomTable.IsPerfect(),
+              "custom types collide, grow the custom table");
+
+}  // namespace
+
+EventKind EventKindOf(const char *name, size_t length) {
+  return kEventTable.Find(name, length, EventKind::kUnknown);
+}
+
+CustomKind CustomKindOf(const char *name, size_t length) {
+  return kCustomTable.Find(name, length, CustomKind::kOther);
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
@@ -0,0 +1,156 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_KIND_H_
+#define DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_KIND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace debugrouter {
+namespace protocol {
+
+// "event" of an envelope, one per kRemoteDebugServerEvent4* constant.
+enum class EventKind : uint8_t {
+  kUnknown,
+  kInit,
+  kRegistered,
+  kRegister,
+  kJoinRoom,
+  kRoomJoined,
+  kChangeRoomServer,
+  kChangeRoomServerAck,
+  kCustom,
+};
+
+// "type" of a Customized envelope, one per kRemoteDebugProtocolBodyData4*
+// constant. Types registered by extensions at runtime are kOther.
+enum class CustomKind : uint8_t {
+  kOther,
+  kCDP,
+  kListSession,
+  kMessageHandler,
+  kSessionList,
+  kSessionAdded,
+  kSessionRemoved,
+  kOpenSession,
+  kCloseSession,
+  kD2RStopAtEntry,
+  kR2DStopAtEntry,
+  kD2RStopLepusAtEntry,
+  kR2DStopLepusAtEntry,
+  kOpenCard,
+};
+
+EventKind EventKindOf(const char *name, size_t length);
+inline EventKind EventKindOf(const std::string &name) {
+  return EventKindOf(name.data(), name.size());
+}
+
+CustomKind CustomKindOf(const char *name, size_t length);
+inline CustomKind CustomKindOf(const std::string &name) {
+  return CustomKindOf(name.data(), name.size());
+}
+
+namespace internal {
+
+template <typename Kind>
+struct NameKind {
+  const char *name;
+  Kind kind;
+};
+
+constexpr size_t ConstLength(const char *name) {
+  size_t length = 0;
+  while (name[length]) {
+    ++length;
+  }
+  return length;
+}
+
+// 32 bits FNV-1a, with the offset basis perturbed by |seed|. The low bits of
+// FNV only depend on the low bits of its input, so the result goes through a
+// final mix before it is masked into a slot.
+constexpr uint32_t HashName(uint32_t seed, const char *name, size_t length) {
+  uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+/*
+ * Perfect hash table from a fixed set of names to their kind.
+ *
+ * The constructor is meant to run at compile time: it searches a seed for
+ * which every name hashes to its own slot, check IsPerfect() in a
+ * static_assert. A lookup then hashes the name once and compares it with the
+ * single name stored in that slot, to reject names outside of the set.
+ */
+template <typename Kind, size_t Capacity>
+class KindTable {
+ public:
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+  template <size_t N>
+  constexpr explicit KindTable(const NameKind<Kind> (&entries)[N])
+      : seed_(0), names_(), lengths_(), kinds_() {
+    static_assert(N <= Capacity, "more names than slots");
+    while (seed_ < kMaxSeed && !TryBuild(entries, N)) {
+      ++seed_;
+    }
+  }
+
+  constexpr bool IsPerfect() const { return seed_ < kMaxSeed; }
+
+  Kind Find(const char *name, size_t length, Kind fallback) const {
+    size_t slot = HashName(seed_, name, length) & (Capacity - 1);
+    if (lengths_[slot] != length || names_[slot] == nullptr ||
+        memcmp(names_[slot], name, length) != 0) {
+      return fallback;
+    }
+    return kinds_[slot];
+  }
+
+ private:
+  static constexpr uint32_t kMaxSeed = 1024;
+
+  constexpr bool TryBuild(const NameKind<Kind> *entries, size_t count) {
+    for (size_t i = 0; i < Capacity; ++i) {
+      names_[i] = nullptr;
+      lengths_[i] = 0;
+      kinds_[i] = Kind();
+    }
+    for (size_t i = 0; i < count; ++i) {
+      size_t length = ConstLength(entries[i].name);
+      size_t slot =
+          HashName(seed_, entries[i].name, length) & (Capacity - 1);
+      if (names_[slot] != nullptr) {
+        return false;
+      }
+      names_[slot] = entries[i].name;
+      lengths_[slot] = length;
+      kinds_[slot] = entries[i].kind;
+    }
+    return true;
+  }
+
+  uint32_t seed_;
+  const char *names_[Capacity];
+  size_t lengths_[Capacity];
+  Kind kinds_[Capacity];
+};
+
+}  // namespace internal
+}  // namespace protocol
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_KIND_H_
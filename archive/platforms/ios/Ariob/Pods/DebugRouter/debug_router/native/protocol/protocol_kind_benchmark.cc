@@ -0,0 +1,72 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "debug_router/native/protocol/protocol.h"
+#include "debug_router/native/protocol/protocol_kind.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+// What RemoteDebugProtocol::Parse and Processor::process compared before
+// the kinds were introduced, in the same order.
+int CompareCustomType(const std::string &type) {
+  const char *const kTypes[] = {
+      kRemoteDebugProtocolBodyData4CDP,
+      kRemoteDebugProtocolBodyData4Custom4ListSession,
+      kRemoteDebugProtocolBodyData4Custom4MessageHandler,
+      kRemoteDebugProtocolBodyData4Custom4SessionList,
+      kRemoteDebugProtocolBodyData4Custom4OpenSession,
+      kRemoteDebugProtocolBodyData4Custom4CloseSession,
+      kRemoteDebugProtocolBodyData4Custom4D2RStopAtEntry,
+      kRemoteDebugProtocolBodyData4Custom4R2DStopAtEntry,
+      kRemoteDebugProtocolBodyData4Custom4D2RStopLepusAtEntry,
+      kRemoteDebugProtocolBodyData4Custom4R2DStopLepusAtEntry,
+      kRemoteDebugProtocolBodyData4Custom4OpenCard};
+  int index = 0;
+  for (const char *name : kTypes) {
+    if (type == name) {
+      return index;
+    }
+    ++index;
+  }
+  return -1;
+}
+
+// Mostly CDP, as during a session, with the occasional control message and
+// an extension type that matches nothing.
+std::vector<std::string> CustomTypes() {
+  std::vector<std::string> types(14, kRemoteDebugProtocolBodyData4CDP);
+  types.push_back(kRemoteDebugProtocolBodyData4Custom4OpenCard);
+  types.push_back("App.Log");
+  return types;
+}
+
+void BM_CustomTypeStringCompare(benchmark::State &state) {
+  std::vector<std::string> types = CustomTypes();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CompareCustomType(types[i++ % types.size()]));
+  }
+}
+BENCHMARK(BM_CustomTypeStringCompare);
+
+void BM_CustomTypeKindTable(benchmark::State &state) {
+  std::vector<std::string> types = CustomTypes();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CustomKindOf(types[i++ % types.size()]));
+  }
+}
+BENCHMARK(BM_CustomTypeKindTable);
+
+}  // namespace
+
+}  // namespace protocol
+}  // namespace debugrouter
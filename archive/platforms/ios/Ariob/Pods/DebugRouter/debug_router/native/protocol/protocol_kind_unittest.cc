@@ -0,0 +1,75 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/protocol_kind.h"
+
+#include "debug_router/native/protocol/protocol.h"
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace protocol {
+
+TEST(ProtocolKindTest, KnownEvents) {
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4Init), EventKind::kInit);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4Registered),
+            EventKind::kRegistered);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4Register),
+            EventKind::kRegister);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4JoinRoom),
+            EventKind::kJoinRoom);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4RoomJoined),
+            EventKind::kRoomJoined);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4ChangeRoomServer),
+            EventKind::kChangeRoomServer);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4ChangeRoomServerAck),
+            EventKind::kChangeRoomServerAck);
+  EXPECT_EQ(EventKindOf(kRemoteDebugServerEvent4Custom), EventKind::kCustom);
+}
+
+TEST(ProtocolKindTest, KnownCustomTypes) {
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4CDP), CustomKind::kCDP);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4ListSession),
+            CustomKind::kListSession);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4MessageHandler),
+            CustomKind::kMessageHandler);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4SessionList),
+            CustomKind::kSessionList);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4SessionAdded),
+            CustomKind::kSessionAdded);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4SessionRemoved),
+            CustomKind::kSessionRemoved);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4OpenSession),
+            CustomKind::kOpenSession);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4CloseSession),
+            CustomKind::kCloseSession);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4D2RStopAtEntry),
+            CustomKind::kD2RStopAtEntry);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4R2DStopAtEntry),
+            CustomKind::kR2DStopAtEntry);
+  EXPECT_EQ(
+      CustomKindOf(kRemoteDebugProtocolBodyData4Custom4D2RStopLepusAtEntry),
+      CustomKind::kD2RStopLepusAtEntry);
+  EXPECT_EQ(
+      CustomKindOf(kRemoteDebugProtocolBodyData4Custom4R2DStopLepusAtEntry),
+      CustomKind::kR2DStopLepusAtEntry);
+  EXPECT_EQ(CustomKindOf(kRemoteDebugProtocolBodyData4Custom4OpenCard),
+            CustomKind::kOpenCard);
+}
+
+TEST(ProtocolKindTest, UnknownNames) {
+  const char *names[] = {"",            "unknown",    "Customize",
+                         "Customized ", "customized", "CDP2",
+                         "CD",          "OpenCar",    "SessionAdd",
+                         "App.Log"};
+  for (const char *name : names) {
+    EXPECT_EQ(EventKindOf(name), EventKind::kUnknown) << name;
+    EXPECT_EQ(CustomKindOf(name), CustomKind::kOther) << name;
+  }
+  // Only |length| bytes take part in the lookup.
+  EXPECT_EQ(CustomKindOf("CDPx", 3), CustomKind::kCDP);
+  EXPECT_EQ(EventKindOf(std::string("Customized\0", 11)), EventKind::kUnknown);
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
@@ -0,0 +1,276 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/protocol_writer.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "debug_router/native/protocol/envelope_scanner.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+inline bool NeedsEscape(unsigned char c) {
+  return c < 0x20 || c == '"' || c == '\\';
+}
+
+void AppendUint(std::string &out, uint64_t value) {
+  char buffer[24];
+  char *end = buffer + sizeof(buffer);
+  char *current = end;
+  do {
+    *--current = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  out.append(current, end - current);
+}
+
+void AppendInt(std::string &out, int64_t value) {
+  if (value < 0) {
+    out.push_back('-');
+    // negate in unsigned space, INT64_MIN has no positive counterpart.
+    AppendUint(out, ~static_cast<uint64_t>(value) + 1);
+  } else {
+    AppendUint(out, static_cast<uint64_t>(value));
+  }
+}
+
+}  // namespace
+
+ProtocolWriter::ProtocolWriter(std::string &out)
+    : out_(out), has_element_(0), depth_(0), after_key_(false) {}
+
+void ProtocolWriter::BeforeValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ == 0) {
+    return;
+  }
+  uint32_t bit = 1u << (depth_ - 1);
+  if (has_element_ & bit) {
+    out_.push_back(',');
+  } else {
+    has_element_ |= bit;
+  }
+}
+
+void ProtocolWriter::Push() {
+  assert(depth_ < kMaxDepth);
+  ++depth_;
+  has_element_ &= ~(1u << (depth_ - 1));
+}
+
+void ProtocolWriter::Pop() {
+  assert(depth_ > 0);
+  --depth_;
+}
+
+void ProtocolWriter::StartObject() {
+  BeforeValue();
+  out_.push_back('{');
+  Push();
+}
+
+void ProtocolWriter::EndObject() {
+  Pop();
+  out_.push_back('}');
+}
+
+void ProtocolWriter::StartArray() {
+  BeforeValue();
+  out_.push_back('[');
+  Push();
+}
+
+void ProtocolWriter::EndArray() {
+  Pop();
+  out_.push_back(']');
+}
+
+void ProtocolWriter::Key(const char *key) {
+  BeforeValue();
+  AppendEscaped(out_, key, strlen(key));
+  out_.push_back(':');
+  after_key_ = true;
+}
+
+void ProtocolWriter::Key(const std::string &key) {
+  BeforeValue();
+  AppendEscaped(out_, key.data(), key.size());
+  out_.push_back(':');
+  after_key_ = true;
+}
+
+void ProtocolWriter::String(const char *value) {
+  String(value, strlen(value));
+}
+
+void ProtocolWriter::String(const std::string &value) {
+  String(value.data(), value.size());
+}
+
+void ProtocolWriter::String(const char *value, size_t length) {
+  BeforeValue();
+  AppendEscaped(out_, value, length);
+}
+
+void ProtocolWriter::Int(int64_t value) {
+  BeforeValue();
+  AppendInt(out_, value);
+}
+
+void ProtocolWriter::Uint(uint64_t value) {
+  BeforeValue();
+  AppendUint(out_, value);
+}
+
+void ProtocolWriter::Bool(bool value) {
+  BeforeValue();
+  out_.append(value ? "true" : "false");
+}
+
+void ProtocolWriter::Null() {
+  BeforeValue();
+  out_.append("null");
+}
+
+void ProtocolWriter::Value(const Json::Value &value) {
+  BeforeValue();
+  AppendValue(value);
+}
+
+void ProtocolWriter::Raw(const char *json, size_t length) {
+  BeforeValue();
+  if (EnvelopeScanner::Validate(json, length)) {
+    out_.append(json, length);
+    return;
+  }
+  // comments, deep nesting or broken text, as Json::Reader sees it.
+  Json::Reader reader;
+  Json::Value value;
+  if (!reader.parse(json, json + length, value, false)) {
+    value = Json::Value();
+  }
+  AppendValue(value);
+}
+
+void ProtocolWriter::Raw(const std::string &json) {
+  Raw(json.data(), json.size());
+}
+
+void ProtocolWriter::AppendValue(const Json::Value &value) {
+  switch (value.type()) {
+    case Json::nullValue:
+      out_.append("null");
+      break;
+    case Json::intValue:
+      AppendInt(out_, value.asLargestInt());
+      break;
+    case Json::uintValue:
+      AppendUint(out_, value.asLargestUInt());
+      break;
+    case Json::realValue:
+      out_.append(Json::valueToString(value.asDouble()));
+      break;
+    case Json::stringValue: {
+      const char *begin;
+      const char *end;
+      if (value.getString(&begin, &end)) {
+        AppendEscaped(out_, begin, end - begin);
+      }
+      break;
+    }
+    case Json::booleanValue:
+      out_.append(value.asBool() ? "true" : "false");
+      break;
+    case Json::arrayValue: {
+      out_.push_back('[');
+      Json::ArrayIndex size = value.size();
+      for (Json::ArrayIndex index = 0; index < size; ++index) {
+        if (index > 0) {
+          out_.push_back(',');
+        }
+        AppendValue(value[index]);
+      }
+      out_.push_back(']');
+      break;
+    }
+    case Json::objectValue: {
+      // members are visited in key order, same as Json::FastWriter.
+      out_.push_back('{');
+      bool first = true;
+      for (auto it = value.begin(); it != value.end(); ++it) {
+        if (!first) {
+          out_.push_back(',');
+        }
+        first = false;
+        const char *key_end;
+        const char *key = it.memberName(&key_end);
+        AppendEscaped(out_, key, key_end - key);
+        out_.push_back(':');
+        AppendValue(*it);
+      }
+      out_.push_back('}');
+      break;
+    }
+  }
+}
+
+void ProtocolWriter::AppendEscaped(std::string &out, const char *value,
+                                   size_t length) {
+  out.push_back('"');
+  const char *end = value + length;
+  const char *run = value;
+  for (const char *c = value; c != end; ++c) {
+    unsigned char ch = static_cast<unsigned char>(*c);
+    if (!NeedsEscape(ch)) {
+      continue;
+    }
+    out.append(run, c - run);
+    run = c + 1;
+    switch (ch) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\b':
+        out.append("\\b");
+        break;
+      case '\f':
+        out.append("\\f");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      case '\r':
+        out.append("\\r");
+        break;
+      case '\t':
+        out.append("\\t");
+        break;
+      default: {
+        char escaped[6] = {'\\', 'u', '0', '0', kHexDigits[ch >> 4],
+                           kHexDigits[ch & 0xF]};
+        out.append(escaped, sizeof(escaped));
+        break;
+      }
+    }
+  }
+  out.append(run, end - run);
+  out.push_back('"');
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
@@ -0,0 +1,80 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_WRITER_H_
+#define DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "json/value.h"
+
+namespace debugrouter {
+namespace protocol {
+
+/*
+ * Single pass, compact json writer used to serialize protocol envelopes
+ * without building a Json::Value tree.
+ *
+ * The output is appended to |out|, so the caller can reuse a buffer across
+ * messages. Strings are escaped and numbers are formatted the same way as
+ * Json::FastWriter, callers are expected to emit object keys in sorted order
+ * to stay byte-compatible with it.
+ */
+class ProtocolWriter {
+ public:
+  explicit ProtocolWriter(std::string &out);
+
+  void StartObject();
+  void EndObject();
+  void StartArray();
+  void EndArray();
+
+  void Key(const char *key);
+  void Key(const std::string &key);
+
+  void String(const char *value);
+  void String(const std::string &value);
+  void String(const char *value, size_t length);
+  void Int(int64_t value);
+  void Uint(uint64_t value);
+  void Bool(bool value);
+  void Null();
+
+  // Writes a whole Json::Value subtree in compact form.
+  void Value(const Json::Value &value);
+
+  // Splices an already serialized json value. Text that is not plain json
+  // is parsed with Json::Reader and rewritten, and written as null if that
+  // fails too, so the output is always valid.
+  void Raw(const char *json, size_t length);
+  void Raw(const std::string &json);
+
+  // Current size of the output, can be used to slice out a written value.
+  size_t Size() const { return out_.size(); }
+  const std::string &Output() const { return out_; }
+
+  static void AppendEscaped(std::string &out, const char *value,
+                            size_t length);
+
+ private:
+  static constexpr uint32_t kMaxDepth = 32;
+
+  void BeforeValue();
+  void Push();
+  void Pop();
+  void AppendValue(const Json::Value &value);
+
+  std::string &out_;
+  // one bit per nesting level, set once the level holds an element.
+  uint32_t has_element_;
+  uint32_t depth_;
+  bool after_key_;
+};
+
+}  // namespace protocol
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_PROTOCOL_PROTOCOL_WRITER_H_
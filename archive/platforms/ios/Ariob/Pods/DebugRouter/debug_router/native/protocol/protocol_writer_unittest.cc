@@ -0,0 +1,78 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/protocol/protocol_writer.h"
+
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+namespace debugrouter {
+namespace protocol {
+
+namespace {
+
+std::string WriteRaw(const std::string &json) {
+  std::string out;
+  ProtocolWriter writer(out);
+  writer.StartObject();
+  writer.Key("message");
+  writer.Raw(json);
+  writer.Key("sessionId");
+  writer.Int(1);
+  writer.EndObject();
+  return out;
+}
+
+}  // namespace
+
+TEST(ProtocolWriterTest, RawSplicesValidJson) {
+  EXPECT_EQ(WriteRaw("{\"id\":1,\"method\":\"Page.enable\"}"),
+            "{\"message\":{\"id\":1,\"method\":\"Page.enable\"},"
+            "\"sessionId\":1}");
+  EXPECT_EQ(WriteRaw(" [1, \"a\"] "), "{\"message\": [1, \"a\"] ,"
+                                      "\"sessionId\":1}");
+}
+
+TEST(ProtocolWriterTest, RawRewritesWhatOnlyJsonReaderAccepts) {
+  EXPECT_EQ(WriteRaw("// comment\n{\"id\":1}"),
+            "{\"message\":{\"id\":1},\"sessionId\":1}");
+  // Json::Reader stops after the first value.
+  EXPECT_EQ(WriteRaw("{\"id\":1}}"),
+            "{\"message\":{\"id\":1},\"sessionId\":1}");
+}
+
+TEST(ProtocolWriterTest, RawWritesNullForInvalidJson) {
+  EXPECT_EQ(WriteRaw(""), "{\"message\":null,\"sessionId\":1}");
+  EXPECT_EQ(WriteRaw("{\"id\":1"), "{\"message\":null,\"sessionId\":1}");
+  EXPECT_EQ(WriteRaw("not json"), "{\"message\":null,\"sessionId\":1}");
+}
+
+TEST(ProtocolWriterTest, OutputParses) {
+  const char *inputs[] = {"{\"a\":[1,2,{\"b\":null}]}", "{\"a\":", "\"x\"",
+                          "1e5", "tru", "{\"a\":1,}"};
+  for (const char *input : inputs) {
+    Json::Reader reader;
+    Json::Value root;
+    EXPECT_TRUE(reader.parse(WriteRaw(input), root, false)) << input;
+  }
+}
+
+TEST(ProtocolWriterTest, MatchesFastWriter) {
+  Json::Value value(Json::objectValue);
+  value["b"] = "quote \" and \\ and \x01";
+  value["a"] = Json::Value(Json::arrayValue);
+  value["a"].append(-1);
+  value["a"].append(2.5);
+  value["a"].append(true);
+  std::string out;
+  ProtocolWriter(out).Value(value);
+  Json::FastWriter fast_writer;
+  std::string expected = fast_writer.write(value);
+  expected.pop_back();
+  EXPECT_EQ(out, expected);
+}
+
+}  // namespace protocol
+}  // namespace debugrouter
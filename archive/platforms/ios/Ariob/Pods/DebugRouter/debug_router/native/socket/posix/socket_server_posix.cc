@@ -101,6 +101,7 @@ void SocketServerPosix::Start() {
   }
   LOGI("create a new usb client.");
   temp_usb_client_ = std::make_shared<UsbClient>(accept_socket_fd);
+  temp_usb_client_->SetTransportStats(transport_stats_);
   std::shared_ptr<ClientListener> listener =
       std::make_shared<ClientListener>(shared_from_this());
   temp_usb_client_->Init();
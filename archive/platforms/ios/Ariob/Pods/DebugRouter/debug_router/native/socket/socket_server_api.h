@@ -10,6 +10,7 @@
 #include <string>
 #include <thread>
 
+#include "debug_router/native/base/transport_stats.h"
 #include "debug_router/native/log/logging.h"
 #include "debug_router/native/socket/count_down_latch.h"
 #include "debug_router/native/socket/socket_server_type.h"
@@ -33,6 +34,10 @@ class SocketServer : public std::enable_shared_from_this<SocketServer> {
   virtual ~SocketServer();
 
   void Init();
+  // Shared with every usb client, must be set before Init().
+  void SetTransportStats(const std::shared_ptr<base::TransportStats> &stats) {
+    transport_stats_ = stats;
+  }
   bool Send(const std::string &message);
   void Disconnect();
 
@@ -66,6 +71,7 @@ class SocketServer : public std::enable_shared_from_this<SocketServer> {
   std::mutex queue_lock_;
   std::shared_ptr<UsbClient> usb_client_;
   std::shared_ptr<UsbClient> temp_usb_client_;
+  std::shared_ptr<base::TransportStats> transport_stats_;
 
   volatile SocketType socket_fd_ = kInvalidSocket;
 };
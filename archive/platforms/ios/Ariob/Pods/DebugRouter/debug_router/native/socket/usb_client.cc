@@ -191,7 +191,7 @@ void UsbClient::ReadMessage() {
   }
   LOGI("UsbClient: ReadMessage thread exit.");
   incoming_message_queue_.put(std::move(kMessageQuit));
-  outgoing_message_queue_.put(std::move(kMessageQuit));
+  outgoing_message_queue_.put(OutgoingMessage{kMessageQuit, {}});
 }
 
 void UsbClient::StartReader() {
@@ -265,8 +265,8 @@ void UsbClient::WrapHeader(const std::string &message, std::string &result) {
 void UsbClient::WriteMessage() {
   LOGI("UsbClient: WriteMessage:" << socket_guard_.Get());
   while (true) {
-    std::string message;
-    message = outgoing_message_queue_.take();
+    OutgoingMessage outgoing = outgoing_message_queue_.take();
+    const std::string &message = outgoing.message;
 
     if (message == kMessageQuit) {
       LOGI("UsbClient: WriteMessage receive MESSAGE_QUIT.");
@@ -286,6 +286,9 @@ void UsbClient::WriteMessage() {
         }
         break;
       }
+      if (transport_stats_) {
+        transport_stats_->OnSent(message.size(), outgoing.queued_time);
+      }
     } else {
       LOGI("UsbClient: WriteMessage receive empty message.");
     }
@@ -307,7 +310,7 @@ void UsbClient::StartWriter() {
 void UsbClient::DisconnectInternal() {
   LOGI("UsbClient: DisconnectInternal.");
   incoming_message_queue_.put(std::move(kMessageQuit));
-  outgoing_message_queue_.put(std::move(kMessageQuit));
+  outgoing_message_queue_.put(OutgoingMessage{kMessageQuit, {}});
   socket_guard_.Reset();
 }
 
@@ -318,9 +321,14 @@ bool UsbClient::Send(const std::string &message) {
     LOGE("current protocol only support 1UL << 32 bytes message");
     return false;
   }
-  work_thread_.submit([client_ptr = shared_from_this(), message]() {
-    client_ptr->SendInternal(message);
-  });
+  base::TransportStats::Clock::time_point queued_time;
+  if (transport_stats_) {
+    queued_time = transport_stats_->OnQueued(message.size());
+  }
+  work_thread_.submit(
+      [client_ptr = shared_from_this(), message, queued_time]() {
+        client_ptr->SendInternal(message, queued_time);
+      });
   return true;
 }
 
@@ -333,17 +341,24 @@ void UsbClient::Stop() {
   work_thread_.shutdown();
   incoming_message_queue_.clear();
   outgoing_message_queue_.clear();
+  if (transport_stats_) {
+    transport_stats_->Reset();
+  }
   connect_status_ = USBConnectStatus::DISCONNECTED;
 }
 
-void UsbClient::SendInternal(const std::string &message) {
+void UsbClient::SendInternal(
+    const std::string &message,
+    base::TransportStats::Clock::time_point queued_time) {
   LOGI("UsbClient: SendInternal.");
   if (connect_status_ != USBConnectStatus::CONNECTED) {
     LOGI("current usb client is not connected:" << message);
+    if (transport_stats_) {
+      transport_stats_->OnDropped(message.size());
+    }
     return;
   }
-  std::string non_const_message = message;
-  outgoing_message_queue_.put(std::move(non_const_message));
+  outgoing_message_queue_.put(OutgoingMessage{message, queued_time});
 }
 
 UsbClient::~UsbClient() {
@@ -6,6 +6,7 @@
 #define DEBUGROUTER_NATIVE_SOCKET_USB_CLIENT_H_
 
 #include "debug_router/native/base/socket_guard.h"
+#include "debug_router/native/base/transport_stats.h"
 #include "debug_router/native/socket/blocking_queue.h"
 #include "debug_router/native/socket/count_down_latch.h"
 #include "debug_router/native/socket/socket_server_type.h"
@@ -36,11 +37,21 @@ class UsbClient : public std::enable_shared_from_this<UsbClient> {
   ~UsbClient();
 
   void SetConnectStatus(USBConnectStatus status);
+  // Must be set before StartUp().
+  void SetTransportStats(const std::shared_ptr<base::TransportStats> &stats) {
+    transport_stats_ = stats;
+  }
 
  private:
+  struct OutgoingMessage {
+    std::string message;
+    base::TransportStats::Clock::time_point queued_time;
+  };
+
   void StartInternal(const std::shared_ptr<UsbClientListener> &listener);
   void DisconnectInternal();
-  void SendInternal(const std::string &message);
+  void SendInternal(const std::string &message,
+                    base::TransportStats::Clock::time_point queued_time);
 
   void StartReader();
   void StartWriter();
@@ -84,7 +95,7 @@ class UsbClient : public std::enable_shared_from_this<UsbClient> {
 
  private:
   BlockingQueue<std::string> incoming_message_queue_;
-  BlockingQueue<std::string> outgoing_message_queue_;
+  BlockingQueue<OutgoingMessage> outgoing_message_queue_;
 
   base::WorkThreadExecutor work_thread_;
   base::WorkThreadExecutor read_thread_;
@@ -93,6 +104,7 @@ class UsbClient : public std::enable_shared_from_this<UsbClient> {
   std::shared_ptr<UsbClientListener> listener_;
   USBConnectStatus connect_status_ = USBConnectStatus::DISCONNECTED;
   std::unique_ptr<CountDownLatch> latch_;
+  std::shared_ptr<base::TransportStats> transport_stats_;
 
   base::SocketGuard socket_guard_;
   // mutex for close socket_fd_
@@ -5,6 +5,7 @@
 #include "debug_router/native/thread/debug_router_executor.h"
 
 #include <iostream>
+#include <utility>
 
 namespace debugrouter {
 namespace thread {
@@ -18,13 +19,15 @@ DebugRouterExecutor &DebugRouterExecutor::GetInstance() {
 }
 
 void DebugRouterExecutor::Start() {
+  // joining a running looper would never return.
+  if (is_running_) {
+    return;
+  }
   if (thread_.joinable()) {
     thread_.join();
   }
-  if (!is_running_) {
-    is_running_ = true;
-    thread_ = std::thread([=]() { looper_->Run(); });
-  }
+  is_running_ = true;
+  thread_ = std::thread([=]() { looper_->Run(); });
 }
 
 void DebugRouterExecutor::Quit() {
@@ -43,10 +46,16 @@ void DebugRouterExecutor::Post(std::function<void()> work, bool run_now) {
   looper_->Post(work);
 }
 
+void DebugRouterExecutor::PostDelayed(std::function<void()> work,
+                                      std::chrono::milliseconds delay) {
+  looper_->PostDelayed(std::move(work), delay);
+}
+
 ThreadLooper::ThreadLooper()
     : keep_running_(true),
       working_queue_(std::make_shared<std::queue<std::function<void()>>>()),
-      incoming_queue_(std::make_shared<std::queue<std::function<void()>>>()) {}
+      incoming_queue_(std::make_shared<std::queue<std::function<void()>>>()),
+      delayed_sequence_(0) {}
 
 void ThreadLooper::Run() {
   while (keep_running_) {
@@ -54,26 +63,62 @@ void ThreadLooper::Run() {
       auto work = working_queue_->front();
       working_queue_->pop();
       work();
-    } else if (!incoming_queue_->empty()) {
-      std::lock_guard<std::mutex> lock(incoming_queue_lock_);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(incoming_queue_lock_);
+    std::chrono::steady_clock::time_point next = TakeDelayedWorks();
+    if (!working_queue_->empty()) {
+      continue;
+    }
+    if (!incoming_queue_->empty()) {
       working_queue_.swap(incoming_queue_);
+      continue;
+    }
+    // wakes up for new works, an earlier delayed work or Stop(), and once
+    // |next| is due.
+    auto ready = [this, next]() {
+      return !keep_running_ || !incoming_queue_->empty() ||
+             NextDelayedTime() < next;
+    };
+    if (next == std::chrono::steady_clock::time_point::max()) {
+      condition_.wait(lock, ready);
     } else {
-      std::unique_lock<std::mutex> lock(condition_lock_);
-      condition_.wait(lock);
+      condition_.wait_until(lock, next, ready);
     }
   }
 }
 
+std::chrono::steady_clock::time_point ThreadLooper::TakeDelayedWorks() {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  while (!delayed_queue_.empty() && delayed_queue_.top().time <= now) {
+    working_queue_->push(delayed_queue_.top().work);
+    delayed_queue_.pop();
+  }
+  return NextDelayedTime();
+}
+
+std::chrono::steady_clock::time_point ThreadLooper::NextDelayedTime() const {
+  return delayed_queue_.empty() ? std::chrono::steady_clock::time_point::max()
+                                : delayed_queue_.top().time;
+}
+
 void ThreadLooper::Stop() {
+  std::lock_guard<std::mutex> lock(incoming_queue_lock_);
   keep_running_ = false;
   condition_.notify_one();
 }
 
 void ThreadLooper::Post(std::function<void()> work) {
-  {
-    std::lock_guard<std::mutex> lock(incoming_queue_lock_);
-    incoming_queue_->push(work);
-  }
+  std::lock_guard<std::mutex> lock(incoming_queue_lock_);
+  incoming_queue_->push(work);
+  condition_.notify_one();
+}
+
+void ThreadLooper::PostDelayed(std::function<void()> work,
+                               std::chrono::milliseconds delay) {
+  std::lock_guard<std::mutex> lock(incoming_queue_lock_);
+  delayed_queue_.push(DelayedWork{std::chrono::steady_clock::now() + delay,
+                                  delayed_sequence_++, std::move(work)});
   condition_.notify_one();
 }
 
@@ -5,10 +5,15 @@
 #ifndef DEBUGROUTER_NATIVE_THREAD_DEBUG_ROUTER_EXECUTOR_H_
 #define DEBUGROUTER_NATIVE_THREAD_DEBUG_ROUTER_EXECUTOR_H_
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "debug_router/native/base/no_destructor.h"
 
@@ -27,6 +32,9 @@ class DebugRouterExecutor {
   void Start();
   void Quit();
   void Post(std::function<void()> work, bool run_now = true);
+  // Runs |work| on the executor once |delay| has elapsed.
+  void PostDelayed(std::function<void()> work,
+                   std::chrono::milliseconds delay);
 
  private:
   DebugRouterExecutor();
@@ -42,16 +50,41 @@ class ThreadLooper {
   explicit ThreadLooper();
   ~ThreadLooper() = default;
   void Post(std::function<void()> work);
+  void PostDelayed(std::function<void()> work,
+                   std::chrono::milliseconds delay);
   void Run();
   void Stop();
 
  private:
+  struct DelayedWork {
+    std::chrono::steady_clock::time_point time;
+    // keeps works posted for the same time in posting order.
+    uint64_t sequence;
+    std::function<void()> work;
+
+    bool operator>(const DelayedWork &other) const {
+      return time != other.time ? time > other.time
+                                : sequence > other.sequence;
+    }
+  };
+
+  // Moves the due delayed works to |working_queue_|, returns the time the
+  // next one is due, or time_point::max() if there is none. Both require
+  // |incoming_queue_lock_|.
+  std::chrono::steady_clock::time_point TakeDelayedWorks();
+  std::chrono::steady_clock::time_point NextDelayedTime() const;
+
   volatile bool keep_running_;
   std::shared_ptr<std::queue<std::function<void()>>> working_queue_;
   std::shared_ptr<std::queue<std::function<void()>>> incoming_queue_;
+  // guards |incoming_queue_|, |delayed_queue_| and the wake up conditions of
+  // |condition_|.
   std::mutex incoming_queue_lock_;
-  std::condition_variable_any condition_;
-  std::mutex condition_lock_;
+  std::priority_queue<DelayedWork, std::vector<DelayedWork>,
+                      std::greater<DelayedWork>>
+      delayed_queue_;
+  uint64_t delayed_sequence_;
+  std::condition_variable condition_;
 };
 
 }  // namespace thread
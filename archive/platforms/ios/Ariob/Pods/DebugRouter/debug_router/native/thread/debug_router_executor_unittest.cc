@@ -0,0 +1,122 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/thread/debug_router_executor.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace thread {
+
+namespace {
+
+// Runs a looper on its own thread for the duration of a test.
+class RunningLooper {
+ public:
+  RunningLooper() : thread_([this]() { looper_.Run(); }) {}
+  ~RunningLooper() {
+    looper_.Stop();
+    thread_.join();
+  }
+  ThreadLooper &looper() { return looper_; }
+
+ private:
+  ThreadLooper looper_;
+  std::thread thread_;
+};
+
+}  // namespace
+
+TEST(ThreadLooperTest, RunsWorksInPostingOrder) {
+  std::vector<int> order;
+  std::promise<void> done;
+  {
+    RunningLooper running;
+    for (int i = 0; i < 100; ++i) {
+      running.looper().Post([&order, i]() { order.push_back(i); });
+    }
+    running.looper().Post([&done]() { done.set_value(); });
+    done.get_future().wait();
+  }
+  ASSERT_EQ(order.size(), 100u);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(ThreadLooperTest, RunsDelayedWorksWhenDue) {
+  RunningLooper running;
+  std::vector<int> order;
+  std::promise<void> done;
+  auto start = std::chrono::steady_clock::now();
+  running.looper().PostDelayed([&order]() { order.push_back(2); },
+                               std::chrono::milliseconds(60));
+  running.looper().PostDelayed(
+      [&order, &done]() {
+        order.push_back(3);
+        done.set_value();
+      },
+      std::chrono::milliseconds(60));
+  // posted later with an earlier deadline, the looper must not keep waiting
+  // for the first one.
+  running.looper().PostDelayed([&order]() { order.push_back(1); },
+                               std::chrono::milliseconds(20));
+  running.looper().Post([&order]() { order.push_back(0); });
+  done.get_future().wait();
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(60));
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(ThreadLooperTest, PostsFromManyThreads) {
+  const int kThreads = 4;
+  const int kWorks = 1000;
+  int count = 0;
+  std::promise<void> done;
+  RunningLooper running;
+  std::vector<std::thread> posters;
+  for (int t = 0; t < kThreads; ++t) {
+    posters.emplace_back([&]() {
+      for (int i = 0; i < kWorks; ++i) {
+        running.looper().Post([&]() {
+          if (++count == kThreads * kWorks) {
+            done.set_value();
+          }
+        });
+      }
+    });
+  }
+  for (std::thread &poster : posters) {
+    poster.join();
+  }
+  EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+}
+
+TEST(ThreadLooperTest, StopWakesAnIdleLooper) {
+  ThreadLooper looper;
+  std::thread thread([&looper]() { looper.Run(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  looper.Stop();
+  thread.join();
+}
+
+TEST(ThreadLooperTest, StopWakesALooperWaitingForDelayedWork) {
+  ThreadLooper looper;
+  bool ran = false;
+  looper.PostDelayed([&ran]() { ran = true; }, std::chrono::hours(1));
+  std::thread thread([&looper]() { looper.Run(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  looper.Stop();
+  thread.join();
+  EXPECT_FALSE(ran);
+}
+
+}  // namespace thread
+}  // namespace debugrouter
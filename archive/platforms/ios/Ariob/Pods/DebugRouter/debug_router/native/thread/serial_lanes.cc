@@ -0,0 +1,88 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/thread/serial_lanes.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace debugrouter {
+namespace thread {
+
+SerialLanes::SerialLanes(size_t worker_count)
+    : worker_count_(std::max<size_t>(worker_count, 1)) {}
+
+SerialLanes::~SerialLanes() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t SerialLanes::DefaultWorkerCount() {
+  size_t cores = std::thread::hardware_concurrency();
+  return std::min<size_t>(std::max<size_t>(cores, 2), 4);
+}
+
+void SerialLanes::Post(int64_t lane, std::function<void()> work) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+      return;
+    }
+    if (workers_.empty()) {
+      for (size_t i = 0; i < worker_count_; ++i) {
+        workers_.emplace_back([this]() { Run(); });
+      }
+    }
+    Lane &target = lanes_[lane];
+    target.works.push_back(std::move(work));
+    if (target.scheduled) {
+      return;
+    }
+    target.scheduled = true;
+    ready_.push_back(lane);
+  }
+  condition_.notify_one();
+}
+
+void SerialLanes::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    condition_.wait(lock, [this]() { return stopped_ || !ready_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    int64_t id = ready_.front();
+    ready_.pop_front();
+    // only the worker holding a lane removes it, so |lane| stays valid
+    // while the lock is released.
+    Lane &lane = lanes_[id];
+    for (size_t i = 0; i < kLaneBatch && !lane.works.empty(); ++i) {
+      std::function<void()> work = std::move(lane.works.front());
+      lane.works.pop_front();
+      lock.unlock();
+      work();
+      // whatever |work| holds is released out of the lock too.
+      work = nullptr;
+      lock.lock();
+      if (stopped_) {
+        return;
+      }
+    }
+    if (lane.works.empty()) {
+      lanes_.erase(id);
+    } else {
+      ready_.push_back(id);
+      condition_.notify_one();
+    }
+  }
+}
+
+}  // namespace thread
+}  // namespace debugrouter
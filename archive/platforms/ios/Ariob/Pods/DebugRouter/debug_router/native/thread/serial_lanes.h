@@ -0,0 +1,68 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef DEBUGROUTER_NATIVE_THREAD_SERIAL_LANES_H_
+#define DEBUGROUTER_NATIVE_THREAD_SERIAL_LANES_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace debugrouter {
+namespace thread {
+
+// works a lane runs before giving its worker to the next ready lane.
+constexpr size_t kLaneBatch = 8;
+
+/*
+ * Runs the works posted to a lane one at a time in posting order, and works
+ * of different lanes in parallel on a small shared pool of workers. Inbound
+ * messages get a lane per session, so a slot slow to handle a message holds
+ * up its own session only.
+ *
+ * A lane waits in the ready queue while it has works and no worker, so an
+ * idle lane costs nothing and is forgotten. Workers are started on the first
+ * post.
+ */
+class SerialLanes {
+ public:
+  explicit SerialLanes(size_t worker_count);
+  ~SerialLanes();
+  SerialLanes(const SerialLanes &) = delete;
+  SerialLanes &operator=(const SerialLanes &) = delete;
+
+  void Post(int64_t lane, std::function<void()> work);
+
+  // Between 2 and 4 workers: even with one core, a second worker keeps a
+  // blocked session from stalling the others.
+  static size_t DefaultWorkerCount();
+
+ private:
+  struct Lane {
+    std::deque<std::function<void()>> works;
+    bool scheduled = false;
+  };
+
+  void Run();
+
+  const size_t worker_count_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  // guarded by |mutex_|.
+  std::unordered_map<int64_t, Lane> lanes_;
+  std::deque<int64_t> ready_;
+  std::vector<std::thread> workers_;
+  bool stopped_ = false;
+};
+
+}  // namespace thread
+}  // namespace debugrouter
+
+#endif  // DEBUGROUTER_NATIVE_THREAD_SERIAL_LANES_H_
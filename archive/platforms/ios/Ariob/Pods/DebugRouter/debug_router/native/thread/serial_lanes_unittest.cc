@@ -0,0 +1,158 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "debug_router/native/thread/serial_lanes.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace debugrouter {
+namespace thread {
+
+namespace {
+
+// Counts finished works, and wakes whoever waits for a number of them.
+class Countdown {
+ public:
+  explicit Countdown(int count) : count_(count) {}
+
+  void Done() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--count_ == 0) {
+      condition_.notify_all();
+    }
+  }
+
+  bool Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, std::chrono::seconds(5),
+                               [this]() { return count_ <= 0; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  int count_;
+};
+
+}  // namespace
+
+TEST(SerialLanesTest, RunsTheWorksOfALaneInPostingOrder) {
+  const int kLanes = 4;
+  const int kWorks = 500;
+  std::vector<std::vector<int>> orders(kLanes);
+  Countdown done(kLanes * kWorks);
+  SerialLanes lanes(3);
+  for (int i = 0; i < kWorks; ++i) {
+    for (int lane = 0; lane < kLanes; ++lane) {
+      // works of a lane never overlap, so its vector needs no lock.
+      lanes.Post(lane, [&orders, &done, lane, i]() {
+        orders[lane].push_back(i);
+        done.Done();
+      });
+    }
+  }
+  ASSERT_TRUE(done.Wait());
+  for (int lane = 0; lane < kLanes; ++lane) {
+    ASSERT_EQ(orders[lane].size(), static_cast<size_t>(kWorks));
+    for (int i = 0; i < kWorks; ++i) {
+      EXPECT_EQ(orders[lane][i], i) << "lane " << lane;
+    }
+  }
+}
+
+TEST(SerialLanesTest, NeverRunsTwoWorksOfALaneAtOnce) {
+  const int kWorks = 200;
+  std::atomic<int> running(0);
+  std::atomic<bool> overlapped(false);
+  Countdown done(kWorks);
+  SerialLanes lanes(4);
+  for (int i = 0; i < kWorks; ++i) {
+    lanes.Post(7, [&]() {
+      if (running.fetch_add(1) != 0) {
+        overlapped = true;
+      }
+      std::this_thread::yield();
+      running.fetch_sub(1);
+      done.Done();
+    });
+  }
+  ASSERT_TRUE(done.Wait());
+  EXPECT_FALSE(overlapped);
+}
+
+TEST(SerialLanesTest, ASlowLaneDoesNotHoldUpTheOthers) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> other_ran;
+  SerialLanes lanes(2);
+  lanes.Post(1, [released]() { released.wait(); });
+  lanes.Post(1, []() {});
+  lanes.Post(2, [&other_ran]() { other_ran.set_value(); });
+  EXPECT_EQ(other_ran.get_future().wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  release.set_value();
+}
+
+TEST(SerialLanesTest, BusyLaneGivesWayAfterABatch) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::vector<int> order;
+  Countdown done(2 * static_cast<int>(kLaneBatch) + 1);
+  // one worker, held until every work is queued.
+  SerialLanes lanes(1);
+  lanes.Post(0, [released]() { released.wait(); });
+  for (size_t i = 0; i < 2 * kLaneBatch; ++i) {
+    lanes.Post(1, [&order, &done]() {
+      order.push_back(1);
+      done.Done();
+    });
+  }
+  lanes.Post(2, [&order, &done]() {
+    order.push_back(2);
+    done.Done();
+  });
+  release.set_value();
+  ASSERT_TRUE(done.Wait());
+
+  std::vector<int> expected(kLaneBatch, 1);
+  expected.push_back(2);
+  expected.insert(expected.end(), kLaneBatch, 1);
+  EXPECT_EQ(order, expected);
+}
+
+TEST(SerialLanesTest, DestroyingDropsQueuedWorks) {
+  const int kQueued = 50;
+  std::promise<void> started;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> ran(0);
+  std::unique_ptr<SerialLanes> lanes(new SerialLanes(1));
+  lanes->Post(1, [&started, released]() {
+    started.set_value();
+    released.wait();
+  });
+  for (int i = 0; i < kQueued; ++i) {
+    lanes->Post(i % 3, [&ran]() { ++ran; });
+  }
+  started.get_future().wait();
+
+  // the destructor waits for the running work, then stops the worker.
+  std::thread destroyer([&lanes]() { lanes.reset(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  release.set_value();
+  destroyer.join();
+  EXPECT_EQ(ran.load(), 0);
+}
+
+}  // namespace thread
+}  // namespace debugrouter
@@ -19,6 +19,13 @@
 /// as Value container.
 //#  define JSON_USE_CPPTL_SMALLMAP 1
 
+// Strings of at least this many bytes are stored in a reference counted
+// buffer, so that copies of a Value share them instead of duplicating them.
+// See Json::SharedString.
+#ifndef JSON_SHARED_STRING_MIN_LENGTH
+#define JSON_SHARED_STRING_MIN_LENGTH 1024
+#endif
+
 // If non-zero, the library uses exceptions to report bad input instead of C
 // assertion macros. The default is to use exceptions.
 #ifndef JSON_USE_EXCEPTION
@@ -0,0 +1,112 @@
+// Copyright 2007-2010 Baptiste Lepilleur
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef CPPTL_JSON_SCAN_H_INCLUDED
+#define CPPTL_JSON_SCAN_H_INCLUDED
+
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JSONCPP_USE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define JSONCPP_USE_NEON 1
+#endif
+
+/* Vectorized scanning of json text, shared by Reader and by code that walks
+ * json without building a Value, such as the DebugRouter envelope scanner.
+ */
+
+namespace Json {
+
+inline bool isJsonSpace(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+#if defined(JSONCPP_USE_NEON)
+/// Packs a byte mask into 4 bits per byte, lowest address first.
+inline uint64_t neonMovemask(uint8x16_t matches) {
+  uint8x8_t packed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(packed), 0);
+}
+#endif
+
+/** Returns the first character in [current, end) that is not a json blank.
+ *
+ * Compact input has at most one blank between tokens, so the first character
+ * is checked on its own and only indentation runs are scanned 16 bytes at a
+ * time.
+ */
+inline const char* skipWhitespace(const char* current, const char* end) {
+  while (current != end) {
+    if (!isJsonSpace(*current))
+      return current;
+    ++current;
+#if defined(JSONCPP_USE_SSE2)
+    if (end - current >= 16) {
+      __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+      __m128i spaces = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')),
+                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+      unsigned others =
+          ~static_cast<unsigned>(_mm_movemask_epi8(spaces)) & 0xFFFFu;
+      if (others)
+        return current + __builtin_ctz(others);
+      current += 16;
+    }
+#elif defined(JSONCPP_USE_NEON)
+    if (end - current >= 16) {
+      uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(current));
+      uint8x16_t spaces = vorrq_u8(
+          vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')),
+                   vceqq_u8(chunk, vdupq_n_u8('\t'))),
+          vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\r')),
+                   vceqq_u8(chunk, vdupq_n_u8('\n'))));
+      uint64_t others = ~neonMovemask(spaces);
+      if (others)
+        return current + (__builtin_ctzll(others) >> 2);
+      current += 16;
+    }
+#endif
+  }
+  return current;
+}
+
+/// Returns the first \c quote or backslash in [current, end), or \c end.
+inline const char* findQuoteOrEscape(const char* current, const char* end,
+                                     char quote) {
+#if defined(JSONCPP_USE_SSE2)
+  const __m128i quotes = _mm_set1_epi8(quote);
+  const __m128i escapes = _mm_set1_epi8('\\');
+  for (; end - current >= 16; current += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+    unsigned matches = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, escapes))));
+    if (matches)
+      return current + __builtin_ctz(matches);
+  }
+#elif defined(JSONCPP_USE_NEON)
+  const uint8x16_t quotes = vdupq_n_u8(static_cast<uint8_t>(quote));
+  const uint8x16_t escapes = vdupq_n_u8('\\');
+  for (; end - current >= 16; current += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(current));
+    uint64_t matches = neonMovemask(
+        vorrq_u8(vceqq_u8(chunk, quotes), vceqq_u8(chunk, escapes)));
+    if (matches)
+      return current + (__builtin_ctzll(matches) >> 2);
+  }
+#endif
+  while (current != end && *current != quote && *current != '\\')
+    ++current;
+  return current;
+}
+
+} // namespace Json
+
+#endif // CPPTL_JSON_SCAN_H_INCLUDED
@@ -70,6 +70,22 @@ public:
  */
 JSONCPP_STRING JSON_API writeString(StreamWriter::Factory const& factory, Value const& root);
 
+/** \brief Append the compact form of \c root to \c out.
+ *
+ * Writes the same bytes as FastWriter with omitEndingLineFeed(), without a
+ * writer object or intermediate strings. Keep \c out around and clear() it
+ * between messages to reuse its capacity.
+ */
+void JSON_API writeCompact(Value const& root, JSONCPP_STRING& out);
+
+/** \brief Compact form of \c root, same bytes as writeCompact().
+ *
+ * The result is reserved from the size of the previous message written on
+ * the calling thread, so messages of a steady size are written without
+ * regrowing the string.
+ */
+JSONCPP_STRING JSON_API toCompactString(Value const& root);
+
 
 /** \brief Build a StreamWriter implementation.
 
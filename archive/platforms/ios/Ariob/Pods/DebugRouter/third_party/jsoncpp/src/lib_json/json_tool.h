@@ -15,6 +15,9 @@
 #ifndef JSONCPP_NO_LOCALE_SUPPORT
 #include <clocale>
 #endif
+#include <cfloat>
+
+#include <json/scan.h>
 
 /* This header provides common string manipulation support, such as UTF-8,
  * portable conversion from/to string...
@@ -83,11 +86,27 @@ typedef char UIntToStringBuffer[uintToStringBufferSize];
  *        Must have at least uintToStringBufferSize chars free.
  */
 static inline void uintToString(LargestUInt value, char*& current) {
+  static const char digitPairs[] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
   *--current = 0;
-  do {
-    *--current = static_cast<char>(value % 10U + static_cast<unsigned>('0'));
-    value /= 10;
-  } while (value != 0);
+  // two digits per division.
+  while (value >= 100) {
+    unsigned pair = static_cast<unsigned>(value % 100U) * 2;
+    value /= 100;
+    *--current = digitPairs[pair + 1];
+    *--current = digitPairs[pair];
+  }
+  if (value >= 10) {
+    unsigned pair = static_cast<unsigned>(value) * 2;
+    *--current = digitPairs[pair + 1];
+    *--current = digitPairs[pair];
+  } else {
+    *--current = static_cast<char>(value + static_cast<unsigned>('0'));
+  }
 }
 
 /** Change ',' to '.' everywhere in buffer.
@@ -104,6 +123,83 @@ static inline void fixNumericLocale(char* begin, char* end) {
   }
 }
 
+/** Converts a json number without calling into the C library.
+ *
+ * Only handles [-]int[.frac][(e|E)[+-]exp] with at most 2^53 as significand
+ * and a decimal exponent within +/-22, where a single multiplication or
+ * division by an exact power of ten gives the correctly rounded result
+ * (Clinger's fast path). Returns false otherwise, the caller then falls back
+ * to the locale aware conversion.
+ */
+static inline bool decodeDoubleFastPath(const char* begin, const char* end,
+                                        double& value) {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+  // extended precision intermediates would round twice.
+  return false;
+#else
+  static const double powersOf10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const uint64_t maxExactSignificand = 1ULL << 53;
+  const char* current = begin;
+  bool isNegative = current != end && *current == '-';
+  if (isNegative)
+    ++current;
+
+  uint64_t significand = 0;
+  int exponent = 0;
+  const char* digitsBegin = current;
+  while (current != end && *current >= '0' && *current <= '9') {
+    significand = significand * 10 + static_cast<unsigned>(*current++ - '0');
+    if (significand > maxExactSignificand)
+      return false;
+  }
+  if (current == digitsBegin)
+    return false;
+  if (current != end && *current == '.') {
+    digitsBegin = ++current;
+    while (current != end && *current >= '0' && *current <= '9') {
+      significand = significand * 10 + static_cast<unsigned>(*current++ - '0');
+      if (significand > maxExactSignificand)
+        return false;
+      --exponent;
+    }
+    if (current == digitsBegin)
+      return false;
+  }
+  if (current != end && (*current == 'e' || *current == 'E')) {
+    ++current;
+    bool isNegativeExponent = current != end && *current == '-';
+    if (current != end && (*current == '-' || *current == '+'))
+      ++current;
+    digitsBegin = current;
+    int explicitExponent = 0;
+    while (current != end && *current >= '0' && *current <= '9') {
+      explicitExponent = explicitExponent * 10 + (*current++ - '0');
+      if (explicitExponent > 1000)
+        return false;
+    }
+    if (current == digitsBegin)
+      return false;
+    exponent += isNegativeExponent ? -explicitExponent : explicitExponent;
+  }
+  if (current != end)
+    return false;
+
+  double result = static_cast<double>(significand);
+  if (significand != 0) {
+    if (exponent < -22 || exponent > 22)
+      return false;
+    if (exponent < 0)
+      result /= powersOf10[-exponent];
+    else
+      result *= powersOf10[exponent];
+  }
+  value = isNegative ? -result : result;
+  return true;
+#endif
+}
+
 static inline void fixNumericLocaleInput(char* begin, char* end) {
   char decimalPoint = getDecimalPoint();
   if (decimalPoint != '\0' && decimalPoint != '.') {
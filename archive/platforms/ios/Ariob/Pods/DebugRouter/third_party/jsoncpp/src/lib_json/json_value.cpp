@@ -17,7 +17,10 @@
 #include <cpptl/conststring.h>
 #endif
 #include <cstddef> // size_t
+#include <new>
 #include <algorithm> // min()
+#include <atomic>
+#include <mutex>
 
 #define JSON_ASSERT_UNREACHABLE assert(false)
 
@@ -174,6 +177,51 @@ static inline void releaseStringValue(char* value, unsigned) {
 }
 #endif // JSONCPP_USING_SECURE_MEMORY
 
+/* A shared string is a prefixed string preceded by its reference count. */
+typedef std::atomic<unsigned> SharedStringRefs;
+
+static inline SharedStringRefs& sharedStringRefs(char* value) {
+  return *reinterpret_cast<SharedStringRefs*>(value - sizeof(SharedStringRefs));
+}
+
+static inline char* newSharedStringValue(const char* value, unsigned length) {
+  JSON_ASSERT_MESSAGE(length <= static_cast<unsigned>(Value::maxInt) -
+                                    sizeof(SharedStringRefs) -
+                                    sizeof(unsigned) - 1U,
+                      "in Json::Value::newSharedStringValue(): "
+                      "length too big for prefixing");
+  size_t const size =
+      sizeof(SharedStringRefs) + sizeof(unsigned) + length + 1U;
+  char* block = static_cast<char*>(malloc(size));
+  if (block == 0) {
+    throwRuntimeError(
+        "in Json::Value::newSharedStringValue(): "
+        "Failed to allocate string value buffer");
+  }
+  new (block) SharedStringRefs(1);
+  char* newString = block + sizeof(SharedStringRefs);
+  *reinterpret_cast<unsigned*>(newString) = length;
+  memcpy(newString + sizeof(unsigned), value, length);
+  newString[sizeof(unsigned) + length] = 0;
+  return newString;
+}
+
+static inline void retainSharedStringValue(char* value) {
+  sharedStringRefs(value).fetch_add(1, std::memory_order_relaxed);
+}
+
+static inline void releaseSharedStringValue(char* value) {
+  SharedStringRefs& refs = sharedStringRefs(value);
+  if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    return;
+#if JSONCPP_USING_SECURE_MEMORY
+  memset(value, 0,
+         sizeof(unsigned) + *reinterpret_cast<unsigned*>(value) + 1U);
+#endif
+  refs.~SharedStringRefs();
+  free(value - sizeof(SharedStringRefs));
+}
+
 } // namespace Json
 
 // //////////////////////////////////////////////////////////////////
@@ -218,6 +266,51 @@ JSONCPP_NORETURN void throwLogicError(JSONCPP_STRING const& msg)
 #endif
 }
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class SharedString
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+SharedString::SharedString() : string_(0) {}
+
+SharedString::SharedString(const char* data, size_t length)
+    : string_(newSharedStringValue(data, static_cast<unsigned>(length))) {}
+
+SharedString::SharedString(const JSONCPP_STRING& value)
+    : string_(newSharedStringValue(value.data(),
+                                   static_cast<unsigned>(value.length()))) {}
+
+SharedString::SharedString(const SharedString& other)
+    : string_(other.string_) {
+  if (string_)
+    retainSharedStringValue(string_);
+}
+
+SharedString& SharedString::operator=(SharedString other) {
+  swap(other);
+  return *this;
+}
+
+SharedString::~SharedString() {
+  if (string_)
+    releaseSharedStringValue(string_);
+}
+
+const char* SharedString::data() const {
+  return string_ ? string_ + sizeof(unsigned) : "";
+}
+
+size_t SharedString::length() const {
+  return string_ ? *reinterpret_cast<unsigned const*>(string_) : 0;
+}
+
+void SharedString::swap(SharedString& other) {
+  std::swap(string_, other.string_);
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -334,6 +427,75 @@ const char* Value::CZString::data() const { return cstr_; }
 unsigned Value::CZString::length() const { return storage_.length_; }
 bool Value::CZString::isStaticString() const { return storage_.policy_ == noDuplication; }
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// Interned member names
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+static inline unsigned hashMemberName(const char* data, unsigned length) {
+  // 32 bits FNV-1a.
+  unsigned hash = 2166136261u;
+  for (unsigned i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Open addressing table of the names registered with Value::internKey().
+// Names are only ever added, a slot is published by storing its name last,
+// so lookups take no lock and registrations are serialized by a mutex.
+static const unsigned kInternedKeyCapacity = 256;
+static const unsigned kInternedKeyLimit = kInternedKeyCapacity / 4 * 3;
+static std::atomic<const char*> internedKeyNames[kInternedKeyCapacity];
+static unsigned internedKeyLengths[kInternedKeyCapacity];
+static unsigned internedKeyCount = 0;
+
+static std::mutex& internedKeyMutex() {
+  static std::mutex* mutex = new std::mutex;
+  return *mutex;
+}
+
+/// Returns the registered copy of [key, key + length), or 0 if the name was
+/// never interned.
+static const char* findInternedKey(const char* key, unsigned length) {
+  const unsigned mask = kInternedKeyCapacity - 1;
+  for (unsigned slot = hashMemberName(key, length) & mask;;
+       slot = (slot + 1) & mask) {
+    const char* name = internedKeyNames[slot].load(std::memory_order_acquire);
+    if (!name)
+      return 0;
+    if (internedKeyLengths[slot] == length &&
+        memcmp(name, key, length) == 0)
+      return name;
+  }
+}
+
+bool Value::internKey(const StaticString& key) {
+  const char* name = key.c_str();
+  const unsigned length = static_cast<unsigned>(strlen(name));
+  const unsigned mask = kInternedKeyCapacity - 1;
+  std::lock_guard<std::mutex> lock(internedKeyMutex());
+  unsigned slot = hashMemberName(name, length) & mask;
+  for (;; slot = (slot + 1) & mask) {
+    const char* current = internedKeyNames[slot].load(std::memory_order_relaxed);
+    if (!current)
+      break;
+    if (internedKeyLengths[slot] == length &&
+        memcmp(current, name, length) == 0)
+      return true;
+  }
+  if (internedKeyCount >= kInternedKeyLimit)
+    return false;
+  ++internedKeyCount;
+  internedKeyLengths[slot] = length;
+  internedKeyNames[slot].store(name, std::memory_order_release);
+  return true;
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -401,21 +563,27 @@ Value::Value(double value) {
 }
 
 Value::Value(const char* value) {
-  initBasic(stringValue, true);
   JSON_ASSERT_MESSAGE(value != NULL, "Null Value Passed to Value Constructor");	
-  value_.string_ = duplicateAndPrefixStringValue(value, static_cast<unsigned>(strlen(value)));
+  initString(value, static_cast<unsigned>(strlen(value)));
 }
 
 Value::Value(const char* beginValue, const char* endValue) {
-  initBasic(stringValue, true);
-  value_.string_ =
-      duplicateAndPrefixStringValue(beginValue, static_cast<unsigned>(endValue - beginValue));
+  initString(beginValue, static_cast<unsigned>(endValue - beginValue));
 }
 
 Value::Value(const JSONCPP_STRING& value) {
+  initString(value.data(), static_cast<unsigned>(value.length()));
+}
+
+Value::Value(const SharedString& value) {
+  if (!value.string_) {
+    initString("", 0);
+    return;
+  }
   initBasic(stringValue, true);
-  value_.string_ =
-      duplicateAndPrefixStringValue(value.data(), static_cast<unsigned>(value.length()));
+  shared_ = true;
+  retainSharedStringValue(value.string_);
+  value_.string_ = value.string_;
 }
 
 Value::Value(const StaticString& value) {
@@ -436,7 +604,7 @@ Value::Value(bool value) {
 }
 
 Value::Value(Value const& other)
-    : type_(other.type_), allocated_(false)
+    : type_(other.type_), allocated_(false), shared_(false)
       ,
       comments_(0), start_(other.start_), limit_(other.limit_)
 {
@@ -449,7 +617,12 @@ Value::Value(Value const& other)
     value_ = other.value_;
     break;
   case stringValue:
-    if (other.value_.string_ && other.allocated_) {
+    if (other.shared_) {
+      retainSharedStringValue(other.value_.string_);
+      value_.string_ = other.value_.string_;
+      allocated_ = true;
+      shared_ = true;
+    } else if (other.value_.string_ && other.allocated_) {
       unsigned len;
       char const* str;
       decodePrefixedString(other.allocated_, other.value_.string_,
@@ -496,7 +669,9 @@ Value::~Value() {
   case booleanValue:
     break;
   case stringValue:
-    if (allocated_)
+    if (shared_)
+      releaseSharedStringValue(value_.string_);
+    else if (allocated_)
       releasePrefixedStringValue(value_.string_);
     break;
   case arrayValue:
@@ -525,6 +700,9 @@ void Value::swapPayload(Value& other) {
   int temp2 = allocated_;
   allocated_ = other.allocated_;
   other.allocated_ = temp2 & 0x1;
+  int temp3 = shared_;
+  shared_ = other.shared_;
+  other.shared_ = temp3 & 0x1;
 }
 
 void Value::swap(Value& other) {
@@ -700,6 +878,20 @@ JSONCPP_STRING Value::asString() const {
   }
 }
 
+SharedString Value::asSharedString() const {
+  SharedString shared;
+  if (type_ == stringValue && shared_) {
+    retainSharedStringValue(value_.string_);
+    shared.string_ = value_.string_;
+    return shared;
+  }
+  char const* begin;
+  char const* end;
+  if (type_ == stringValue && getString(&begin, &end))
+    return SharedString(begin, static_cast<size_t>(end - begin));
+  return SharedString(asString());
+}
+
 #ifdef JSON_USE_CPPTL
 CppTL::ConstString Value::asConstString() const {
   unsigned len;
@@ -1025,11 +1217,19 @@ const Value& Value::operator[](int index) const {
 void Value::initBasic(ValueType vtype, bool allocated) {
   type_ = vtype;
   allocated_ = allocated;
+  shared_ = false;
   comments_ = 0;
   start_ = 0;
   limit_ = 0;
 }
 
+void Value::initString(const char* value, unsigned length) {
+  initBasic(stringValue, true);
+  shared_ = length >= JSON_SHARED_STRING_MIN_LENGTH;
+  value_.string_ = shared_ ? newSharedStringValue(value, length)
+                           : duplicateAndPrefixStringValue(value, length);
+}
+
 // Access an object value by name, create a null member if it does not exist.
 // @pre Type of '*this' is object or null.
 // @param key is null-terminated.
@@ -1059,13 +1259,18 @@ Value& Value::resolveReference(char const* key, char const* cend)
       "in Json::Value::resolveReference(key, end): requires objectValue");
   if (type_ == nullValue)
     *this = Value(objectValue);
-  CZString actualKey(
-      key, static_cast<unsigned>(cend-key), CZString::duplicateOnCopy);
+  const unsigned length = static_cast<unsigned>(cend-key);
+  CZString actualKey(key, length, CZString::duplicateOnCopy);
   ObjectValues::iterator it = value_.map_->lower_bound(actualKey);
   if (it != value_.map_->end() && (*it).first == actualKey)
     return (*it).second;
 
-  ObjectValues::value_type defaultValue(actualKey, nullSingleton());
+  // a well known name is stored without a copy, as with a StaticString.
+  const char* interned = findInternedKey(key, length);
+  ObjectValues::value_type defaultValue(
+      interned ? CZString(interned, length, CZString::noDuplication)
+               : actualKey,
+      nullSingleton());
   it = value_.map_->insert(it, defaultValue);
   Value& value = (*it).second;
   return value;
@@ -89,18 +89,8 @@ static bool containsControlCharacter(const char* str) {
   return false;
 }
 
-static bool containsControlCharacter0(const char* str, unsigned len) {
-  char const* end = str + len;
-  while (end != str) {
-    if (isControlCharacter(*str) || 0==*str)
-      return true;
-    ++str;
-  }
-  return false;
-}
-
-JSONCPP_STRING valueToString(LargestInt value) {
-  UIntToStringBuffer buffer;
+// Formats |value| at the end of |buffer|, returns the first character.
+static char* formatLargestInt(LargestInt value, UIntToStringBuffer& buffer) {
   char* current = buffer + sizeof(buffer);
   if (value == Value::minLargestInt) {
     uintToString(LargestUInt(Value::maxLargestInt) + 1, current);
@@ -115,14 +105,23 @@ JSONCPP_STRING valueToString(LargestInt value) {
   return current;
 }
 
-JSONCPP_STRING valueToString(LargestUInt value) {
-  UIntToStringBuffer buffer;
+static char* formatLargestUInt(LargestUInt value, UIntToStringBuffer& buffer) {
   char* current = buffer + sizeof(buffer);
   uintToString(value, current);
   assert(current >= buffer);
   return current;
 }
 
+JSONCPP_STRING valueToString(LargestInt value) {
+  UIntToStringBuffer buffer;
+  return formatLargestInt(value, buffer);
+}
+
+JSONCPP_STRING valueToString(LargestUInt value) {
+  UIntToStringBuffer buffer;
+  return formatLargestUInt(value, buffer);
+}
+
 #if defined(JSON_HAS_INT64)
 
 JSONCPP_STRING valueToString(Int value) {
@@ -136,21 +135,316 @@ JSONCPP_STRING valueToString(UInt value) {
 #endif // # if defined(JSON_HAS_INT64)
 
 namespace {
-JSONCPP_STRING valueToString(double value, bool useSpecialFloats, unsigned int precision) {
-  // Allocate a buffer that is more than large enough to store the 16 digits of
-  // precision requested below.
-  char buffer[36];
-  int len = -1;
+// Shortest round-trip formatting of doubles, Grisu2 from Florian Loitsch,
+// "Printing Floating-Point Numbers Quickly and Accurately with Integers".
+// The output always reads back to the same double and is the shortest such
+// representation for all but a tiny fraction of inputs.
+struct DiyFp {
+  DiyFp() : f(0), e(0) {}
+  DiyFp(uint64_t fp, int exp) : f(fp), e(exp) {}
+
+  uint64_t f;
+  int e;
+};
+
+static const uint64_t kDpSignificandMask = 0x000FFFFFFFFFFFFFULL;
+static const uint64_t kDpHiddenBit = 0x0010000000000000ULL;
+static const int kDpSignificandSize = 52;
+static const int kDpExponentBias = 0x3FF + kDpSignificandSize;
+
+static DiyFp diyFpFromDouble(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  int biasedExponent = static_cast<int>((bits >> kDpSignificandSize) & 0x7FF);
+  uint64_t significand = bits & kDpSignificandMask;
+  if (biasedExponent != 0)
+    return DiyFp(significand + kDpHiddenBit, biasedExponent - kDpExponentBias);
+  return DiyFp(significand, 1 - kDpExponentBias);
+}
+
+static DiyFp multiply(const DiyFp& x, const DiyFp& y) {
+  const uint64_t M32 = 0xFFFFFFFFULL;
+  const uint64_t a = x.f >> 32;
+  const uint64_t b = x.f & M32;
+  const uint64_t c = y.f >> 32;
+  const uint64_t d = y.f & M32;
+  const uint64_t ac = a * c;
+  const uint64_t bc = b * c;
+  const uint64_t ad = a * d;
+  const uint64_t bd = b * d;
+  uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+  tmp += 1U << 31; // round
+  return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+static DiyFp normalize(DiyFp value) {
+  while (!(value.f & (kDpHiddenBit << 11))) {
+    value.f <<= 1;
+    value.e--;
+  }
+  return value;
+}
+
+// Normalized boundaries m- and m+ of the rounding interval of |v|.
+static void normalizedBoundaries(const DiyFp& v, DiyFp* minus, DiyFp* plus) {
+  DiyFp upper((v.f << 1) + 1, v.e - 1);
+  while (!(upper.f & (kDpHiddenBit << 1))) {
+    upper.f <<= 1;
+    upper.e--;
+  }
+  upper.f <<= 64 - kDpSignificandSize - 2;
+  upper.e -= 64 - kDpSignificandSize - 2;
+  DiyFp lower = (v.f == kDpHiddenBit) ? DiyFp((v.f << 2) - 1, v.e - 2)
+                                      : DiyFp((v.f << 1) - 1, v.e - 1);
+  lower.f <<= lower.e - upper.e;
+  lower.e = upper.e;
+  *minus = lower;
+  *plus = upper;
+}
+
+// Normalized 10^k for k = -348, -340, ..., 340.
+static DiyFp cachedPower(int e, int* K) {
+  static const uint64_t kSignificands[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+  };
+  static const short kExponents[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+  };
+  // dk must be positive, so can do ceiling in positive
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int k = static_cast<int>(dk);
+  if (dk - k > 0.0)
+    k++;
+  unsigned index = static_cast<unsigned>((k >> 3) + 1);
+  *K = -(-348 + static_cast<int>(index << 3));
+  return DiyFp(kSignificands[index], kExponents[index]);
+}
 
-  char formatString[15];
-  snprintf(formatString, sizeof(formatString), "%%.%dg", precision);
+static const uint64_t kPowersOf10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+static int countDecimalDigits(uint32_t n) {
+  int count = 1;
+  while (count < 10 && n >= kPowersOf10[count])
+    ++count;
+  return count;
+}
+
+static void grisuRound(char* buffer, int length, uint64_t delta, uint64_t rest,
+                       uint64_t tenKappa, uint64_t distance) {
+  while (rest < distance && delta - rest >= tenKappa &&
+         (rest + tenKappa < distance ||
+          distance - rest > rest + tenKappa - distance)) {
+    buffer[length - 1]--;
+    rest += tenKappa;
+  }
+}
+
+static void digitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta,
+                     char* buffer, int* length, int* K) {
+  const DiyFp one(1ULL << -Mp.e, Mp.e);
+  const uint64_t distance = Mp.f - W.f;
+  uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
+  uint64_t p2 = Mp.f & (one.f - 1);
+  int kappa = countDecimalDigits(p1);
+  *length = 0;
+
+  while (kappa > 0) {
+    uint32_t divisor = static_cast<uint32_t>(kPowersOf10[kappa - 1]);
+    uint32_t digit = p1 / divisor;
+    p1 %= divisor;
+    if (digit || *length)
+      buffer[(*length)++] = static_cast<char>('0' + digit);
+    kappa--;
+    uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      *K += kappa;
+      grisuRound(buffer, *length, delta, rest, kPowersOf10[kappa] << -one.e,
+                 distance);
+      return;
+    }
+  }
+
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    char digit = static_cast<char>(p2 >> -one.e);
+    if (digit || *length)
+      buffer[(*length)++] = static_cast<char>('0' + digit);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *K += kappa;
+      int index = -kappa;
+      grisuRound(buffer, *length, delta, p2, one.f,
+                 distance * (index < 20 ? kPowersOf10[index] : 0));
+      return;
+    }
+  }
+}
+
+// Writes the digits of a positive, finite |value| to |buffer| so that
+// value == digits * 10^K.
+static void grisu2(double value, char* buffer, int* length, int* K) {
+  const DiyFp v = diyFpFromDouble(value);
+  DiyFp minus, plus;
+  normalizedBoundaries(v, &minus, &plus);
+
+  const DiyFp cached = cachedPower(plus.e, K);
+  const DiyFp W = multiply(normalize(v), cached);
+  DiyFp Wp = multiply(plus, cached);
+  DiyFp Wm = multiply(minus, cached);
+  Wm.f++;
+  Wp.f--;
+  digitGen(W, Wp, Wp.f - Wm.f, buffer, length, K);
+}
+
+// Shortest digits laid out the way "%.17g" does, so that only the number of
+// significant digits differs from the snprintf path. Returns -1 when 17
+// digits are needed.
+static int formatShortestDouble(double value, char* buffer) {
+  char* out = buffer;
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if (bits >> 63) {
+    *out++ = '-';
+    value = -value;
+  }
+  if (value == 0) {
+    *out++ = '0';
+    *out = 0;
+    return static_cast<int>(out - buffer);
+  }
+
+  char digits[32];
+  int length;
+  int K;
+  grisu2(value, digits, &length, &K);
+  while (length > 1 && digits[length - 1] == '0') {
+    --length;
+    ++K;
+  }
+  if (length >= 17) {
+    // nothing shorter exists, or Grisu2 missed it. Let snprintf pick the
+    // correctly rounded digits then.
+    return -1;
+  }
+
+  int exponent = length + K - 1;
+  if (exponent < -4 || exponent >= 17) {
+    *out++ = digits[0];
+    if (length > 1) {
+      *out++ = '.';
+      memcpy(out, digits + 1, static_cast<size_t>(length - 1));
+      out += length - 1;
+    }
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    unsigned magnitude = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+    if (magnitude >= 100) {
+      *out++ = static_cast<char>('0' + magnitude / 100);
+      magnitude %= 100;
+    }
+    *out++ = static_cast<char>('0' + magnitude / 10);
+    *out++ = static_cast<char>('0' + magnitude % 10);
+  } else if (exponent < 0) {
+    *out++ = '0';
+    *out++ = '.';
+    for (int i = -1; i > exponent; --i)
+      *out++ = '0';
+    memcpy(out, digits, static_cast<size_t>(length));
+    out += length;
+  } else if (length <= exponent + 1) {
+    memcpy(out, digits, static_cast<size_t>(length));
+    out += length;
+    for (int i = length; i <= exponent; ++i)
+      *out++ = '0';
+  } else {
+    memcpy(out, digits, static_cast<size_t>(exponent + 1));
+    out += exponent + 1;
+    *out++ = '.';
+    memcpy(out, digits + exponent + 1, static_cast<size_t>(length - exponent - 1));
+    out += length - exponent - 1;
+  }
+  *out = 0;
+  return static_cast<int>(out - buffer);
+}
+
+// |buffer| must hold at least 36 characters.
+void formatDouble(double value, bool useSpecialFloats, unsigned int precision,
+                  char* buffer) {
+  const size_t bufferSize = 36;
+  int len = -1;
 
   // Print into the buffer. We need not request the alternative representation
   // that always has a decimal point because JSON doesn't distingish the
   // concepts of reals and integers.
   if (isfinite(value)) {
-    len = snprintf(buffer, sizeof(buffer), formatString, value);
-    fixNumericLocale(buffer, buffer + len);
+    // 17 digits is the round-trip precision, shorter digits that read back to
+    // the same double carry the same information.
+    len = precision == 17 ? formatShortestDouble(value, buffer) : -1;
+    if (len < 0) {
+      char formatString[15];
+      snprintf(formatString, sizeof(formatString), "%%.%dg", precision);
+      len = snprintf(buffer, bufferSize, formatString, value);
+      fixNumericLocale(buffer, buffer + len);
+    }
 
     // try to ensure we preserve the fact that this was given to us as a double on input
     if (!strstr(buffer, ".") && !strstr(buffer, "e")) {
@@ -160,14 +454,22 @@ JSONCPP_STRING valueToString(double value, bool useSpecialFloats, unsigned int p
   } else {
     // IEEE standard states that NaN values will not compare to themselves
     if (value != value) {
-      len = snprintf(buffer, sizeof(buffer), useSpecialFloats ? "NaN" : "null");
+      len = snprintf(buffer, bufferSize, useSpecialFloats ? "NaN" : "null");
     } else if (value < 0) {
-      len = snprintf(buffer, sizeof(buffer), useSpecialFloats ? "-Infinity" : "-1e+9999");
+      len = snprintf(buffer, bufferSize, useSpecialFloats ? "-Infinity" : "-1e+9999");
     } else {
-      len = snprintf(buffer, sizeof(buffer), useSpecialFloats ? "Infinity" : "1e+9999");
+      len = snprintf(buffer, bufferSize, useSpecialFloats ? "Infinity" : "1e+9999");
     }
   }
   assert(len >= 0);
+  (void)len;
+}
+
+JSONCPP_STRING valueToString(double value, bool useSpecialFloats, unsigned int precision) {
+  // Allocate a buffer that is more than large enough to store the 16 digits of
+  // precision requested below.
+  char buffer[36];
+  formatDouble(value, useSpecialFloats, precision, buffer);
   return buffer;
 }
 }
@@ -238,81 +540,64 @@ JSONCPP_STRING valueToQuotedString(const char* value) {
   return result;
 }
 
-// https://github.com/upcaste/upcaste/blob/master/src/upcore/src/cstring/strnpbrk.cpp
-static char const* strnpbrk(char const* s, char const* accept, size_t n) {
-  assert((s || !n) && accept);
-
-  char const* const end = s + n;
-  for (char const* cur = s; cur < end; ++cur) {
-    int const c = *cur;
-    for (char const* a = accept; *a; ++a) {
-      if (*a == c) {
-        return cur;
-      }
-    }
-  }
-  return NULL;
-}
-static JSONCPP_STRING valueToQuotedStringN(const char* value, unsigned length) {
+// Appends |value| quoted and escaped, without going through a temporary.
+static void appendQuotedStringN(JSONCPP_STRING& out, const char* value,
+                                unsigned length) {
+  static const char hexDigits[] = "0123456789ABCDEF";
   if (value == NULL)
-    return "";
-  // Not sure how to handle unicode...
-  if (strnpbrk(value, "\"\\\b\f\n\r\t", length) == NULL &&
-      !containsControlCharacter0(value, length))
-    return JSONCPP_STRING("\"") + value + "\"";
-  // We have to walk value and escape any special characters.
-  // Appending to JSONCPP_STRING is not efficient, but this should be rare.
-  // (Note: forward slashes are *not* rare, but I am not escaping them.)
-  JSONCPP_STRING::size_type maxsize =
-      length * 2 + 3; // allescaped+quotes+NULL
-  JSONCPP_STRING result;
-  result.reserve(maxsize); // to avoid lots of mallocs
-  result += "\"";
+    return;
+  out += '"';
   char const* end = value + length;
+  char const* run = value;
   for (const char* c = value; c != end; ++c) {
+    const char* escaped;
     switch (*c) {
     case '\"':
-      result += "\\\"";
+      escaped = "\\\"";
       break;
     case '\\':
-      result += "\\\\";
+      escaped = "\\\\";
       break;
     case '\b':
-      result += "\\b";
+      escaped = "\\b";
       break;
     case '\f':
-      result += "\\f";
+      escaped = "\\f";
       break;
     case '\n':
-      result += "\\n";
+      escaped = "\\n";
       break;
     case '\r':
-      result += "\\r";
+      escaped = "\\r";
       break;
     case '\t':
-      result += "\\t";
+      escaped = "\\t";
       break;
-    // case '/':
-    // Even though \/ is considered a legal escape in JSON, a bare
-    // slash is also legal, so I see no reason to escape it.
-    // (I hope I am not misunderstanding something.)
-    // blep notes: actually escaping \/ may be useful in javascript to avoid </
-    // sequence.
-    // Should add a flag to allow this compatibility mode and prevent this
-    // sequence from occurring.
+    // Even though \/ is a legal escape in JSON, a bare slash is also legal,
+    // so it is not escaped.
     default:
-      if ((isControlCharacter(*c)) || (*c == 0)) {
-        JSONCPP_OSTRINGSTREAM oss;
-        oss << "\\u" << std::hex << std::uppercase << std::setfill('0')
-            << std::setw(4) << static_cast<int>(*c);
-        result += oss.str();
-      } else {
-        result += *c;
+      if (isControlCharacter(*c) || *c == 0) {
+        out.append(run, c);
+        run = c + 1;
+        char unicode[6] = {'\\', 'u', '0', '0', hexDigits[(*c >> 4) & 0xF],
+                           hexDigits[*c & 0xF]};
+        out.append(unicode, sizeof(unicode));
       }
-      break;
+      continue;
     }
+    out.append(run, c);
+    run = c + 1;
+    out += escaped;
   }
-  result += "\"";
+  out.append(run, end);
+  out += '"';
+}
+
+static JSONCPP_STRING valueToQuotedStringN(const char* value, unsigned length) {
+  JSONCPP_STRING result;
+  // quotes plus a few escapes.
+  result.reserve(length + 8);
+  appendQuotedStringN(result, value, length);
   return result;
 }
 
@@ -395,6 +680,79 @@ void FastWriter::writeValue(const Value& value) {
   }
 }
 
+// writeCompact
+// //////////////////////////////////////////////////////////////////
+
+static void writeCompactValue(const Value& value, JSONCPP_STRING& out) {
+  switch (value.type()) {
+  case nullValue:
+    out += "null";
+    break;
+  case intValue: {
+    UIntToStringBuffer buffer;
+    out += formatLargestInt(value.asLargestInt(), buffer);
+  } break;
+  case uintValue: {
+    UIntToStringBuffer buffer;
+    out += formatLargestUInt(value.asLargestUInt(), buffer);
+  } break;
+  case realValue: {
+    char buffer[36];
+    formatDouble(value.asDouble(), false, 17, buffer);
+    out += buffer;
+  } break;
+  case stringValue: {
+    char const* str;
+    char const* end;
+    if (value.getString(&str, &end))
+      appendQuotedStringN(out, str, static_cast<unsigned>(end - str));
+  } break;
+  case booleanValue:
+    out += value.asBool() ? "true" : "false";
+    break;
+  case arrayValue: {
+    out += '[';
+    ArrayIndex size = value.size();
+    for (ArrayIndex index = 0; index < size; ++index) {
+      if (index > 0)
+        out += ',';
+      writeCompactValue(value[index], out);
+    }
+    out += ']';
+  } break;
+  case objectValue: {
+    // iterate in place instead of copying getMemberNames(), same order.
+    out += '{';
+    for (Value::const_iterator it = value.begin(); it != value.end(); ++it) {
+      if (it != value.begin())
+        out += ',';
+      char const* nameEnd;
+      char const* name = it.memberName(&nameEnd);
+      appendQuotedStringN(out, name, static_cast<unsigned>(nameEnd - name));
+      out += ':';
+      writeCompactValue(*it, out);
+    }
+    out += '}';
+  } break;
+  }
+}
+
+void writeCompact(Value const& root, JSONCPP_STRING& out) {
+  writeCompactValue(root, out);
+}
+
+JSONCPP_STRING toCompactString(Value const& root) {
+  // Sized from the previous message written on this thread. The hint is
+  // capped so one large message does not inflate every later small one.
+  static const size_t maxSizeHint = 64 * 1024;
+  static thread_local size_t sizeHint = 0;
+  JSONCPP_STRING out;
+  out.reserve(sizeHint);
+  writeCompactValue(root, out);
+  sizeHint = out.size() < maxSizeHint ? out.size() : maxSizeHint;
+  return out;
+}
+
 // Class StyledWriter
 // //////////////////////////////////////////////////////////////////
 
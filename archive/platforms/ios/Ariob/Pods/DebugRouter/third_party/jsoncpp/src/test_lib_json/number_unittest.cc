@@ -0,0 +1,203 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+// Checks the shortest double formatting and the fast number parsing against
+// the snprintf("%.17g") / istringstream code they replaced.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+namespace {
+
+// The formatter before the shortest digits were introduced.
+std::string oldValueToString(double value, unsigned int precision = 17) {
+  char buffer[36];
+  snprintf(buffer, sizeof(buffer), "%.*g", static_cast<int>(precision), value);
+  if (!strstr(buffer, ".") && !strstr(buffer, "e")) {
+    strcat(buffer, ".0");
+  }
+  return buffer;
+}
+
+// The parser before the fast path was introduced.
+double oldDecodeDouble(const std::string& text) {
+  double value = 0;
+  std::istringstream is(text);
+  is >> value;
+  return value;
+}
+
+double readDouble(const std::string& text) {
+  Json::Value root;
+  EXPECT_TRUE(Json::Reader().parse("[" + text + "]", root, false)) << text;
+  return root[0].asDouble();
+}
+
+bool sameBits(double a, double b) { return memcmp(&a, &b, sizeof(a)) == 0; }
+
+// Counts the digits up to the last non-zero one, so "120.0" has 2.
+int significantDigits(const std::string& text) {
+  int digits = 0;
+  int counted = 0;
+  bool leading = true;
+  for (char c : text) {
+    if (c == 'e')
+      break;
+    if (c < '0' || c > '9')
+      continue;
+    if (leading && c == '0')
+      continue;
+    leading = false;
+    ++counted;
+    if (c != '0')
+      digits = counted;
+  }
+  return digits;
+}
+
+// Finite doubles spread over the whole exponent range, plus values that look
+// like what the protocol carries: small integers, timestamps, scale factors.
+std::vector<double> sampleDoubles() {
+  std::vector<double> values = {0.0,
+                                -0.0,
+                                0.1,
+                                0.2,
+                                0.3,
+                                1.0 / 3,
+                                2.0 / 3,
+                                1.5,
+                                -2.5,
+                                100.0,
+                                1e16,
+                                1e17,
+                                1e21,
+                                1e22,
+                                1e23,
+                                1e-4,
+                                1e-5,
+                                123456789012345680.0,
+                                5e-324,
+                                std::numeric_limits<double>::min(),
+                                std::numeric_limits<double>::max(),
+                                std::numeric_limits<double>::epsilon(),
+                                1747238400123.456};
+  std::mt19937_64 random(20250101);
+  while (values.size() < 200000) {
+    uint64_t bits = random();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value))
+      values.push_back(value);
+  }
+  for (int i = -100000; i <= 100000; i += 7) {
+    values.push_back(i / 100.0);
+    values.push_back(i * 1e-7);
+  }
+  return values;
+}
+
+} // namespace
+
+// Reading back what the writer produced must give the same double, through
+// both the old and the new parser.
+TEST(NumberTest, FormattedDoublesRoundTrip) {
+  for (double value : sampleDoubles()) {
+    std::string text = Json::valueToString(value);
+    ASSERT_TRUE(sameBits(readDouble(text), value)) << text;
+    ASSERT_TRUE(sameBits(oldDecodeDouble(text), value)) << text;
+  }
+}
+
+// Only the number of digits may differ: when all 17 are needed the output is
+// byte-identical, otherwise it is shorter, uses the same notation and reads
+// back to what the old output read back to.
+TEST(NumberTest, FormattedDoublesMatchOldLayout) {
+  for (double value : sampleDoubles()) {
+    std::string text = Json::valueToString(value);
+    std::string old = oldValueToString(value);
+    ASSERT_LE(text.size(), old.size()) << old;
+    int digits = significantDigits(text);
+    if (digits >= 17) {
+      ASSERT_EQ(text, old);
+    } else {
+      ASSERT_EQ(text.find('e') == std::string::npos,
+                old.find('e') == std::string::npos)
+          << text << " " << old;
+      ASSERT_TRUE(sameBits(oldDecodeDouble(old), oldDecodeDouble(text)))
+          << text << " " << old;
+    }
+  }
+}
+
+TEST(NumberTest, OtherPrecisionsAreUnchanged) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  std::mt19937_64 random(7);
+  for (unsigned int precision : {1u, 6u, 15u, 16u}) {
+    builder["precision"] = precision;
+    for (int i = 0; i < 1000; ++i) {
+      double value = std::ldexp(static_cast<double>(random() >> 11),
+                                static_cast<int>(random() % 200) - 100);
+      Json::Value root(Json::arrayValue);
+      root.append(value);
+      EXPECT_EQ(Json::writeString(builder, root),
+                "[" + oldValueToString(value, precision) + "]");
+    }
+  }
+}
+
+TEST(NumberTest, IntegersAndSpecialValuesAreUnchanged) {
+  EXPECT_EQ(Json::valueToString(Json::LargestInt(-9223372036854775807LL - 1)),
+            "-9223372036854775808");
+  EXPECT_EQ(Json::valueToString(Json::LargestUInt(18446744073709551615ULL)),
+            "18446744073709551615");
+  EXPECT_EQ(Json::valueToString(0.0), "0.0");
+  EXPECT_EQ(Json::valueToString(-0.0), "-0.0");
+  EXPECT_EQ(Json::valueToString(42.0), "42.0");
+  EXPECT_EQ(Json::valueToString(1e17), "1e+17");
+  EXPECT_EQ(Json::valueToString(std::numeric_limits<double>::infinity()),
+            "1e+9999");
+  EXPECT_EQ(Json::valueToString(std::nan("")), "null");
+}
+
+// Real numbers inside and around the fast path bounds parse to the same
+// double as with istringstream. Integers that fit 64 bits never reach
+// decodeDouble and are not affected.
+TEST(NumberTest, ParsesLikeOldDecoder) {
+  std::mt19937_64 random(99);
+  for (int i = 0; i < 200000; ++i) {
+    std::string text;
+    if (random() % 2)
+      text.push_back('-');
+    int digits = 1 + static_cast<int>(random() % 19);
+    for (int d = 0; d < digits; ++d)
+      text.push_back(static_cast<char>('0' + random() % 10));
+    bool hasExponent = random() % 2;
+    size_t point = text.size() - random() % digits;
+    if (point < text.size() || !hasExponent)
+      text.insert(point, point == text.size() ? ".0" : ".");
+    if (hasExponent) {
+      text += random() % 2 ? "e" : "E";
+      if (random() % 2)
+        text.push_back(random() % 2 ? '-' : '+');
+      text += std::to_string(random() % 30);
+    }
+    ASSERT_TRUE(sameBits(readDouble(text), oldDecodeDouble(text))) << text;
+  }
+  const char* large[] = {"18446744073709551616", "-9223372036854775809",
+                         "123456789012345678901234567890"};
+  for (const char* text : large) {
+    EXPECT_TRUE(sameBits(readDouble(text), oldDecodeDouble(text))) << text;
+  }
+}
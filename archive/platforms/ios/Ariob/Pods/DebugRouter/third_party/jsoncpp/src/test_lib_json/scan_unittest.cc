@@ -0,0 +1,185 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json/scan.h"
+
+namespace {
+
+// The loops the kernels replace.
+const char* scalarSkipWhitespace(const char* current, const char* end) {
+  while (current != end && Json::isJsonSpace(*current))
+    ++current;
+  return current;
+}
+
+const char* scalarFindQuoteOrEscape(const char* current, const char* end,
+                                    char quote) {
+  while (current != end && *current != quote && *current != '\\')
+    ++current;
+  return current;
+}
+
+// Long enough for three vectors and a tail, whatever the alignment.
+const size_t kMaxLength = 3 * 16 + 15;
+
+// Characters that end a run of blanks: json tokens, control characters,
+// DEL and bytes with the high bit set.
+const char kNotBlank[] = {'"', '\\', '{', 'a', '\x01', '\x0b',
+                          '\x1f', '\x7f', '\x80', '\xff'};
+
+// Characters a string may hold that are neither a quote nor a backslash.
+const char kStringFiller[] = {'a', ' ', '\'', '\x01', '\x1f', '\x7f',
+                              '\x80', '\xff'};
+
+// A buffer of exactly |text|, at |shift| bytes from an allocation, so that
+// reading past its end or relying on its alignment shows up under ASan.
+class Buffer {
+public:
+  Buffer(const std::string& text, size_t shift)
+      : storage_(shift + text.size()) {
+    std::copy(text.begin(), text.end(), storage_.begin() + shift);
+    begin_ = storage_.data() + shift;
+    end_ = begin_ + text.size();
+  }
+
+  const char* begin() const { return begin_; }
+  const char* end() const { return end_; }
+
+private:
+  std::vector<char> storage_;
+  const char* begin_;
+  const char* end_;
+};
+
+std::string blanks(size_t length) {
+  static const char kBlanks[] = {' ', '\t', '\r', '\n'};
+  std::string text;
+  for (size_t i = 0; i < length; ++i)
+    text += kBlanks[i % 4];
+  return text;
+}
+
+} // namespace
+
+TEST(ScanTest, SkipWhitespaceMatchesTheScalarLoop) {
+  for (size_t shift = 0; shift < 16; shift += 5) {
+    for (size_t length = 0; length <= kMaxLength; ++length) {
+      // every stop position, and none at all.
+      for (size_t stop = 0; stop <= length; ++stop) {
+        for (char ch : kNotBlank) {
+          std::string text = blanks(length);
+          if (stop < length) {
+            text[stop] = ch;
+            // what follows the stop must not matter.
+            for (size_t i = stop + 1; i < length; ++i)
+              text[i] = 'x';
+          }
+          Buffer buffer(text, shift);
+          ASSERT_EQ(Json::skipWhitespace(buffer.begin(), buffer.end()) -
+                        buffer.begin(),
+                    scalarSkipWhitespace(buffer.begin(), buffer.end()) -
+                        buffer.begin())
+              << "length " << length << " stop " << stop << " char "
+              << static_cast<int>(ch) << " shift " << shift;
+        }
+      }
+    }
+  }
+}
+
+TEST(ScanTest, FindQuoteOrEscapeMatchesTheScalarLoop) {
+  const char quotes[] = {'"', '\''};
+  for (size_t shift = 0; shift < 16; shift += 5) {
+    for (size_t length = 0; length <= kMaxLength; ++length) {
+      for (size_t stop = 0; stop <= length; ++stop) {
+        for (char quote : quotes) {
+          for (char filler : kStringFiller) {
+            if (filler == quote)
+              continue;
+            for (char ch : {quote, '\\'}) {
+              std::string text(length, filler);
+              if (stop < length)
+                text[stop] = ch;
+              Buffer buffer(text, shift);
+              ASSERT_EQ(Json::findQuoteOrEscape(buffer.begin(), buffer.end(),
+                                                quote) -
+                            buffer.begin(),
+                        scalarFindQuoteOrEscape(buffer.begin(), buffer.end(),
+                                                quote) -
+                            buffer.begin())
+                  << "length " << length << " stop " << stop << " quote "
+                  << quote << " filler " << static_cast<int>(filler)
+                  << " shift " << shift;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ScanTest, StopsAroundTheFirstVectorBoundary) {
+  const size_t offsets[] = {0, 15, 16, 17};
+  for (size_t offset : offsets) {
+    // 40 bytes, so the match is followed by more than a vector.
+    std::string text(40, 'a');
+    text[offset] = '"';
+    Buffer quoted(text, 0);
+    EXPECT_EQ(Json::findQuoteOrEscape(quoted.begin(), quoted.end(), '"'),
+              quoted.begin() + offset);
+    text[offset] = '\\';
+    Buffer escaped(text, 0);
+    EXPECT_EQ(Json::findQuoteOrEscape(escaped.begin(), escaped.end(), '"'),
+              escaped.begin() + offset);
+    // control characters are not the scanner's to report.
+    text[offset] = '\x01';
+    Buffer control(text, 0);
+    EXPECT_EQ(Json::findQuoteOrEscape(control.begin(), control.end(), '"'),
+              control.end());
+
+    std::string spaced = blanks(40);
+    spaced[offset] = '\x01';
+    Buffer blank(spaced, 0);
+    EXPECT_EQ(Json::skipWhitespace(blank.begin(), blank.end()),
+              blank.begin() + offset);
+  }
+}
+
+TEST(ScanTest, HandlesInputShorterThanAVector) {
+  for (size_t length = 0; length < 16; ++length) {
+    Buffer spaces(blanks(length), 0);
+    EXPECT_EQ(Json::skipWhitespace(spaces.begin(), spaces.end()),
+              spaces.end());
+    Buffer text(std::string(length, 'a'), 0);
+    EXPECT_EQ(Json::findQuoteOrEscape(text.begin(), text.end(), '"'),
+              text.end());
+  }
+  // an empty range is returned as is.
+  const char* empty = "";
+  EXPECT_EQ(Json::skipWhitespace(empty, empty), empty);
+  EXPECT_EQ(Json::findQuoteOrEscape(empty, empty, '"'), empty);
+}
+
+TEST(ScanTest, StopsAtTheEndOfABufferEndingMidVector) {
+  // a vector and a half of blanks, the half is read by the scalar tail.
+  Buffer spaces(blanks(24), 0);
+  EXPECT_EQ(Json::skipWhitespace(spaces.begin(), spaces.end()), spaces.end());
+  Buffer text(std::string(24, 'a'), 0);
+  EXPECT_EQ(Json::findQuoteOrEscape(text.begin(), text.end(), '"'),
+            text.end());
+
+  // the characters beyond |end| are never looked at.
+  std::string padded = blanks(24) + "x";
+  EXPECT_EQ(Json::skipWhitespace(padded.data(), padded.data() + 24),
+            padded.data() + 24);
+  padded = std::string(24, 'a') + "\"";
+  EXPECT_EQ(
+      Json::findQuoteOrEscape(padded.data(), padded.data() + 24, '"'),
+      padded.data() + 24);
+}
@@ -0,0 +1,244 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/value.h"
+
+namespace {
+
+// Writes every event on its own line.
+class EventLog : public Json::StreamHandler {
+public:
+  explicit EventLog(int stopAfter = -1) : stopAfter_(stopAfter) {}
+
+  bool onNull() JSONCPP_OVERRIDE { return add("null"); }
+  bool onBool(bool value) JSONCPP_OVERRIDE {
+    return add(value ? "true" : "false");
+  }
+  bool onInt(Json::LargestInt value) JSONCPP_OVERRIDE {
+    std::ostringstream oss;
+    oss << "int " << value;
+    return add(oss.str());
+  }
+  bool onUInt(Json::LargestUInt value) JSONCPP_OVERRIDE {
+    std::ostringstream oss;
+    oss << "uint " << value;
+    return add(oss.str());
+  }
+  bool onDouble(double value) JSONCPP_OVERRIDE {
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << "double " << value;
+    return add(oss.str());
+  }
+  bool onString(const char* begin, const char* end) JSONCPP_OVERRIDE {
+    return add("string " + std::string(begin, end));
+  }
+  bool onStartObject() JSONCPP_OVERRIDE { return add("{"); }
+  bool onKey(const char* begin, const char* end) JSONCPP_OVERRIDE {
+    return add("key " + std::string(begin, end));
+  }
+  bool onEndObject() JSONCPP_OVERRIDE { return add("}"); }
+  bool onStartArray() JSONCPP_OVERRIDE { return add("["); }
+  bool onEndArray() JSONCPP_OVERRIDE { return add("]"); }
+
+  std::string events;
+
+private:
+  bool add(const std::string& event) {
+    events += event;
+    events += '\n';
+    return stopAfter_ < 0 || --stopAfter_ > 0;
+  }
+
+  int stopAfter_;
+};
+
+// Feeds |document| in pieces of at most |chunk| bytes, then finishes it.
+Json::StreamReader::Status feedInChunks(Json::StreamReader& reader,
+                                        const std::string& document,
+                                        size_t chunk) {
+  Json::StreamReader::Status status = Json::StreamReader::needMoreInput;
+  for (size_t i = 0; i < document.size(); i += chunk) {
+    status = reader.feed(document.data() + i,
+                         std::min(chunk, document.size() - i));
+  }
+  return status == Json::StreamReader::needMoreInput ? reader.finish()
+                                                     : status;
+}
+
+std::string eventsOf(const std::string& document) {
+  EventLog log;
+  Json::StreamReader reader(log);
+  EXPECT_EQ(feedInChunks(reader, document, document.size() + 1),
+            Json::StreamReader::complete)
+      << document << "\n"
+      << reader.errorMessage();
+  return log.events;
+}
+
+} // namespace
+
+TEST(StreamReaderTest, ReportsEveryValue) {
+  EXPECT_EQ(eventsOf("{\"a\":[1,-2,3.5,\"s\",true,false,null],\"b\":{}}"),
+            "{\nkey a\n[\nint 1\nint -2\ndouble 3.5\nstring s\ntrue\n"
+            "false\nnull\n]\nkey b\n{\n}\n}\n");
+  EXPECT_EQ(eventsOf(" [ [ ] , { } ] "), "[\n[\n]\n{\n}\n]\n");
+}
+
+TEST(StreamReaderTest, ReadsScalarsAtTheRoot) {
+  EXPECT_EQ(eventsOf("\"root\""), "string root\n");
+  EXPECT_EQ(eventsOf("true"), "true\n");
+  EXPECT_EQ(eventsOf("null "), "null\n");
+  EXPECT_EQ(eventsOf("0"), "int 0\n");
+  EXPECT_EQ(eventsOf("-0.5e2"), "double -50\n");
+  EXPECT_EQ(eventsOf("9223372036854775807"), "int 9223372036854775807\n");
+  EXPECT_EQ(eventsOf("-9223372036854775808"), "int -9223372036854775808\n");
+  EXPECT_EQ(eventsOf("18446744073709551615"), "uint 18446744073709551615\n");
+  EXPECT_EQ(eventsOf("18446744073709551616"),
+            "double 1.8446744073709552e+19\n");
+}
+
+TEST(StreamReaderTest, RootNumberEndsOnlyWithTheInput) {
+  EventLog log;
+  Json::StreamReader reader(log);
+  EXPECT_EQ(reader.feed("12"), Json::StreamReader::needMoreInput);
+  EXPECT_EQ(reader.feed("34"), Json::StreamReader::needMoreInput);
+  EXPECT_EQ(log.events, "");
+  EXPECT_EQ(reader.finish(), Json::StreamReader::complete);
+  EXPECT_EQ(log.events, "int 1234\n");
+  EXPECT_EQ(reader.offset(), 4u);
+}
+
+TEST(StreamReaderTest, TokensSplitAtEveryOffsetGiveTheSameEvents) {
+  const char* const documents[] = {
+      "{\"key\":\"value\",\"n\":[12345,-0.25e-3,true,false,null]}",
+      "[\"esc\\\"ape\\\\\\/\\b\\f\\n\\r\\t\",\"\\u00e9\\u4e2d\"]",
+      "{\"emoji\":\"\\ud83d\\ude00\",\"pair\":\"a\\uD834\\uDD1Eb\"}",
+      "\"a string longer than one sixteen byte vector of the scanner\"",
+      "-1234567890.0987654321",
+  };
+  for (const char* document : documents) {
+    const std::string expected = eventsOf(document);
+    const std::string text(document);
+    for (size_t split = 1; split < text.size(); ++split) {
+      EventLog log;
+      Json::StreamReader reader(log);
+      reader.feed(text.data(), split);
+      reader.feed(text.data() + split, text.size() - split);
+      EXPECT_EQ(reader.finish(), Json::StreamReader::complete)
+          << text << " split at " << split << "\n"
+          << reader.errorMessage();
+      EXPECT_EQ(log.events, expected) << text << " split at " << split;
+    }
+    EventLog log;
+    Json::StreamReader reader(log);
+    EXPECT_EQ(feedInChunks(reader, text, 1), Json::StreamReader::complete);
+    EXPECT_EQ(log.events, expected) << text << " fed byte by byte";
+  }
+}
+
+TEST(StreamReaderTest, DecodesSurrogatePairsSplitMidEscape) {
+  // U+1F600, as UTF-8.
+  const std::string expected = "string \xF0\x9F\x98\x80\n";
+  const std::string text = "\"\\ud83d\\ude00\"";
+  EXPECT_EQ(eventsOf(text), expected);
+  // every split falls inside one of the two escapes, or between them.
+  for (size_t split = 1; split + 1 < text.size(); ++split) {
+    EventLog log;
+    Json::StreamReader reader(log);
+    EXPECT_EQ(reader.feed(text.substr(0, split)),
+              Json::StreamReader::needMoreInput);
+    EXPECT_EQ(reader.feed(text.substr(split)), Json::StreamReader::complete)
+        << "split at " << split << "\n"
+        << reader.errorMessage();
+    EXPECT_EQ(log.events, expected) << "split at " << split;
+  }
+}
+
+TEST(StreamReaderTest, EnforcesTheStackLimit) {
+  EventLog log;
+  Json::StreamReader reader(log);
+  reader.setStackLimit(3);
+  EXPECT_EQ(reader.feed("[[[1]]]"), Json::StreamReader::complete);
+
+  reader.reset();
+  EXPECT_EQ(reader.feed("[{\"a\":[["), Json::StreamReader::failed);
+  EXPECT_NE(reader.errorMessage().find("Offset 7"), std::string::npos)
+      << reader.errorMessage();
+  EXPECT_NE(reader.errorMessage().find("stackLimit"), std::string::npos);
+
+  // the default limit also applies.
+  Json::StreamReader unlimited(log);
+  EXPECT_EQ(unlimited.feed(std::string(1000, '[')),
+            Json::StreamReader::needMoreInput);
+  EXPECT_EQ(unlimited.feed("["), Json::StreamReader::failed);
+}
+
+TEST(StreamReaderTest, RejectsMalformedInput) {
+  const char* const documents[] = {
+      "",
+      "{",
+      "{\"a\"}",
+      "{\"a\":}",
+      "{\"a\":1,}",
+      "{a:1}",
+      "[1,]",
+      "[1 2]",
+      "[1}",
+      "{\"a\":1]",
+      "tru",
+      "trux",
+      "nul1",
+      "01",
+      "1.",
+      "1e",
+      "-",
+      "+1",
+      ".5",
+      "\"unterminated",
+      "\"bad \\x escape\"",
+      "\"\\u12G4\"",
+      "\"\\ud83d\"",
+      "\"\\ud83d\\n\"",
+      "\"\\ud83d\\u0041\"",
+      "[] []",
+      "{} x",
+      "/* comment */ 1",
+  };
+  for (const char* document : documents) {
+    EventLog log;
+    Json::StreamReader reader(log);
+    EXPECT_EQ(feedInChunks(reader, document, 1), Json::StreamReader::failed)
+        << document;
+    EXPECT_FALSE(reader.errorMessage().empty()) << document;
+    // no more events once failed.
+    const std::string events = log.events;
+    EXPECT_EQ(reader.feed("[1]"), Json::StreamReader::failed);
+    EXPECT_EQ(log.events, events);
+  }
+}
+
+TEST(StreamReaderTest, StopsWhenTheHandlerDeclines) {
+  EventLog log(2);
+  Json::StreamReader reader(log);
+  EXPECT_EQ(reader.feed("{\"a\":1,\"b\":2}"), Json::StreamReader::stopped);
+  EXPECT_EQ(log.events, "{\nkey a\n");
+  EXPECT_EQ(reader.feed("]"), Json::StreamReader::stopped);
+  EXPECT_EQ(reader.finish(), Json::StreamReader::stopped);
+}
+
+TEST(StreamReaderTest, AcceptsOnlyBlanksAfterTheRoot) {
+  EventLog log;
+  Json::StreamReader reader(log);
+  EXPECT_EQ(reader.feed("{}"), Json::StreamReader::complete);
+  EXPECT_EQ(reader.feed(" \r\n\t "), Json::StreamReader::complete);
+  EXPECT_EQ(reader.finish(), Json::StreamReader::complete);
+  EXPECT_EQ(reader.feed("1"), Json::StreamReader::failed);
+}
@@ -0,0 +1,66 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "json/reader.h"
+#include "json/value.h"
+
+namespace {
+
+// A CDP envelope as it arrives from the debugging client. The uncommon
+// variant has member names of the same lengths that are never interned.
+const char kEnvelope[] =
+    "{\"event\":\"Customized\",\"data\":{\"type\":\"CDP\",\"data\":{"
+    "\"client_id\":7,\"session_id\":3,\"message\":{\"id\":12,"
+    "\"method\":\"DOM.getDocument\",\"params\":{\"depth\":-1}}}}}";
+const char kUncommonEnvelope[] =
+    "{\"Event\":\"Customized\",\"Data\":{\"Type\":\"CDP\",\"Data\":{"
+    "\"Client_id\":7,\"Session_id\":3,\"Message\":{\"Id\":12,"
+    "\"Method\":\"DOM.getDocument\",\"Params\":{\"depth\":-1}}}}}";
+
+void internProtocolKeys() {
+  static const char* const kKeys[] = {"event",      "data",    "type",
+                                      "client_id",  "session_id",
+                                      "message",    "id",      "method",
+                                      "params"};
+  for (const char* key : kKeys) {
+    Json::Value::internKey(Json::StaticString(key));
+  }
+}
+
+void parse(benchmark::State& state, const std::string& source) {
+  internProtocolKeys();
+  Json::Reader reader;
+  for (auto _ : state) {
+    Json::Value root;
+    reader.parse(source, root, false);
+    benchmark::DoNotOptimize(root);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(source.size()));
+}
+
+void BM_ParseInternedKeys(benchmark::State& state) { parse(state, kEnvelope); }
+BENCHMARK(BM_ParseInternedKeys);
+
+void BM_ParseUncommonKeys(benchmark::State& state) {
+  parse(state, kUncommonEnvelope);
+}
+BENCHMARK(BM_ParseUncommonKeys);
+
+void BM_CopyParsedEnvelope(benchmark::State& state) {
+  internProtocolKeys();
+  Json::Value root;
+  Json::Reader().parse(state.range(0) ? kEnvelope : kUncommonEnvelope, root,
+                       false);
+  for (auto _ : state) {
+    Json::Value copy = root;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+BENCHMARK(BM_CopyParsedEnvelope)->Arg(1)->Arg(0);
+
+} // namespace
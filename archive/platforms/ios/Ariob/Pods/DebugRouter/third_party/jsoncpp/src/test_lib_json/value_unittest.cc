@@ -0,0 +1,188 @@
+// Copyright 2025 The Lynx Authors. All rights reserved.
+// Licensed under the Apache License Version 2.0 that can be found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/value.h"
+
+namespace {
+
+const char* firstMemberName(const Json::Value& value) {
+  const char* end;
+  return value.begin().memberName(&end);
+}
+
+} // namespace
+
+TEST(ValueTest, InternedKeysPointAtTheRegisteredName) {
+  static const char kName[] = "internedByValueTest";
+  ASSERT_TRUE(Json::Value::internKey(Json::StaticString(kName)));
+
+  Json::Value built(Json::objectValue);
+  built[std::string("internedByValueTest")] = 1;
+  EXPECT_EQ(firstMemberName(built), kName);
+
+  Json::Value parsed;
+  ASSERT_TRUE(Json::Reader().parse("{\"internedByValueTest\":1}", parsed));
+  EXPECT_EQ(firstMemberName(parsed), kName);
+
+  Json::Value copy = parsed;
+  EXPECT_EQ(firstMemberName(copy), kName);
+  EXPECT_EQ(copy, built);
+
+  Json::Value other(Json::objectValue);
+  other["notInternedByValueTest"] = 1;
+  EXPECT_STREQ(firstMemberName(other), "notInternedByValueTest");
+}
+
+TEST(ValueTest, ParsesWhileKeysAreInterned) {
+  std::vector<std::thread> parsers;
+  for (int i = 0; i < 4; ++i) {
+    parsers.emplace_back([]() {
+      for (int round = 0; round < 2000; ++round) {
+        Json::Value value;
+        ASSERT_TRUE(Json::Reader().parse(
+            "{\"concurrent\":1,\"method\":\"Page.enable\"}", value));
+        ASSERT_EQ(value["concurrent"].asInt(), 1);
+      }
+    });
+  }
+  static const char kName[] = "concurrent";
+  Json::Value::internKey(Json::StaticString(kName));
+  for (std::thread& parser : parsers)
+    parser.join();
+}
+
+TEST(ValueTest, CopiesShareTheBufferOfASharedString) {
+  const std::string text(100, 's');
+  Json::SharedString shared(text);
+  Json::Value value(shared);
+  EXPECT_EQ(value.asCString(), shared.data());
+  EXPECT_EQ(value.asString(), text);
+
+  Json::Value copy = value;
+  EXPECT_EQ(copy.asCString(), shared.data());
+  Json::Value object(Json::objectValue);
+  object["data"] = value;
+  Json::Value objectCopy = object;
+  EXPECT_EQ(objectCopy["data"].asCString(), shared.data());
+  EXPECT_EQ(copy.asSharedString().data(), shared.data());
+
+  // the buffer lives as long as any of them.
+  const char* data = shared.data();
+  shared = Json::SharedString();
+  value = Json::Value();
+  object.clear();
+  EXPECT_EQ(copy.asCString(), data);
+  EXPECT_EQ(objectCopy["data"].asString(), text);
+}
+
+TEST(ValueTest, ChangingACopyLeavesTheSharedStringAlone) {
+  std::string text(100, 'a');
+  Json::SharedString shared(text);
+  // copied from the source once.
+  text.assign(100, 'b');
+  EXPECT_EQ(std::string(shared.data(), shared.length()),
+            std::string(100, 'a'));
+
+  Json::Value value(shared);
+  Json::Value copy = value;
+  copy = "replaced";
+  EXPECT_EQ(value.asString(), std::string(100, 'a'));
+  EXPECT_EQ(copy.asString(), "replaced");
+
+  Json::SharedString sharedCopy = shared;
+  sharedCopy = Json::SharedString("other", 5);
+  EXPECT_EQ(std::string(shared.data(), shared.length()),
+            std::string(100, 'a'));
+  EXPECT_EQ(std::string(sharedCopy.data(), sharedCopy.length()), "other");
+
+  Json::Value swapped("swapped");
+  swapped.swap(value);
+  EXPECT_EQ(swapped.asCString(), shared.data());
+  EXPECT_EQ(value.asString(), "swapped");
+
+  EXPECT_TRUE(Json::SharedString().empty());
+  EXPECT_EQ(Json::Value(Json::SharedString()).asString(), "");
+}
+
+TEST(ValueTest, SharesLongStringsFromTheThresholdOn) {
+  const std::string shorter(JSON_SHARED_STRING_MIN_LENGTH - 1, 'x');
+  Json::Value small(shorter);
+  Json::Value smallCopy = small;
+  EXPECT_NE(smallCopy.asCString(), small.asCString());
+  EXPECT_EQ(smallCopy.asString(), shorter);
+  // taking a SharedString of it copies the string once more.
+  EXPECT_NE(small.asSharedString().data(), small.asCString());
+
+  const std::string atThreshold(JSON_SHARED_STRING_MIN_LENGTH, 'x');
+  Json::Value large(atThreshold);
+  Json::Value largeCopy = large;
+  EXPECT_EQ(largeCopy.asCString(), large.asCString());
+  EXPECT_EQ(large.asSharedString().data(), large.asCString());
+
+  // parsed strings go through the same constructors.
+  Json::Value parsed;
+  ASSERT_TRUE(
+      Json::Reader().parse("[\"" + atThreshold + "\"]", parsed, false));
+  Json::Value parsedCopy = parsed;
+  EXPECT_EQ(parsedCopy[0].asCString(), parsed[0].asCString());
+}
+
+TEST(ValueTest, CopiesASharedStringAcrossThreads) {
+  const std::string text(JSON_SHARED_STRING_MIN_LENGTH * 4, 't');
+  Json::Value value = Json::Value(Json::SharedString(text));
+  const char* data = value.asCString();
+  std::vector<std::thread> copiers;
+  for (int i = 0; i < 4; ++i) {
+    copiers.emplace_back([&value, &text, data]() {
+      std::vector<Json::Value> copies;
+      for (int round = 0; round < 1000; ++round) {
+        copies.push_back(value);
+        Json::SharedString shared = copies.back().asSharedString();
+        if (round % 3 == 0)
+          copies.erase(copies.begin());
+        ASSERT_EQ(shared.data(), data);
+      }
+      for (const Json::Value& copy : copies)
+        ASSERT_EQ(copy.asString(), text);
+    });
+  }
+  for (std::thread& copier : copiers)
+    copier.join();
+
+  // the last reference is released by another thread.
+  Json::Value last = value;
+  value = Json::Value();
+  std::thread([&last]() { last = Json::Value(); }).join();
+  EXPECT_TRUE(last.isNull());
+}
+
+TEST(ValueTest, InternKeyIsIdempotentAndBounded) {
+  static const char kName[] = "registeredTwice";
+  EXPECT_TRUE(Json::Value::internKey(Json::StaticString(kName)));
+  EXPECT_TRUE(Json::Value::internKey(Json::StaticString(kName)));
+
+  // Fills the table, keep this test last. Names stay registered for the
+  // whole program, so they are leaked on purpose.
+  int registered = 0;
+  while (registered < 1000) {
+    std::string* name = new std::string("filler" + std::to_string(registered));
+    if (!Json::Value::internKey(Json::StaticString(name->c_str())))
+      break;
+    ++registered;
+  }
+  EXPECT_LT(registered, 192);
+
+  // Lookups keep working once the table is full.
+  Json::Value value(Json::objectValue);
+  value["registeredTwice"] = true;
+  EXPECT_EQ(firstMemberName(value), kName);
+  value["notRegisteredAnywhere"] = true;
+  EXPECT_TRUE(value["notRegisteredAnywhere"].asBool());
+}
@@ -0,0 +1 @@
+../../../../../../DebugRouter/debug_router/native/base/base64.h
\ No newline at end of file